@@ -0,0 +1,117 @@
+// Headless enemy update cost: the original array-of-structs loop vs. the
+// structure-of-arrays pool, at 10 / 1k / 100k live enemies
+//
+// Usage: enemy_bench [ticks]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/enemies.h"
+
+#define DEFAULT_TICKS 2000
+#define TICK_DT (1.0f / 60.0f)
+#define KILL_LINE 1e9f          // nobody reaches it; we only time the pass
+#define SHOW_MEANING_DURATION 2000
+
+// The original Enemy and update_enemies, minus SDL
+typedef struct {
+    float x, y;
+    int card_index;
+    int alive;
+    int showing_meaning;
+    uint32_t death_time;
+} LegacyEnemy;
+
+static int update_legacy(LegacyEnemy *enemies, int count, float dt, uint32_t now) {
+    int game_over = 0;
+    for (int i = 0; i < count; i++) {
+        LegacyEnemy *enemy = &enemies[i];
+        if (enemy->showing_meaning) {
+            if (now - enemy->death_time > SHOW_MEANING_DURATION) enemy->showing_meaning = 0;
+        } else if (enemy->alive) {
+            enemy->y += 30.0f * dt;
+            if (enemy->y > KILL_LINE) game_over = 1;
+        }
+    }
+    return game_over;
+}
+
+static int spawn_legacy(LegacyEnemy *enemies, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!enemies[i].alive && !enemies[i].showing_meaning) {
+            enemies[i].alive = 1;
+            enemies[i].y = -50;
+            return i;
+        }
+    }
+    return -1;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int ticks = argc > 1 ? atoi(argv[1]) : DEFAULT_TICKS;
+    const int counts[] = {10, 1000, 100000};
+    volatile int sink = 0;      // keeps the timed work observable
+
+    if (ticks <= 0) ticks = DEFAULT_TICKS;
+
+    printf("%-8s %14s %14s %9s %16s %16s\n", "enemies", "aos ns/tick", "soa ns/tick",
+           "speedup", "aos ns/respawn", "soa ns/respawn");
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int count = counts[c];
+        LegacyEnemy *legacy = calloc(count, sizeof(LegacyEnemy));
+        EnemyPool *pool = enemy_pool_create(count);
+        if (!legacy || !pool) return 1;
+
+        // Full house, with every tenth legacy slot showing its meaning
+        for (int i = 0; i < count; i++) {
+            legacy[i].alive = i % 10 != 0;
+            legacy[i].showing_meaning = i % 10 == 0;
+            legacy[i].y = -50;
+            enemy_pool_spawn(pool, i, 0, -50, 30.0f);
+        }
+
+        double start = now_ms();
+        for (int t = 0; t < ticks; t++) sink += update_legacy(legacy, count, TICK_DT, t);
+        double aos_ms = now_ms() - start;
+
+        start = now_ms();
+        for (int t = 0; t < ticks; t++) sink += enemy_pool_update(pool, TICK_DT, KILL_LINE);
+        double soa_ms = now_ms() - start;
+
+        // Kill one enemy near the end of the array and spawn a replacement
+        int respawns = count < 1000 ? 100000 : 1000;
+        start = now_ms();
+        for (int r = 0; r < respawns; r++) {
+            int victim = count - 1 - r % (count < 10 ? count : 10);
+            legacy[victim].alive = 0;
+            legacy[victim].showing_meaning = 0;
+            sink += spawn_legacy(legacy, count);
+        }
+        double aos_spawn_ms = now_ms() - start;
+
+        start = now_ms();
+        for (int r = 0; r < respawns; r++) {
+            enemy_pool_despawn(pool, pool->id[pool->count - 1]);
+            sink += enemy_pool_spawn(pool, r, 0, -50, 30.0f);
+        }
+        double soa_spawn_ms = now_ms() - start;
+
+        printf("%-8d %14.0f %14.0f %8.1fx %16.1f %16.1f\n", count,
+               aos_ms * 1e6 / ticks, soa_ms * 1e6 / ticks, aos_ms / soa_ms,
+               aos_spawn_ms * 1e6 / respawns, soa_spawn_ms * 1e6 / respawns);
+
+        enemy_pool_destroy(pool);
+        free(legacy);
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Per-keystroke prefix matching: strncmp against every enemy vs. walking the
+// reading trie, with a cross-check of the highlighted sets
+//
+// Usage: prefix_bench [keystrokes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/reading_trie.h"
+
+#define DEFAULT_KEYSTROKES 100000
+#define READING_POOL 4096
+#define READING_CHARS 4
+#define KANA_RANGE 16           // small alphabet so prefixes are widely shared
+
+static char readings[READING_POOL][READING_CHARS * 3 + 1];
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void make_readings(void) {
+    for (int i = 0; i < READING_POOL; i++) {
+        char *out = readings[i];
+        int chars = 1 + rand() % READING_CHARS;
+        for (int c = 0; c < chars; c++) {
+            int cp = 0x3042 + rand() % KANA_RANGE;
+            *out++ = 0xE0 | (cp >> 12);
+            *out++ = 0x80 | ((cp >> 6) & 0x3F);
+            *out++ = 0x80 | (cp & 0x3F);
+        }
+        *out = '\0';
+    }
+}
+
+// Typing a reading one kana at a time; each prefix is one keystroke's input
+static int next_prefix(const char **target, int *typed) {
+    if (!*target || (*target)[*typed] == '\0') {
+        *target = readings[rand() % READING_POOL];
+        *typed = 0;
+    }
+    *typed += 3;
+    return *typed;
+}
+
+static int count_linear(const char **enemy_readings, int count, const char *input, int len) {
+    int matched = 0;
+    for (int i = 0; i < count; i++) {
+        if (strncmp(enemy_readings[i], input, len) == 0) matched++;
+    }
+    return matched;
+}
+
+int main(int argc, char *argv[]) {
+    int keystrokes = argc > 1 ? atoi(argv[1]) : DEFAULT_KEYSTROKES;
+    const int enemy_counts[] = {10, 1000, 2000, 5000, 10000};
+
+    if (keystrokes <= 0) keystrokes = DEFAULT_KEYSTROKES;
+    srand(1234);
+    make_readings();
+
+    printf("%-8s %12s %14s %14s %9s\n",
+           "enemies", "avg matched", "linear ns/key", "trie ns/key", "speedup");
+
+    for (size_t e = 0; e < sizeof(enemy_counts) / sizeof(enemy_counts[0]); e++) {
+        int count = enemy_counts[e];
+        const char **enemy_readings = malloc(count * sizeof(const char *));
+        ReadingTrie *trie = reading_trie_create(count);
+        if (!enemy_readings || !trie) return 1;
+
+        for (int i = 0; i < count; i++) {
+            enemy_readings[i] = readings[rand() % READING_POOL];
+            reading_trie_insert(trie, i, enemy_readings[i]);
+        }
+
+        // Cross-check, with enemies dying and respawning in between
+        const char *target = NULL;
+        int typed = 0;
+        for (int k = 0; k < 2000; k++) {
+            int len = next_prefix(&target, &typed);
+            int node = reading_trie_walk(trie, target, len);
+            int matched = 0;
+            for (int i = 0; i < count; i++) {
+                int expected = strncmp(enemy_readings[i], target, len) == 0;
+                if (reading_trie_has_prefix(trie, i, node) != expected) {
+                    fprintf(stderr, "enemy %d disagrees on prefix of length %d\n", i, len);
+                    return 1;
+                }
+                matched += expected;
+            }
+            if ((node < 0 ? 0 : trie->nodes[node].count) != matched) {
+                fprintf(stderr, "trie count %d, expected %d\n", trie->nodes[node].count, matched);
+                return 1;
+            }
+
+            int victim = rand() % count;
+            enemy_readings[victim] = readings[rand() % READING_POOL];
+            reading_trie_insert(trie, victim, enemy_readings[victim]);
+        }
+
+        // Same keystroke sequence for both
+        long linear_total = 0, trie_total = 0;
+        target = NULL;
+        typed = 0;
+        srand(42);
+        double start = now_ms();
+        for (int k = 0; k < keystrokes; k++) {
+            int len = next_prefix(&target, &typed);
+            linear_total += count_linear(enemy_readings, count, target, len);
+        }
+        double linear_ms = now_ms() - start;
+
+        target = NULL;
+        typed = 0;
+        srand(42);
+        start = now_ms();
+        for (int k = 0; k < keystrokes; k++) {
+            int len = next_prefix(&target, &typed);
+            int node = reading_trie_walk(trie, target, len);
+            trie_total += node < 0 ? 0 : trie->nodes[node].count;
+        }
+        double trie_ms = now_ms() - start;
+
+        if (linear_total != trie_total) {
+            fprintf(stderr, "match totals differ: %ld vs %ld\n", linear_total, trie_total);
+            return 1;
+        }
+        printf("%-8d %12.1f %14.1f %14.1f %8.1fx\n", count, (double)trie_total / keystrokes,
+               linear_ms * 1e6 / keystrokes, trie_ms * 1e6 / keystrokes, linear_ms / trie_ms);
+
+        reading_trie_destroy(trie);
+        free(enemy_readings);
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Submission cost with many live enemies: strcmp over every slot vs. the
+// hashed reading index
+//
+// Usage: reading_bench [submissions]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../collectionlib/include/reading.h"
+#include "../src/reading_index.h"
+
+#define DEFAULT_SUBMISSIONS 200000
+#define READING_POOL 4096       // distinct readings; enemies share them
+#define READING_CHARS 4
+
+typedef struct {
+    const char *reading;
+    int alive;
+} BenchEnemy;
+
+static char readings[READING_POOL][READING_CHARS * 3 + 1];
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Random strings of hiragana from あ (U+3042) to ん (U+3093)
+static void make_readings(void) {
+    for (int i = 0; i < READING_POOL; i++) {
+        char *out = readings[i];
+        int chars = 1 + rand() % READING_CHARS;
+        for (int c = 0; c < chars; c++) {
+            int cp = 0x3042 + rand() % (0x3093 - 0x3042 + 1);
+            *out++ = 0xE0 | (cp >> 12);
+            *out++ = 0x80 | ((cp >> 6) & 0x3F);
+            *out++ = 0x80 | (cp & 0x3F);
+        }
+        *out = '\0';
+    }
+}
+
+// What check_input used to do
+static int find_linear(const BenchEnemy *enemies, int count, const char *input) {
+    for (int i = 0; i < count; i++) {
+        if (enemies[i].alive && strcmp(input, enemies[i].reading) == 0) return i;
+    }
+    return -1;
+}
+
+// Inputs come from the same pool, so more enemies means more hits
+static void make_inputs(const char **inputs, int submissions) {
+    for (int n = 0; n < submissions; n++) {
+        inputs[n] = readings[rand() % READING_POOL];
+    }
+}
+
+// Cards come with their readings' length and hash from the collection
+static void index_reading(ReadingIndex *index, int id, const char *reading) {
+    size_t length = strlen(reading);
+    reading_index_insert(index, id, reading, length, reading_text_hash(reading, length));
+}
+
+static double run(int enemy_count, const char **inputs, int submissions, int indexed,
+                  long *hits) {
+    BenchEnemy *enemies = calloc(enemy_count, sizeof(BenchEnemy));
+    ReadingIndex *index = indexed ? reading_index_create(enemy_count) : NULL;
+
+    srand(99);
+    for (int i = 0; i < enemy_count; i++) {
+        enemies[i].reading = readings[rand() % READING_POOL];
+        enemies[i].alive = 1;
+        if (index) index_reading(index, i, enemies[i].reading);
+    }
+
+    *hits = 0;
+    double start = now_ms();
+    for (int n = 0; n < submissions; n++) {
+        // The input is hashed once per submission, as check_input does
+        int i = index ? reading_index_find(index, inputs[n], strlen(inputs[n]),
+                                           reading_text_hash(inputs[n], strlen(inputs[n])))
+                      : find_linear(enemies, enemy_count, inputs[n]);
+        if (i < 0) continue;
+
+        // Kill and respawn in the same slot; both strategies keep the same
+        // multiset of live readings, so their hit counts must agree
+        (*hits)++;
+        enemies[i].reading = readings[rand() % READING_POOL];
+        if (index) index_reading(index, i, enemies[i].reading);
+    }
+    double elapsed = now_ms() - start;
+
+    reading_index_destroy(index);
+    free(enemies);
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    int submissions = argc > 1 ? atoi(argv[1]) : DEFAULT_SUBMISSIONS;
+    const int enemy_counts[] = {10, 1000, 2000, 5000, 10000};
+
+    if (submissions <= 0) submissions = DEFAULT_SUBMISSIONS;
+    const char **inputs = malloc(submissions * sizeof(const char *));
+    if (!inputs) return 1;
+
+    srand(1234);
+    make_readings();
+    make_inputs(inputs, submissions);
+
+    printf("%-8s %8s %14s %14s %9s\n", "enemies", "hits", "linear ns/sub", "index ns/sub", "speedup");
+    for (size_t i = 0; i < sizeof(enemy_counts) / sizeof(enemy_counts[0]); i++) {
+        long linear_hits, index_hits;
+        double linear = run(enemy_counts[i], inputs, submissions, 0, &linear_hits);
+        double indexed = run(enemy_counts[i], inputs, submissions, 1, &index_hits);
+
+        if (linear_hits != index_hits) {
+            fprintf(stderr, "hit counts differ: %ld vs %ld\n", linear_hits, index_hits);
+            return 1;
+        }
+        printf("%-8d %8ld %14.1f %14.1f %8.1fx\n", enemy_counts[i], index_hits,
+               linear * 1e6 / submissions, indexed * 1e6 / submissions, linear / indexed);
+    }
+
+    free(inputs);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Headless replay: plays a session recorded with `game --record FILE` through
+// the simulation core at full speed, no SDL, fonts or display needed
+//
+// Usage: replay_bench <file.replay> [runs] [trace.json]
+// Loads the collection and deck named in the recording, checks that the
+// replay ends on the recorded score, and reports ticks/sec and p50/p99 tick
+// latency over the given number of runs. In a PROFILE=1 build the timers of
+// the load and the last run can be exported as a Chrome trace.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "../src/replay.h"
+#include "../collectionlib/include/log.h"
+#include "../collectionlib/include/trace.h"
+
+#define DECK_CACHE_DIR "cache"  // same cache the game reads
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// One full playback; returns the final score or -1 on setup failure
+static int play(Replay *replay, CardCollection *collection, double *latency, uint64_t *ticks) {
+    GameSim *sim = sim_create(&replay->config, collection);
+    if (!sim) return -1;
+
+    replay->next_event = 0;
+    for (;;) {
+        double tick_start = now_ns();
+        replay_feed(replay, sim);
+        if (sim->tick >= replay->end_tick) break;
+        sim_step(sim);
+        latency[sim->tick - 1] = now_ns() - tick_start;
+
+        // Steps after game over do not advance the tick
+        if (sim->game_over) break;
+    }
+
+    *ticks = sim->tick;
+    int score = sim->score;
+    sim_destroy(sim);
+    return score;
+}
+
+int main(int argc, char *argv[]) {
+    Replay replay;
+    CollectionOptions options;
+
+    if (argc < 2) {
+        printf("Usage: %s <file.replay> [runs] [trace.json]\n", argv[0]);
+        return 1;
+    }
+    int runs = argc > 2 ? atoi(argv[2]) : 5;
+    if (runs <= 0) runs = 1;
+    const char *trace_path = argc > 3 ? argv[3] : NULL;
+
+    if (replay_load(argv[1], &replay) < 0) return 1;
+
+    collection_set_log_level(COLLECTION_LOG_ERROR);
+    collection_default_options(&options);
+    mkdir(DECK_CACHE_DIR, 0755);
+    options.cache_dir = DECK_CACHE_DIR;
+    options.include_subdecks = 1;
+    options.load_schedule = 1;
+
+    CardCollection *collection = setup_collection_with_options(replay.db_path, replay.deck_name,
+                                                               &options);
+    if (!collection) {
+        replay_free(&replay);
+        return 1;
+    }
+    if (collection->count != replay.card_count) {
+        printf("Replay was recorded with %d cards, deck has %d\n",
+               replay.card_count, collection->count);
+        delete_collection(collection);
+        replay_free(&replay);
+        return 1;
+    }
+
+    printf("%s: %s / %s, seed %llu, %d keys over %llu ticks at %d Hz\n", argv[1],
+           replay.db_path, replay.deck_name, (unsigned long long)replay.config.seed,
+           replay.event_count, (unsigned long long)replay.end_tick, replay.config.tick_rate);
+
+    double *latency = malloc((replay.end_tick + 1) * sizeof(double));
+    if (!latency) return 1;
+
+    int failed = 0;
+    printf("%4s %10s %12s %9s %9s %8s\n", "run", "ticks", "ticks/sec", "p50 ns", "p99 ns", "score");
+    for (int run = 0; run < runs; run++) {
+        uint64_t ticks = 0;
+        double start = now_ns();
+        int score = play(&replay, collection, latency, &ticks);
+        double elapsed = now_ns() - start;
+
+        if (score < 0) {
+            failed = 1;
+            break;
+        }
+        if (ticks == 0) latency[ticks++] = 0;
+        qsort(latency, ticks, sizeof(double), compare_double);
+        printf("%4d %10llu %12.0f %9.0f %9.0f %8d%s\n", run + 1, (unsigned long long)ticks,
+               ticks / (elapsed / 1e9), latency[ticks / 2], latency[ticks * 99 / 100], score,
+               score == replay.final_score && ticks == replay.end_tick ? "" : " (DIVERGED)");
+        if (score != replay.final_score || ticks != replay.end_tick) failed = 1;
+    }
+
+    if (trace_path) trace_export_chrome(trace_path);
+
+    free(latency);
+    delete_collection(collection);
+    replay_free(&replay);
+    return failed;
+}
@@ -0,0 +1,415 @@
+// Romaji conversion: an exhaustive check of the generated tables, known
+// words in both scripts, a fuzz of incremental edits against whole-string
+// conversion, then keystroke throughput of the incremental DFA against the
+// hiragana-only converter it replaced
+//
+// Usage: romaji_bench [fuzz_cases]
+// Exits non-zero if any conversion is wrong, or if either script converts
+// slower per keystroke than the previous converter.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../collectionlib/include/reading.h"
+#include "../src/hiragana.h"
+#include "../src/romaji_table.h"
+
+#define DEFAULT_CASES 100000
+#define DFA_CHARS 20000000
+#define LINE_LENGTH 40
+#define RATE_RUNS 5             // best of, alternating converters
+#define BASELINE_STATES 256
+
+// Letters from the table plus a few that never match
+static const char fuzz_alphabet[] = "aiueokstnhmyrwgzdbpjcfxqlv-'";
+#define FUZZ_LETTERS (int)(sizeof(fuzz_alphabet) - 1)
+
+static const char *sample_text =
+    "kyoushitsudebenkyoushitasenseinihanashiwokikimashitagakkoudetomodachito"
+    "asobimashitadenshanimattesshashinwotorimashitanihongonojishowokaimashita";
+
+typedef struct {
+    const char *romaji;
+    const char *hiragana;
+    const char *katakana;
+} KnownWord;
+
+// What an IME makes of these; katakana NULL where the word is never written so
+static const KnownWord known_words[] = {
+    {"konnnichiha", "こんにちは", NULL},
+    {"konnichiha", "こんいちは", NULL},   // "nn" is ん, as in every IME
+    {"kon'nichiha", "こんにちは", NULL},
+    {"kakko", "かっこ", NULL},
+    {"kannna", "かんな", NULL},
+    {"nihon", "にほん", NULL},
+    {"shinbun", "しんぶん", NULL},
+    {"kin'en", "きんえん", NULL},
+    {"konnya", "こんや", NULL},
+    {"tte", "って", NULL},
+    {"matcha", "まっちゃ", NULL},
+    {"maccha", "まっちゃ", NULL},
+    {"zasshi", "ざっし", NULL},
+    {"ninja", "にんじゃ", NULL},
+    {"sanpo", "さんぽ", NULL},
+    {"tenki", "てんき", NULL},
+    {"onnna", "おんな", NULL},
+    {"n", "ん", "ン"},
+    {"nyz", "んyz", "ンyz"},
+    {"ko-hi-", "こーひー", "コーヒー"},
+    {"konpyu-ta-", "こんぴゅーたー", "コンピューター"},
+    {"vaiorin", "ゔぁいおりん", "ヴァイオリン"},
+    {"fairu", "ふぁいる", "ファイル"},
+    {"thi-shatsu", "てぃーしゃつ", "ティーシャツ"},
+    {"dhu-ku", "でゅーく", "デューク"},
+    {"wi-ku", "うぃーく", "ウィーク"},
+    {"xtukeltsu", "っけっ", "ッケッ"},
+    {"xka", "ゕ", "ヵ"},
+    {NULL, NULL, NULL}
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Katakana output must fold back to the hiragana and keep no hiragana of
+// its own (E3 81 xx, or E3 82 80-96)
+static int check_katakana(const char *romaji, const char *hiragana, const char *katakana) {
+    char folded[ROMAJI_TEXT_SIZE];
+    size_t len = strlen(katakana);
+    const unsigned char *p = (const unsigned char *)katakana;
+
+    for (size_t i = 0; i + 2 < len; i++) {
+        if (p[i] == 0xE3 && (p[i + 1] == 0x81 || (p[i + 1] == 0x82 && p[i + 2] <= 0x96))) {
+            fprintf(stderr, "\"%s\" left hiragana in katakana \"%s\"\n", romaji, katakana);
+            return -1;
+        }
+    }
+    memcpy(folded, katakana, len + 1);
+    kana_fold(folded, len);
+    if (strcmp(folded, hiragana) != 0) {
+        fprintf(stderr, "\"%s\": katakana \"%s\" folds to \"%s\", not \"%s\"\n",
+                romaji, katakana, folded, hiragana);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_conversion(const char *romaji, const char *expected, KanaMode mode) {
+    char actual[ROMAJI_TEXT_SIZE];
+    romaji_to_kana(romaji, mode, actual, sizeof(actual));
+    if (strcmp(actual, expected) != 0) {
+        fprintf(stderr, "\"%s\" gave \"%s\", not \"%s\"\n", romaji, actual, expected);
+        return -1;
+    }
+    return 0;
+}
+
+// Every entry of every table on its own in both scripts, and every ordered
+// pair of whole entries, which must convert as the two kana side by side
+static int check_tables(int *checked) {
+    char romaji[2 * MAX_ROMAJI_LENGTH + 1], expected[ROMAJI_TEXT_SIZE], katakana[ROMAJI_TEXT_SIZE];
+    RomajiConverter converter;
+
+    *checked = 0;
+    for (int i = 0; romaji_table[i].romaji; i++) {
+        const RomajiPair *entry = &romaji_table[i];
+        if (check_conversion(entry->romaji, entry->hiragana, KANA_HIRAGANA) < 0) return -1;
+        romaji_to_kana(entry->romaji, KANA_KATAKANA, katakana, sizeof(katakana));
+        if (check_katakana(entry->romaji, entry->hiragana, katakana) < 0) return -1;
+        (*checked)++;
+
+        for (int j = 0; romaji_table[j].romaji; j++) {
+            snprintf(romaji, sizeof(romaji), "%s%s", entry->romaji, romaji_table[j].romaji);
+            snprintf(expected, sizeof(expected), "%s%s", entry->hiragana, romaji_table[j].hiragana);
+            if (check_conversion(romaji, expected, KANA_HIRAGANA) < 0) return -1;
+            (*checked)++;
+        }
+    }
+
+    // A split entry gives its kana, then its last letters as typed on their own
+    for (int i = 0; romaji_split_table[i].romaji; i++) {
+        const RomajiSplit *entry = &romaji_split_table[i];
+        const char *rest = entry->romaji + strlen(entry->romaji) - entry->rest;
+        RomajiConverter alone;
+
+        for (int mode = KANA_HIRAGANA; mode <= KANA_KATAKANA; mode++) {
+            romaji_converter_init(&converter, mode);
+            romaji_converter_init(&alone, mode);
+            for (const char *p = entry->romaji; *p; p++) romaji_converter_push(&converter, *p);
+            for (const char *p = rest; *p; p++) romaji_converter_push(&alone, *p);
+
+            int kana_len = converter.length - alone.length;
+            if (kana_len < 0 || converter.pending != alone.pending ||
+                strcmp(converter.text + kana_len, alone.text) != 0) {
+                fprintf(stderr, "split \"%s\" gave \"%s\"\n", entry->romaji, converter.text);
+                return -1;
+            }
+            converter.text[kana_len] = '\0';
+            if (mode == KANA_HIRAGANA ? strcmp(converter.text, entry->hiragana) != 0
+                                      : check_katakana(entry->romaji, entry->hiragana,
+                                                       converter.text) < 0) {
+                fprintf(stderr, "split \"%s\" gave \"%s\"\n", entry->romaji, converter.text);
+                return -1;
+            }
+            (*checked)++;
+        }
+    }
+
+    // Final kana only once the input ends
+    for (int i = 0; romaji_final_table[i].romaji; i++) {
+        const RomajiPair *entry = &romaji_final_table[i];
+        if (check_conversion(entry->romaji, entry->hiragana, KANA_HIRAGANA) < 0) return -1;
+        romaji_to_kana(entry->romaji, KANA_KATAKANA, katakana, sizeof(katakana));
+        if (check_katakana(entry->romaji, entry->hiragana, katakana) < 0) return -1;
+        (*checked)++;
+    }
+    return 0;
+}
+
+static int check_known_words(int *checked) {
+    char folded[ROMAJI_TEXT_SIZE];
+
+    *checked = 0;
+    for (const KnownWord *word = known_words; word->romaji; word++) {
+        if (check_conversion(word->romaji, word->hiragana, KANA_HIRAGANA) < 0) return -1;
+        (*checked)++;
+        if (!word->katakana) continue;
+
+        if (check_conversion(word->romaji, word->katakana, KANA_KATAKANA) < 0) return -1;
+        snprintf(folded, sizeof(folded), "%s", word->katakana);
+        kana_fold(folded, strlen(folded));
+        if (strcmp(folded, word->hiragana) != 0) {
+            fprintf(stderr, "\"%s\" folds to \"%s\"\n", word->katakana, folded);
+            return -1;
+        }
+        (*checked)++;
+    }
+    return 0;
+}
+
+// Random keystrokes, backspaces and script changes must always leave the
+// converter where a from-scratch conversion of its romaji would
+static int fuzz_incremental(int cases) {
+    RomajiConverter converter;
+    char expected[ROMAJI_TEXT_SIZE], actual[ROMAJI_TEXT_SIZE];
+
+    romaji_converter_init(&converter, KANA_HIRAGANA);
+    for (int n = 0; n < cases; n++) {
+        int action = rand() % 64;
+        if (action < 16) {
+            romaji_converter_backspace(&converter);
+        } else if (action == 16) {
+            romaji_converter_set_mode(&converter, converter.mode == KANA_HIRAGANA
+                                                  ? KANA_KATAKANA : KANA_HIRAGANA);
+        } else if (romaji_converter_push(&converter, fuzz_alphabet[rand() % FUZZ_LETTERS]) < 0) {
+            romaji_converter_reset(&converter);
+        }
+
+        romaji_to_kana(converter.romaji, converter.mode, expected, sizeof(expected));
+        romaji_converter_finish(&converter, actual, sizeof(actual));
+        if (strcmp(expected, actual) != 0) {
+            fprintf(stderr, "incremental mismatch for \"%s\": \"%s\" vs \"%s\"\n",
+                    converter.romaji, actual, expected);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// The previous converter: a DFA over the hiragana-only table below, built
+// the way its generator did, and its keystroke loop. It emits as soon as an
+// entry is complete, so "n" is always ん and "nn" is んん.
+static const RomajiPair baseline_table[] = {
+    {"kya", "きゃ"}, {"kyu", "きゅ"}, {"kyo", "きょ"},
+    {"sha", "しゃ"}, {"shu", "しゅ"}, {"sho", "しょ"},
+    {"cha", "ちゃ"}, {"chu", "ちゅ"}, {"cho", "ちょ"},
+    {"nya", "にゃ"}, {"nyu", "にゅ"}, {"nyo", "にょ"},
+    {"hya", "ひゃ"}, {"hyu", "ひゅ"}, {"hyo", "ひょ"},
+    {"mya", "みゃ"}, {"myu", "みゅ"}, {"myo", "みょ"},
+    {"rya", "りゃ"}, {"ryu", "りゅ"}, {"ryo", "りょ"},
+    {"gya", "ぎゃ"}, {"gyu", "ぎゅ"}, {"gyo", "ぎょ"},
+    {"ja", "じゃ"}, {"ju", "じゅ"}, {"jo", "じょ"},
+    {"bya", "びゃ"}, {"byu", "びゅ"}, {"byo", "びょ"},
+    {"pya", "ぴゃ"}, {"pyu", "ぴゅ"}, {"pyo", "ぴょ"},
+    {"ka", "か"}, {"ki", "き"}, {"ku", "く"}, {"ke", "け"}, {"ko", "こ"},
+    {"ga", "が"}, {"gi", "ぎ"}, {"gu", "ぐ"}, {"ge", "げ"}, {"go", "ご"},
+    {"sa", "さ"}, {"shi", "し"}, {"su", "す"}, {"se", "せ"}, {"so", "そ"},
+    {"za", "ざ"}, {"ji", "じ"}, {"zu", "ず"}, {"ze", "ぜ"}, {"zo", "ぞ"},
+    {"ta", "た"}, {"chi", "ち"}, {"tsu", "つ"}, {"te", "て"}, {"to", "と"},
+    {"da", "だ"}, {"dzi", "ぢ"}, {"dzu", "づ"}, {"de", "で"}, {"do", "ど"},
+    {"na", "な"}, {"ni", "に"}, {"nu", "ぬ"}, {"ne", "ね"}, {"no", "の"},
+    {"ha", "は"}, {"hi", "ひ"}, {"fu", "ふ"}, {"he", "へ"}, {"ho", "ほ"},
+    {"ba", "ば"}, {"bi", "び"}, {"bu", "ぶ"}, {"be", "べ"}, {"bo", "ぼ"},
+    {"pa", "ぱ"}, {"pi", "ぴ"}, {"pu", "ぷ"}, {"pe", "ぺ"}, {"po", "ぽ"},
+    {"ma", "ま"}, {"mi", "み"}, {"mu", "む"}, {"me", "め"}, {"mo", "も"},
+    {"ya", "や"}, {"yu", "ゆ"}, {"yo", "よ"},
+    {"ra", "ら"}, {"ri", "り"}, {"ru", "る"}, {"re", "れ"}, {"ro", "ろ"},
+    {"wa", "わ"}, {"wo", "を"}, {"n", "ん"},
+    {"a", "あ"}, {"i", "い"}, {"u", "う"}, {"e", "え"}, {"o", "お"},
+    {"kk", "っk"}, {"ss", "っs"}, {"tt", "っt"}, {"pp", "っp"},
+    {"gg", "っg"}, {"zz", "っz"}, {"dd", "っd"}, {"bb", "っb"},
+    {NULL, NULL}
+};
+
+static unsigned char baseline_next[BASELINE_STATES][26];
+static const char *baseline_kana[BASELINE_STATES];
+static unsigned char baseline_kana_len[BASELINE_STATES];
+
+typedef struct {
+    char text[ROMAJI_TEXT_SIZE];
+    int length;
+    int pending;
+    int state;
+    char romaji[INPUT_BUFFER_SIZE];
+    int romaji_length;
+    struct {
+        short length;
+        unsigned char pending;
+        unsigned char state;
+    } history[INPUT_BUFFER_SIZE];
+} BaselineConverter;
+
+static void baseline_build(void) {
+    int state_count = 1;
+
+    for (int i = 0; baseline_table[i].romaji; i++) {
+        int state = 0;
+        for (const char *p = baseline_table[i].romaji; *p; p++) {
+            int c = *p - 'a';
+            if (!baseline_next[state][c]) baseline_next[state][c] = state_count++;
+            state = baseline_next[state][c];
+        }
+        baseline_kana[state] = baseline_table[i].hiragana;
+        baseline_kana_len[state] = strlen(baseline_table[i].hiragana);
+    }
+}
+
+static void baseline_reset(BaselineConverter *converter) {
+    converter->text[0] = '\0';
+    converter->length = 0;
+    converter->pending = 0;
+    converter->state = 0;
+    converter->romaji[0] = '\0';
+    converter->romaji_length = 0;
+}
+
+static void baseline_feed(BaselineConverter *converter, char ch) {
+    for (;;) {
+        int next = (ch >= 'a' && ch <= 'z') ? baseline_next[converter->state][ch - 'a'] : 0;
+
+        if (next && baseline_kana[next]) {
+            converter->length -= converter->pending;
+            memcpy(converter->text + converter->length, baseline_kana[next], baseline_kana_len[next]);
+            converter->length += baseline_kana_len[next];
+            converter->pending = 0;
+            converter->state = 0;
+            return;
+        }
+
+        if (next || converter->pending == 0) {
+            converter->text[converter->length++] = ch;
+            if (next) {
+                converter->pending++;
+                converter->state = next;
+            }
+            return;
+        }
+
+        char rest[MAX_ROMAJI_LENGTH];
+        int count = converter->pending - 1;
+
+        memcpy(rest, converter->text + converter->length - count, count);
+        converter->length -= count;
+        converter->pending = 0;
+        converter->state = 0;
+        for (int i = 0; i < count; i++) baseline_feed(converter, rest[i]);
+    }
+}
+
+static int baseline_push(BaselineConverter *converter, char ch) {
+    if (ch == '\0' || converter->romaji_length >= INPUT_BUFFER_SIZE - 1) return -1;
+
+    int n = converter->romaji_length;
+    converter->history[n].length = converter->length;
+    converter->history[n].pending = converter->pending;
+    converter->history[n].state = converter->state;
+    converter->romaji[n] = ch;
+    converter->romaji[n + 1] = '\0';
+    converter->romaji_length = n + 1;
+
+    baseline_feed(converter, ch);
+    converter->text[converter->length] = '\0';
+    return 0;
+}
+
+static double baseline_rate(void) {
+    BaselineConverter converter;
+    int sample_len = strlen(sample_text);
+
+    baseline_reset(&converter);
+    double start = now_ms();
+    for (int typed = 0; typed < DFA_CHARS; ) {
+        for (int i = 0; i < LINE_LENGTH && typed < DFA_CHARS; i++, typed++) {
+            baseline_push(&converter, sample_text[typed % sample_len]);
+        }
+        baseline_reset(&converter);
+    }
+    return DFA_CHARS / ((now_ms() - start) / 1000.0);
+}
+
+static double keystroke_rate(KanaMode mode) {
+    RomajiConverter converter;
+    int sample_len = strlen(sample_text);
+
+    romaji_converter_init(&converter, mode);
+    double start = now_ms();
+    for (int typed = 0; typed < DFA_CHARS; ) {
+        for (int i = 0; i < LINE_LENGTH && typed < DFA_CHARS; i++, typed++) {
+            romaji_converter_push(&converter, sample_text[typed % sample_len]);
+        }
+        romaji_converter_reset(&converter);
+    }
+    return DFA_CHARS / ((now_ms() - start) / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    int cases = argc > 1 ? atoi(argv[1]) : DEFAULT_CASES;
+    int table_checks, word_checks;
+
+    if (cases <= 0) cases = DEFAULT_CASES;
+    srand(1234);
+
+    if (check_tables(&table_checks) < 0 || check_known_words(&word_checks) < 0 ||
+        fuzz_incremental(cases) < 0) {
+        return 1;
+    }
+    printf("tables: %d conversions ok, known words: %d ok, %d incremental edits ok\n\n",
+           table_checks, word_checks, cases);
+
+    // Best of several runs each, interleaved so a noisy stretch hits all three
+    double baseline = 0, hiragana_rate = 0, katakana_rate = 0;
+    baseline_build();
+    for (int run = 0; run < RATE_RUNS; run++) {
+        double rate = baseline_rate();
+        if (rate > baseline) baseline = rate;
+        rate = keystroke_rate(KANA_HIRAGANA);
+        if (rate > hiragana_rate) hiragana_rate = rate;
+        rate = keystroke_rate(KANA_KATAKANA);
+        if (rate > katakana_rate) katakana_rate = rate;
+    }
+
+    printf("%-24s %14s %10s\n", "converter", "chars/sec", "ns/key");
+    printf("%-24s %14.0f %10.2f\n", "previous, hiragana only", baseline, 1e9 / baseline);
+    printf("%-24s %14.0f %10.2f\n", "incremental, hiragana", hiragana_rate, 1e9 / hiragana_rate);
+    printf("%-24s %14.0f %10.2f\n", "incremental, katakana", katakana_rate, 1e9 / katakana_rate);
+
+    if (hiragana_rate < baseline || katakana_rate < baseline) {
+        fprintf(stderr, "slower per keystroke than the previous converter\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Card selection cost on large decks: a linear scan for the best card vs.
+// the scheduler's heap, for each strategy
+//
+// Usage: scheduler_bench [picks]
+// Each pick spawns a card and kills the oldest of IN_PLAY cards on screen,
+// as the game does. Also checks that picks come out in priority order.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/scheduler.h"
+
+#define DEFAULT_PICKS 1000000
+#define SCAN_PICKS 2000         // the linear scan is too slow for more
+#define IN_PLAY 10
+
+static const int deck_sizes[] = {1000, 50000, 200000};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Review states roughly like a mature deck: mostly review cards around
+// their due date, some new, learning and suspended ones
+static void make_schedule(CardSchedule *schedule, int count) {
+    for (int i = 0; i < count; i++) {
+        CardSchedule *s = &schedule[i];
+        int kind = rand() % 100;
+
+        memset(s, 0, sizeof(*s));
+        s->queue = kind < 15 ? CARD_QUEUE_NEW : kind < 20 ? CARD_QUEUE_LEARNING
+                 : kind < 97 ? CARD_QUEUE_REVIEW : -1;
+        if (s->queue == CARD_QUEUE_NEW) continue;
+
+        s->overdue_days = (float)(rand() % 120 - 90);
+        s->interval = 1 + rand() % 365;
+        s->factor = 1300 + rand() % 1800;
+        s->reps = 1 + rand() % 40;
+        s->lapses = rand() % (1 + s->reps / 4);
+        s->reviews = s->reps;
+        s->failures = rand() % (1 + s->reviews / 3);
+    }
+}
+
+// What a scheduler without a heap would do: score every waiting card
+static int pick_linear(const SchedulerStrategy *strategy, const CardSchedule *schedule,
+                       const int *shown, const char *in_play, int count) {
+    int best = -1;
+    float best_key = 0.0f;
+    for (int i = 0; i < count; i++) {
+        if (in_play[i]) continue;
+        float key = strategy->priority(&schedule[i], shown[i], (float)rand() / RAND_MAX);
+        if (best < 0 || key > best_key) {
+            best = i;
+            best_key = key;
+        }
+    }
+    return best;
+}
+
+static double run_linear(const SchedulerStrategy *strategy, const CardSchedule *schedule,
+                         int count, int picks) {
+    int *shown = calloc(count, sizeof(int));
+    char *in_play = calloc(count, 1);
+    int window[IN_PLAY];
+    int filled = 0;
+
+    double start = now_ms();
+    for (int n = 0; n < picks; n++) {
+        if (filled == IN_PLAY) {
+            in_play[window[n % IN_PLAY]] = 0;
+            filled--;
+        }
+        int card = pick_linear(strategy, schedule, shown, in_play, count);
+        shown[card]++;
+        in_play[card] = 1;
+        window[n % IN_PLAY] = card;
+        filled++;
+    }
+    double elapsed = now_ms() - start;
+
+    free(shown);
+    free(in_play);
+    return elapsed;
+}
+
+static double run_heap(const SchedulerStrategy *strategy, const CardSchedule *schedule,
+                       int count, int picks, double *create_ms) {
+    int window[IN_PLAY];
+    int filled = 0;
+
+    double start = now_ms();
+    CardScheduler *scheduler = scheduler_create(strategy, schedule, count, 42);
+    *create_ms = now_ms() - start;
+    if (!scheduler) return -1.0;
+
+    start = now_ms();
+    for (int n = 0; n < picks; n++) {
+        if (filled == IN_PLAY) {
+            scheduler_release(scheduler, window[n % IN_PLAY]);
+            filled--;
+        }
+        window[n % IN_PLAY] = scheduler_next(scheduler);
+        filled++;
+    }
+    double elapsed = now_ms() - start;
+
+    scheduler_destroy(scheduler);
+    return elapsed;
+}
+
+// Draining a fresh scheduler must yield keys in non-increasing order
+static int check_order(const SchedulerStrategy *strategy, const CardSchedule *schedule, int count) {
+    CardScheduler *scheduler = scheduler_create(strategy, schedule, count, 7);
+    if (!scheduler) return -1;
+
+    float last = 0.0f;
+    int ok = 1;
+    for (int n = 0; n < count && ok; n++) {
+        float key = scheduler->heap[0].key;
+        if (n > 0 && key > last) ok = 0;
+        last = key;
+        if (scheduler_next(scheduler) < 0) ok = 0;
+    }
+    if (scheduler_next(scheduler) != -1) ok = 0;
+
+    scheduler_destroy(scheduler);
+    return ok ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+    int picks = argc > 1 ? atoi(argv[1]) : DEFAULT_PICKS;
+    if (picks <= 0) picks = DEFAULT_PICKS;
+
+    printf("%8s %-8s %10s %12s %12s %10s %9s\n", "cards", "strategy", "create ms",
+           "heap pick/s", "scan pick/s", "speedup", "order");
+    for (size_t d = 0; d < sizeof(deck_sizes) / sizeof(deck_sizes[0]); d++) {
+        int count = deck_sizes[d];
+        CardSchedule *schedule = malloc(count * sizeof(CardSchedule));
+        if (!schedule) return 1;
+
+        srand(1);
+        make_schedule(schedule, count);
+
+        for (int s = 0; s < SCHEDULER_STRATEGY_COUNT; s++) {
+            const SchedulerStrategy *strategy = &scheduler_strategies[s];
+            double create_ms;
+            double heap_ms = run_heap(strategy, schedule, count, picks, &create_ms);
+            double scan_ms = run_linear(strategy, schedule, count, SCAN_PICKS);
+            double heap_rate = picks / (heap_ms / 1000.0);
+            double scan_rate = SCAN_PICKS / (scan_ms / 1000.0);
+            int ordered = check_order(strategy, schedule, count) == 0;
+
+            printf("%8d %-8s %10.2f %12.0f %12.0f %9.0fx %9s\n", count, strategy->name,
+                   create_ms, heap_rate, scan_rate, heap_rate / scan_rate,
+                   ordered ? "ok" : "BROKEN");
+            if (!ordered) return 1;
+        }
+        free(schedule);
+    }
+    return 0;
+}
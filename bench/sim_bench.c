@@ -0,0 +1,190 @@
+// Headless game benchmark: a scripted typist plays the simulation core at
+// full speed, no SDL, fonts or display needed
+//
+// Usage: sim_bench [ticks] [seed]
+// Reports ticks/sec, p50/p99 tick latency and heap allocations made while
+// playing (setup excluded), for a normal and a swarm scenario.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/sim.h"
+#include "../collectionlib/bench/alloc_count.h"
+
+#define DEFAULT_TICKS (SIM_DEFAULT_TICK_RATE * 600)  // ten simulated minutes
+#define CARD_COUNT 20000       // above the swarm size: a card is on screen at most once
+#define WORD_SYLLABLES 4
+#define TYPO_PERCENT 3
+
+typedef struct {
+    const char *name;
+    int max_enemies;
+    uint32_t spawn_delay;
+    float enemy_speed;
+    int height;                 // kill line sits 50px above this
+    int keys_per_second;
+} Scenario;
+
+static const Scenario scenarios[] = {
+    {"normal", 10, 6000, 30.0f, 600, 8},
+    // Huge field so nobody reaches the line; measures a full house
+    {"swarm", 10000, 10, 5.0f, 100000000, 40},
+};
+
+static const char *syllables[] = {
+    "ka", "ki", "ku", "ke", "ko", "sa", "shi", "su", "se", "so", "ta", "chi", "tsu",
+    "te", "to", "ha", "hi", "fu", "he", "ho", "ma", "mi", "mu", "me", "mo", "ya",
+    "yu", "yo", "ra", "ri", "ru", "re", "ro", "wa", "ga", "gi", "go", "kyo", "sha",
+    "a", "i", "u", "e", "o",
+};
+#define SYLLABLE_COUNT (int)(sizeof(syllables) / sizeof(syllables[0]))
+
+static CardData cards[CARD_COUNT];
+static char romaji[CARD_COUNT][WORD_SYLLABLES * 3 + 1];
+static char readings[CARD_COUNT][INPUT_BUFFER_SIZE];
+
+// Types the romaji of some live enemy, with the odd typo fixed by backspace
+typedef struct {
+    const char *word;           // romaji being typed, NULL when idle
+    int typed;
+    int typo_pending;
+    uint64_t next_key_tick;
+    int ticks_per_key;
+    uint64_t rng;
+    long keys;
+} Typist;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t typist_random(Typist *typist) {
+    typist->rng = typist->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(typist->rng >> 33);
+}
+
+static void make_cards(void) {
+    srand(7);
+    for (int i = 0; i < CARD_COUNT; i++) {
+        int len = 0;
+        int count = 1 + rand() % WORD_SYLLABLES;
+        for (int s = 0; s < count; s++) {
+            const char *syllable = syllables[rand() % SYLLABLE_COUNT];
+            memcpy(romaji[i] + len, syllable, strlen(syllable));
+            len += strlen(syllable);
+        }
+        romaji[i][len] = '\0';
+
+        // Whatever the converter makes of the romaji is, by definition, typeable
+        romaji_to_hiragana(romaji[i], readings[i], sizeof(readings[i]));
+        cards[i].word = readings[i];
+        cards[i].word_reading = readings[i];
+        cards[i].word_meaning = romaji[i];
+    }
+}
+
+static void typist_step(Typist *typist, GameSim *sim) {
+    if (sim->tick < typist->next_key_tick) return;
+    typist->next_key_tick = sim->tick + typist->ticks_per_key;
+
+    if (!typist->word) {
+        if (sim->enemies->count == 0) return;
+        int slot = typist_random(typist) % sim->enemies->count;
+        typist->word = romaji[sim->enemies->card_index[slot]];
+        typist->typed = 0;
+    }
+
+    char key;
+    if (typist->typo_pending) {
+        key = SIM_KEY_BACKSPACE;
+        typist->typo_pending = 0;
+    } else if (typist->word[typist->typed] == '\0') {
+        key = SIM_KEY_SUBMIT;
+        typist->word = NULL;
+    } else if ((int)(typist_random(typist) % 100) < TYPO_PERCENT) {
+        key = 'q';
+        typist->typo_pending = 1;
+    } else {
+        key = typist->word[typist->typed++];
+    }
+
+    sim_key(sim, key);
+    typist->keys++;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int run_scenario(const Scenario *scenario, int ticks, uint64_t seed) {
+    CardCollection collection;
+    SimConfig config;
+    Typist typist;
+
+    // Publishing works out each card's answers, as a load would; those of
+    // the last scenario went with its arena
+    memset(&collection, 0, sizeof(collection));
+    arena_init(&collection.strings, ARENA_DEFAULT_BLOCK_SIZE);
+    for (int i = 0; i < CARD_COUNT; i++) cards[i].answers = NULL;
+    collection.cards = cards;
+    collection.count = CARD_COUNT;
+    collection_publish(&collection);
+
+    sim_default_config(&config);
+    config.max_enemies = scenario->max_enemies;
+    config.spawn_delay = scenario->spawn_delay;
+    config.enemy_speed = scenario->enemy_speed;
+    config.height = scenario->height;
+    config.seed = seed;
+
+    memset(&typist, 0, sizeof(typist));
+    typist.ticks_per_key = config.tick_rate / scenario->keys_per_second;
+    typist.rng = seed;
+
+    GameSim *sim = sim_create(&config, &collection);
+    double *latency = malloc(ticks * sizeof(double));
+    if (!sim || !latency) return -1;
+
+    unsigned long allocs_before = alloc_count();
+    double start = now_ns();
+    int played = 0;
+    for (; played < ticks && !sim->game_over; played++) {
+        double tick_start = now_ns();
+        typist_step(&typist, sim);
+        sim_step(sim);
+        latency[played] = now_ns() - tick_start;
+    }
+    double elapsed = now_ns() - start;
+    unsigned long allocs = alloc_count() - allocs_before;
+
+    qsort(latency, played, sizeof(double), compare_double);
+    printf("%-8s %8d %12.0f %9.0f %9.0f %8lu %8ld %8d %7d%s\n", scenario->name, played,
+           played / (elapsed / 1e9), latency[played / 2], latency[played * 99 / 100],
+           allocs, typist.keys, sim->score / 100, sim->enemies->count,
+           sim->game_over ? " (game over)" : "");
+
+    free(latency);
+    sim_destroy(sim);
+    arena_free(&collection.strings);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int ticks = argc > 1 ? atoi(argv[1]) : DEFAULT_TICKS;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 10) : 1;
+
+    if (ticks <= 0) ticks = DEFAULT_TICKS;
+    make_cards();
+
+    printf("%-8s %8s %12s %9s %9s %8s %8s %8s %7s\n", "scenario", "ticks", "ticks/sec",
+           "p50 ns", "p99 ns", "allocs", "keys", "kills", "alive");
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (run_scenario(&scenarios[i], ticks, seed) < 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+// Submission cost against readings as decks store them: furigana, katakana,
+// HTML and alternatives. Compares strcmp against the raw field, normalizing
+// every live reading on each submit, and the answers collectionlib works out
+// once at load, looked up by length and hash.
+//
+// Usage: submit_bench [submissions]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../collectionlib/include/collection.h"
+#include "../collectionlib/include/reading.h"
+#include "../src/reading_index.h"
+
+#define DEFAULT_SUBMISSIONS 200000
+#define CARD_COUNT 20000
+#define KANA_CHARS 4
+
+static CardData cards[CARD_COUNT];
+static char fields[CARD_COUNT][128];
+static char typed[CARD_COUNT][KANA_CHARS * 3 + 1];     // what a player would submit
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void put_kana(char *out, int cp) {
+    out[0] = 0xE0 | (cp >> 12);
+    out[1] = 0x80 | ((cp >> 6) & 0x3F);
+    out[2] = 0x80 | (cp & 0x3F);
+}
+
+// A hiragana reading from あ (U+3042) to ん (U+3093), and the field it is
+// stored in: as is, in katakana, as furigana, in HTML or with an alternative
+static void make_cards(void) {
+    for (int i = 0; i < CARD_COUNT; i++) {
+        char hiragana[KANA_CHARS * 3 + 1], katakana[KANA_CHARS * 3 + 1];
+        int chars = 2 + rand() % (KANA_CHARS - 1);
+        for (int c = 0; c < chars; c++) {
+            int cp = 0x3042 + rand() % (0x3093 - 0x3042 + 1);
+            put_kana(hiragana + c * 3, cp);
+            put_kana(katakana + c * 3, cp + 0x60);
+        }
+        hiragana[chars * 3] = katakana[chars * 3] = '\0';
+        memcpy(typed[i], hiragana, sizeof(hiragana));
+
+        switch (i % 5) {
+        case 0: snprintf(fields[i], sizeof(fields[i]), "%s", hiragana); break;
+        case 1: snprintf(fields[i], sizeof(fields[i]), "%s", katakana); break;
+        case 2: snprintf(fields[i], sizeof(fields[i]), " 漢字[%s]", hiragana); break;
+        case 3: snprintf(fields[i], sizeof(fields[i]), "<b>%s</b>&nbsp;", hiragana); break;
+        case 4: snprintf(fields[i], sizeof(fields[i]), "%s、%s", katakana, hiragana); break;
+        }
+        cards[i].word = cards[i].word_meaning = fields[i];
+        cards[i].word_reading = fields[i];
+    }
+}
+
+// What check_input did before readings were normalized
+static int find_raw(const int *enemies, int count, const char *input) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(input, cards[enemies[i]].word_reading) == 0) return i;
+    }
+    return -1;
+}
+
+// Right answers, but every live reading is normalized again per submit
+static int find_normalizing(const int *enemies, int count, const char *input) {
+    char text[READING_BUFFER_SIZE];
+    CardAnswer answers[CARD_MAX_ANSWERS];
+
+    for (int i = 0; i < count; i++) {
+        const char *reading = cards[enemies[i]].word_reading;
+        int n = reading_normalize(reading, strlen(reading), text, sizeof(text),
+                                  answers, CARD_MAX_ANSWERS);
+        for (int k = 0; k < n; k++) {
+            if (strcmp(input, answers[k].text) == 0) return i;
+        }
+    }
+    return -1;
+}
+
+static void index_enemy(ReadingIndex *index, int slot, int card) {
+    for (int k = 0; k < cards[card].answer_count; k++) {
+        const CardAnswer *answer = &cards[card].answers[k];
+        reading_index_insert(index, slot * CARD_MAX_ANSWERS + k, answer->text, answer->length,
+                             answer->hash);
+    }
+}
+
+static void unindex_enemy(ReadingIndex *index, int slot) {
+    for (int k = 0; k < CARD_MAX_ANSWERS; k++) {
+        reading_index_remove(index, slot * CARD_MAX_ANSWERS + k);
+    }
+}
+
+// Submit the reading of a random live enemy; a hit respawns the slot with
+// another card, so every strategy sees the same sequence
+static double run(int enemy_count, int submissions, int strategy, long *hits) {
+    int *enemies = malloc(enemy_count * sizeof(int));
+    ReadingIndex *index = strategy == 2 ? reading_index_create(enemy_count * CARD_MAX_ANSWERS)
+                                        : NULL;
+
+    srand(99);
+    for (int i = 0; i < enemy_count; i++) {
+        enemies[i] = rand() % CARD_COUNT;
+        if (index) index_enemy(index, i, enemies[i]);
+    }
+
+    *hits = 0;
+    double start = now_ms();
+    for (int n = 0; n < submissions; n++) {
+        const char *input = typed[enemies[rand() % enemy_count]];
+        int slot;
+        if (strategy == 0) {
+            slot = find_raw(enemies, enemy_count, input);
+        } else if (strategy == 1) {
+            slot = find_normalizing(enemies, enemy_count, input);
+        } else {
+            size_t length = strlen(input);
+            int entry = reading_index_find(index, input, length, reading_text_hash(input, length));
+            slot = entry < 0 ? -1 : entry / CARD_MAX_ANSWERS;
+        }
+
+        int card = rand() % CARD_COUNT;
+        if (slot < 0) continue;
+        (*hits)++;
+        enemies[slot] = card;
+        if (index) {
+            unindex_enemy(index, slot);
+            index_enemy(index, slot, card);
+        }
+    }
+    double elapsed = now_ms() - start;
+
+    reading_index_destroy(index);
+    free(enemies);
+    return elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    int submissions = argc > 1 ? atoi(argv[1]) : DEFAULT_SUBMISSIONS;
+    const int enemy_counts[] = {10, 100, 1000};
+    const char *strategies[] = {"raw strcmp", "normalize per submit", "precomputed"};
+    CardCollection collection;
+
+    if (submissions <= 0) submissions = DEFAULT_SUBMISSIONS;
+    srand(1234);
+    make_cards();
+
+    // The one-off cost, paid as the cards are published
+    memset(&collection, 0, sizeof(collection));
+    arena_init(&collection.strings, ARENA_DEFAULT_BLOCK_SIZE);
+    collection.cards = cards;
+    collection.count = CARD_COUNT;
+    double start = now_ms();
+    collection_publish(&collection);
+    printf("normalize at load: %.1f ns/card, %zu KiB\n\n",
+           (now_ms() - start) * 1e6 / CARD_COUNT, collection.strings.total_bytes / 1024);
+
+    printf("%-8s %-22s %9s %12s\n", "enemies", "strategy", "hits", "ns/submit");
+    for (size_t e = 0; e < sizeof(enemy_counts) / sizeof(enemy_counts[0]); e++) {
+        for (int s = 0; s < 3; s++) {
+            long hits;
+            double ms = run(enemy_counts[e], submissions, s, &hits);
+            printf("%-8d %-22s %9ld %12.1f\n", enemy_counts[e], strategies[s], hits,
+                   ms * 1e6 / submissions);
+
+            // Every submission is some live enemy's reading
+            if (s > 0 && hits != submissions) {
+                fprintf(stderr, "%s found %ld of %d submissions\n", strategies[s], hits,
+                        submissions);
+                return 1;
+            }
+        }
+    }
+
+    arena_free(&collection.strings);
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Frame-time benchmark: per-frame TTF_RenderUTF8_Blended vs. the glyph atlas,
+// then the HUD over a typing session, counting layouts per frame
+//
+// Usage: text_bench [font_path] [frames]
+// Set SDL_VIDEODRIVER=dummy to run without a display.
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/glyph_atlas.h"
+#include "../src/hud.h"
+
+#define BENCH_WIDTH 800
+#define BENCH_HEIGHT 600
+#define DEFAULT_FONT "assets/fonts/NotoSansJP-Regular.ttf"
+#define DEFAULT_FRAMES 200
+#define KEY_FRAMES 8            // a keystroke every 8 frames, ~7.5 keys/s at 60 Hz
+#define SCORE_FRAMES 120
+
+static const char *sample_words[] = {
+    "日本語", "勉強", "漢字", "先生", "学校", "電車", "新聞", "天気",
+    "ひらがな", "かたかな", "Score: 12300", "a scholarly meaning",
+};
+#define SAMPLE_COUNT (int)(sizeof(sample_words) / sizeof(sample_words[0]))
+
+// The original render_text: one surface and one texture per string per frame
+static void render_text_legacy(SDL_Renderer *renderer, TTF_Font *font, const char *text,
+                               int x, int y, SDL_Color color) {
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(font, text, color);
+    if (!surface) return;
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (texture) {
+        SDL_Rect dest = {x - surface->w / 2, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, NULL, &dest);
+        SDL_DestroyTexture(texture);
+    }
+    SDL_FreeSurface(surface);
+}
+
+static void render_text_atlas(GlyphAtlas *atlas, const char *text, int x, int y, SDL_Color color) {
+    int w, h;
+    glyph_atlas_measure(atlas, text, &w, &h);
+    glyph_atlas_draw(atlas, text, x - w / 2, y, color);
+}
+
+static double run_frames(SDL_Renderer *renderer, TTF_Font *font, GlyphAtlas *atlas,
+                         int strings, int frames) {
+    SDL_Color white = {255, 255, 255, 255};
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int f = 0; f < frames; f++) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        for (int i = 0; i < strings; i++) {
+            const char *text = sample_words[i % SAMPLE_COUNT];
+            int x = 50 + (i * 37) % (BENCH_WIDTH - 100);
+            int y = (i * 53 + f) % BENCH_HEIGHT;
+
+            if (atlas) {
+                render_text_atlas(atlas, text, x, y, white);
+            } else {
+                render_text_legacy(renderer, font, text, x, y, white);
+            }
+        }
+
+        if (atlas) glyph_atlas_flush(atlas);
+        SDL_RenderPresent(renderer);
+    }
+
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / freq / frames;
+}
+
+// Keystrokes and score changes on some frames, nothing on the rest; every
+// frame that changed nothing must lay out nothing and rasterize no glyphs.
+// Returns -1 otherwise.
+static int run_hud(SDL_Renderer *renderer, GlyphAtlas *atlas, int frames) {
+    static const char typing[] = "kyoushitsudebenkyoushita";
+    SDL_Color white = {255, 255, 255, 255};
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    long score = 0;
+    int typed = 0, idle = 0, busy = 0;
+    unsigned long idle_laid_out = 0, idle_glyphs = 0;
+    Hud hud;
+
+    hud_init(&hud, atlas, atlas, atlas);
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int f = 0; f < frames; f++) {
+        int changed = f == 0 || f % KEY_FRAMES == 0 || f % SCORE_FRAMES == 0;
+        if (f > 0 && f % KEY_FRAMES == 0) typed = (typed + 1) % (int)sizeof(typing);
+        if (f > 0 && f % SCORE_FRAMES == 0) score += 100;
+
+        unsigned long glyphs = atlas->rasterized;
+        hud_begin_frame(&hud);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        hud_text_set(&hud.romaji, typing, typed);
+        hud_text_draw(&hud, &hud.romaji, BENCH_WIDTH / 2, BENCH_HEIGHT - 80, white);
+        hud_text_set_number(&hud.score, "Score: %ld", score);
+        hud_text_draw(&hud, &hud.score, 100, 30, white);
+        glyph_atlas_flush(atlas);
+        SDL_RenderPresent(renderer);
+
+        if (changed) {
+            busy++;
+        } else {
+            idle++;
+            idle_laid_out += hud.frame_laid_out;
+            idle_glyphs += atlas->rasterized - glyphs;
+        }
+    }
+    double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / freq / frames;
+
+    printf("hud: %.3f ms/frame, %lu layouts over %d frames that changed, "
+           "%lu layouts and %lu glyphs over %d idle frames\n",
+           ms, hud.laid_out, busy, idle_laid_out, idle_glyphs, idle);
+    return idle_laid_out == 0 && idle_glyphs == 0 ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *font_path = argc > 1 ? argv[1] : DEFAULT_FONT;
+    int frames = argc > 2 ? atoi(argv[2]) : DEFAULT_FRAMES;
+    const int string_counts[] = {10, 100, 1000};
+
+    if (frames <= 0) frames = DEFAULT_FRAMES;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() < 0) {
+        printf("Initialization failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Window *window = SDL_CreateWindow("text_bench", SDL_WINDOWPOS_CENTERED,
+                                          SDL_WINDOWPOS_CENTERED, BENCH_WIDTH, BENCH_HEIGHT,
+                                          SDL_WINDOW_HIDDEN);
+    SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, -1, 0) : NULL;
+    TTF_Font *font = TTF_OpenFont(font_path, 48);
+
+    if (!renderer || !font) {
+        printf("Setup failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    GlyphAtlas *atlas = glyph_atlas_create(renderer, font);
+    if (!atlas) return 1;
+
+    printf("%-10s %14s %14s %10s\n", "strings", "legacy ms/fr", "atlas ms/fr", "speedup");
+    for (size_t i = 0; i < sizeof(string_counts) / sizeof(string_counts[0]); i++) {
+        int n = string_counts[i];
+        double legacy = run_frames(renderer, font, NULL, n, frames);
+        double cached = run_frames(renderer, font, atlas, n, frames);
+        printf("%-10d %14.3f %14.3f %9.1fx\n", n, legacy, cached, legacy / cached);
+    }
+    printf("glyphs rasterized: %lu, atlas draw calls: %lu\n",
+           atlas->rasterized, atlas->draw_calls);
+    int status = run_hud(renderer, atlas, frames * 10) < 0 ? 1 : 0;
+
+    glyph_atlas_destroy(atlas);
+    TTF_CloseFont(font);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    TTF_Quit();
+    SDL_Quit();
+    return status;
+}
@@ -0,0 +1,1631 @@
+// Generated by tools/romaji_gen from src/romaji_table.h. Do not edit.
+
+#ifndef ROMAJI_DFA_H
+#define ROMAJI_DFA_H
+
+#define ROMAJI_ALPHABET "abcdefghijklmnopqrstuvwxyz-'"
+#define ROMAJI_COLUMNS 29
+#define ROMAJI_STATE_COUNT 351
+#define ROMAJI_PREFIX_COUNT 60
+
+static const unsigned char romaji_column[256] = {
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,28,0,0,0,0,0,27,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+};
+
+static const unsigned short romaji_next[ROMAJI_PREFIX_COUNT][ROMAJI_COLUMNS] = {
+    {0,60,16,2,11,63,15,3,14,61,7,1,48,18,13,64,17,39,20,4,8,62,37,21,47,19,6,306,0},
+    {0,65,0,0,0,68,0,0,0,66,0,337,0,0,0,69,0,0,0,0,0,67,0,40,0,22,0,0,0},
+    {0,70,0,331,0,85,0,0,9,84,0,0,0,0,0,72,0,0,0,0,0,71,0,0,0,28,0,0,0},
+    {0,73,0,0,0,76,0,334,0,74,0,0,0,0,0,77,0,0,0,0,0,75,0,41,0,23,0,0,0},
+    {0,78,0,0,0,82,0,0,5,79,0,0,0,0,0,83,0,0,0,343,0,81,0,0,0,24,0,0,0},
+    {0,157,0,0,0,159,0,0,0,80,0,0,0,0,0,160,0,0,0,0,0,158,0,0,0,0,0,0,0},
+    {0,86,0,0,0,90,0,0,0,87,0,0,0,0,0,91,0,0,0,0,0,89,0,0,0,26,349,0,0},
+    {0,166,0,0,0,168,0,0,0,88,336,0,0,0,0,169,0,0,0,0,0,167,0,0,0,25,0,0,0},
+    {0,92,0,59,0,97,0,0,42,93,0,0,0,0,0,98,0,0,0,10,344,95,0,43,0,27,0,0,0},
+    {0,180,0,0,0,182,0,0,0,94,0,0,0,0,0,183,0,0,0,0,0,181,0,0,0,0,0,0,0},
+    {0,251,0,0,0,253,0,0,0,252,0,0,0,0,0,254,0,0,0,0,0,96,0,0,0,0,0,0,0},
+    {0,99,0,0,332,102,0,0,44,100,0,0,0,0,0,103,0,0,0,0,0,101,0,45,0,29,12,0,0},
+    {0,0,0,0,0,0,0,0,0,104,0,0,0,0,0,0,0,0,0,0,0,105,0,0,0,0,0,0,0},
+    {0,106,310,311,312,109,313,314,315,107,316,317,318,319,307,110,320,321,322,323,324,108,325,326,327,30,328,329,308},
+    {0,111,0,0,0,115,0,0,335,112,0,0,0,0,0,116,0,0,0,0,0,113,0,0,0,31,0,0,0},
+    {0,229,0,0,0,231,333,0,0,230,0,0,0,0,0,232,0,0,0,0,0,114,0,0,0,36,0,0,0},
+    {0,117,330,0,0,120,0,0,0,118,0,0,0,0,0,121,0,0,0,0,0,119,0,0,0,32,0,0,0},
+    {0,122,0,0,0,125,0,0,0,123,0,0,0,0,0,126,340,0,0,0,0,124,0,0,0,33,0,0,0},
+    {0,127,0,0,0,130,0,0,0,128,0,0,0,339,0,131,0,0,0,0,0,129,0,0,0,34,0,0,0},
+    {0,132,0,0,0,135,0,0,0,133,0,0,0,0,0,136,0,0,0,0,0,134,0,0,0,348,0,0,0},
+    {0,137,0,0,0,140,0,0,0,138,0,0,0,0,0,141,0,0,342,0,0,139,0,0,0,35,0,0,0},
+    {0,142,0,0,0,145,0,0,46,143,0,0,0,0,0,146,0,0,0,0,0,144,0,346,0,0,0,0,0},
+    {0,147,0,0,0,150,0,0,0,148,0,0,0,0,0,151,0,0,0,0,0,149,0,0,0,0,0,0,0},
+    {0,152,0,0,0,155,0,0,0,153,0,0,0,0,0,156,0,0,0,0,0,154,0,0,0,0,0,0,0},
+    {0,161,0,0,0,164,0,0,0,162,0,0,0,0,0,165,0,0,0,0,0,163,0,0,0,0,0,0,0},
+    {0,170,0,0,0,173,0,0,0,171,0,0,0,0,0,174,0,0,0,0,0,172,0,0,0,0,0,0,0},
+    {0,175,0,0,0,178,0,0,0,176,0,0,0,0,0,179,0,0,0,0,0,177,0,0,0,0,0,0,0},
+    {0,184,0,0,0,187,0,0,0,185,0,0,0,0,0,188,0,0,0,0,0,186,0,0,0,0,0,0,0},
+    {0,189,0,0,0,192,0,0,0,190,0,0,0,0,0,193,0,0,0,0,0,191,0,0,0,0,0,0,0},
+    {0,194,0,0,0,197,0,0,0,195,0,0,0,0,0,198,0,0,0,0,0,196,0,0,0,0,0,0,0},
+    {0,199,0,0,0,202,0,0,0,200,0,0,0,0,0,203,0,0,0,0,0,201,0,0,0,0,0,0,0},
+    {0,204,0,0,0,207,0,0,0,205,0,0,0,0,0,208,0,0,0,0,0,206,0,0,0,0,0,0,0},
+    {0,209,0,0,0,212,0,0,0,210,0,0,0,0,0,213,0,0,0,0,0,211,0,0,0,0,0,0,0},
+    {0,214,0,0,0,217,0,0,0,215,0,0,0,0,0,218,0,0,0,0,0,216,0,0,0,0,0,0,0},
+    {0,219,0,0,0,222,0,0,0,220,0,0,0,0,0,223,0,0,0,0,0,221,0,0,0,0,0,0,0},
+    {0,224,0,0,0,227,0,0,0,225,0,0,0,0,0,228,0,0,0,0,0,226,0,0,0,0,0,0,0},
+    {0,233,0,0,0,0,0,0,0,0,0,0,0,0,0,235,0,0,0,0,0,234,0,0,0,0,0,0,0},
+    {0,236,0,0,0,239,0,0,0,237,0,0,0,0,0,240,0,0,0,0,0,238,345,0,0,38,0,0,0},
+    {0,241,0,0,0,0,0,0,0,0,0,0,0,0,0,243,0,0,0,0,0,242,0,0,0,0,0,0,0},
+    {0,244,0,0,0,247,0,0,0,245,0,0,0,0,0,248,0,341,0,0,0,246,0,0,0,0,0,0,0},
+    {0,249,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,250,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,255,0,0,0,258,0,0,0,256,0,0,0,0,0,259,0,0,0,0,0,257,0,0,0,0,0,0,0},
+    {0,260,0,0,0,263,0,0,0,261,0,0,0,0,0,264,0,0,0,0,0,262,0,0,0,0,0,0,0},
+    {0,265,0,0,0,268,0,0,0,266,0,0,0,0,0,269,0,0,0,0,0,267,0,0,0,0,0,0,0},
+    {0,270,0,0,0,273,0,0,0,271,0,0,0,0,0,274,0,0,0,0,0,272,0,0,0,0,0,0,0},
+    {0,275,0,0,0,278,0,0,0,276,0,0,0,0,0,279,0,0,0,0,0,277,0,0,0,0,0,0,0},
+    {0,280,0,0,0,283,0,0,0,281,0,57,0,0,309,284,0,0,0,0,51,282,0,55,347,49,0,0,0},
+    {0,285,0,0,0,288,0,0,0,286,0,58,338,0,0,289,0,0,0,0,53,287,0,56,0,50,0,0,0},
+    {0,290,0,0,0,0,0,0,0,0,0,0,0,0,0,292,0,0,0,0,0,291,0,0,0,0,0,0,0},
+    {0,293,0,0,0,0,0,0,0,0,0,0,0,0,0,295,0,0,0,0,0,294,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,52,0,296,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,297,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,54,0,298,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,299,0,0,0,0,0,0,0},
+    {0,300,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,301,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,302,0,0,0,304,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,303,0,0,0,305,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,0,0,0,0,0,0,0,350,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+};
+
+static const char *const romaji_hiragana[ROMAJI_STATE_COUNT] = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    "あ",
+    "い",
+    "う",
+    "え",
+    "お",
+    "か",
+    "き",
+    "く",
+    "け",
+    "こ",
+    "か",
+    "く",
+    "こ",
+    "が",
+    "ぎ",
+    "ぐ",
+    "げ",
+    "ご",
+    "さ",
+    "し",
+    "し",
+    "す",
+    "せ",
+    "そ",
+    "し",
+    "せ",
+    "ざ",
+    "じ",
+    "じ",
+    "ず",
+    "ぜ",
+    "ぞ",
+    "た",
+    "ち",
+    "ち",
+    "つ",
+    "つ",
+    "て",
+    "と",
+    "だ",
+    "ぢ",
+    "づ",
+    "で",
+    "ど",
+    "ぢ",
+    "づ",
+    "な",
+    "に",
+    "ぬ",
+    "ね",
+    "の",
+    "は",
+    "ひ",
+    "ふ",
+    "ふ",
+    "へ",
+    "ほ",
+    "ば",
+    "び",
+    "ぶ",
+    "べ",
+    "ぼ",
+    "ぱ",
+    "ぴ",
+    "ぷ",
+    "ぺ",
+    "ぽ",
+    "ま",
+    "み",
+    "む",
+    "め",
+    "も",
+    "や",
+    "い",
+    "ゆ",
+    "いぇ",
+    "よ",
+    "ら",
+    "り",
+    "る",
+    "れ",
+    "ろ",
+    "わ",
+    "うぃ",
+    "う",
+    "うぇ",
+    "を",
+    "きゃ",
+    "きぃ",
+    "きゅ",
+    "きぇ",
+    "きょ",
+    "ぎゃ",
+    "ぎぃ",
+    "ぎゅ",
+    "ぎぇ",
+    "ぎょ",
+    "しゃ",
+    "しゅ",
+    "しぇ",
+    "しょ",
+    "しゃ",
+    "しぃ",
+    "しゅ",
+    "しぇ",
+    "しょ",
+    "じゃ",
+    "じゅ",
+    "じぇ",
+    "じょ",
+    "じゃ",
+    "じぃ",
+    "じゅ",
+    "じぇ",
+    "じょ",
+    "じゃ",
+    "じぃ",
+    "じゅ",
+    "じぇ",
+    "じょ",
+    "ちゃ",
+    "ちゅ",
+    "ちぇ",
+    "ちょ",
+    "ちゃ",
+    "ちぃ",
+    "ちゅ",
+    "ちぇ",
+    "ちょ",
+    "ちゃ",
+    "ちぃ",
+    "ちゅ",
+    "ちぇ",
+    "ちょ",
+    "ぢゃ",
+    "ぢぃ",
+    "ぢゅ",
+    "ぢぇ",
+    "ぢょ",
+    "にゃ",
+    "にぃ",
+    "にゅ",
+    "にぇ",
+    "にょ",
+    "ひゃ",
+    "ひぃ",
+    "ひゅ",
+    "ひぇ",
+    "ひょ",
+    "びゃ",
+    "びぃ",
+    "びゅ",
+    "びぇ",
+    "びょ",
+    "ぴゃ",
+    "ぴぃ",
+    "ぴゅ",
+    "ぴぇ",
+    "ぴょ",
+    "みゃ",
+    "みぃ",
+    "みゅ",
+    "みぇ",
+    "みょ",
+    "りゃ",
+    "りぃ",
+    "りゅ",
+    "りぇ",
+    "りょ",
+    "ふぁ",
+    "ふぃ",
+    "ふぇ",
+    "ふぉ",
+    "ふゃ",
+    "ふゅ",
+    "ふょ",
+    "ゔぁ",
+    "ゔぃ",
+    "ゔ",
+    "ゔぇ",
+    "ゔぉ",
+    "ゔゃ",
+    "ゔゅ",
+    "ゔょ",
+    "くぁ",
+    "くぃ",
+    "く",
+    "くぇ",
+    "くぉ",
+    "くぁ",
+    "ぐぁ",
+    "つぁ",
+    "つぃ",
+    "つぇ",
+    "つぉ",
+    "てゃ",
+    "てぃ",
+    "てゅ",
+    "てぇ",
+    "てょ",
+    "とぁ",
+    "とぃ",
+    "とぅ",
+    "とぇ",
+    "とぉ",
+    "でゃ",
+    "でぃ",
+    "でゅ",
+    "でぇ",
+    "でょ",
+    "どぁ",
+    "どぃ",
+    "どぅ",
+    "どぇ",
+    "どぉ",
+    "うぁ",
+    "うぃ",
+    "う",
+    "うぇ",
+    "うぉ",
+    "ぁ",
+    "ぃ",
+    "ぅ",
+    "ぇ",
+    "ぉ",
+    "ぁ",
+    "ぃ",
+    "ぅ",
+    "ぇ",
+    "ぉ",
+    "ゃ",
+    "ゅ",
+    "ょ",
+    "ゃ",
+    "ゅ",
+    "ょ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "ゎ",
+    "ゎ",
+    "ゕ",
+    "ゕ",
+    "ゖ",
+    "ゖ",
+    "ー",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "ん",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+    "っ",
+};
+
+static const char *const romaji_katakana[ROMAJI_STATE_COUNT] = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    "ア",
+    "イ",
+    "ウ",
+    "エ",
+    "オ",
+    "カ",
+    "キ",
+    "ク",
+    "ケ",
+    "コ",
+    "カ",
+    "ク",
+    "コ",
+    "ガ",
+    "ギ",
+    "グ",
+    "ゲ",
+    "ゴ",
+    "サ",
+    "シ",
+    "シ",
+    "ス",
+    "セ",
+    "ソ",
+    "シ",
+    "セ",
+    "ザ",
+    "ジ",
+    "ジ",
+    "ズ",
+    "ゼ",
+    "ゾ",
+    "タ",
+    "チ",
+    "チ",
+    "ツ",
+    "ツ",
+    "テ",
+    "ト",
+    "ダ",
+    "ヂ",
+    "ヅ",
+    "デ",
+    "ド",
+    "ヂ",
+    "ヅ",
+    "ナ",
+    "ニ",
+    "ヌ",
+    "ネ",
+    "ノ",
+    "ハ",
+    "ヒ",
+    "フ",
+    "フ",
+    "ヘ",
+    "ホ",
+    "バ",
+    "ビ",
+    "ブ",
+    "ベ",
+    "ボ",
+    "パ",
+    "ピ",
+    "プ",
+    "ペ",
+    "ポ",
+    "マ",
+    "ミ",
+    "ム",
+    "メ",
+    "モ",
+    "ヤ",
+    "イ",
+    "ユ",
+    "イェ",
+    "ヨ",
+    "ラ",
+    "リ",
+    "ル",
+    "レ",
+    "ロ",
+    "ワ",
+    "ウィ",
+    "ウ",
+    "ウェ",
+    "ヲ",
+    "キャ",
+    "キィ",
+    "キュ",
+    "キェ",
+    "キョ",
+    "ギャ",
+    "ギィ",
+    "ギュ",
+    "ギェ",
+    "ギョ",
+    "シャ",
+    "シュ",
+    "シェ",
+    "ショ",
+    "シャ",
+    "シィ",
+    "シュ",
+    "シェ",
+    "ショ",
+    "ジャ",
+    "ジュ",
+    "ジェ",
+    "ジョ",
+    "ジャ",
+    "ジィ",
+    "ジュ",
+    "ジェ",
+    "ジョ",
+    "ジャ",
+    "ジィ",
+    "ジュ",
+    "ジェ",
+    "ジョ",
+    "チャ",
+    "チュ",
+    "チェ",
+    "チョ",
+    "チャ",
+    "チィ",
+    "チュ",
+    "チェ",
+    "チョ",
+    "チャ",
+    "チィ",
+    "チュ",
+    "チェ",
+    "チョ",
+    "ヂャ",
+    "ヂィ",
+    "ヂュ",
+    "ヂェ",
+    "ヂョ",
+    "ニャ",
+    "ニィ",
+    "ニュ",
+    "ニェ",
+    "ニョ",
+    "ヒャ",
+    "ヒィ",
+    "ヒュ",
+    "ヒェ",
+    "ヒョ",
+    "ビャ",
+    "ビィ",
+    "ビュ",
+    "ビェ",
+    "ビョ",
+    "ピャ",
+    "ピィ",
+    "ピュ",
+    "ピェ",
+    "ピョ",
+    "ミャ",
+    "ミィ",
+    "ミュ",
+    "ミェ",
+    "ミョ",
+    "リャ",
+    "リィ",
+    "リュ",
+    "リェ",
+    "リョ",
+    "ファ",
+    "フィ",
+    "フェ",
+    "フォ",
+    "フャ",
+    "フュ",
+    "フョ",
+    "ヴァ",
+    "ヴィ",
+    "ヴ",
+    "ヴェ",
+    "ヴォ",
+    "ヴャ",
+    "ヴュ",
+    "ヴョ",
+    "クァ",
+    "クィ",
+    "ク",
+    "クェ",
+    "クォ",
+    "クァ",
+    "グァ",
+    "ツァ",
+    "ツィ",
+    "ツェ",
+    "ツォ",
+    "テャ",
+    "ティ",
+    "テュ",
+    "テェ",
+    "テョ",
+    "トァ",
+    "トィ",
+    "トゥ",
+    "トェ",
+    "トォ",
+    "デャ",
+    "ディ",
+    "デュ",
+    "デェ",
+    "デョ",
+    "ドァ",
+    "ドィ",
+    "ドゥ",
+    "ドェ",
+    "ドォ",
+    "ウァ",
+    "ウィ",
+    "ウ",
+    "ウェ",
+    "ウォ",
+    "ァ",
+    "ィ",
+    "ゥ",
+    "ェ",
+    "ォ",
+    "ァ",
+    "ィ",
+    "ゥ",
+    "ェ",
+    "ォ",
+    "ャ",
+    "ュ",
+    "ョ",
+    "ャ",
+    "ュ",
+    "ョ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ヮ",
+    "ヮ",
+    "ヵ",
+    "ヵ",
+    "ヶ",
+    "ヶ",
+    "ー",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ン",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+    "ッ",
+};
+
+static const char *const *const romaji_kana[2] = {romaji_hiragana, romaji_katakana};
+
+static const unsigned char romaji_kana_len[ROMAJI_STATE_COUNT] = {
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    6,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    6,
+    3,
+    6,
+    3,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    3,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    3,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    6,
+    3,
+    6,
+    6,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+    3,
+};
+
+static const unsigned char romaji_rest[ROMAJI_STATE_COUNT] = {
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    1,
+    2,
+};
+
+static const char *const romaji_final_hiragana[ROMAJI_PREFIX_COUNT] = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    "ん",
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+static const char *const romaji_final_katakana[ROMAJI_PREFIX_COUNT] = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    "ン",
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+static const char *const *const romaji_final_kana[2] = {romaji_final_hiragana, romaji_final_katakana};
+
+#endif
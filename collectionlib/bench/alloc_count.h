@@ -0,0 +1,8 @@
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+// Counts heap allocations made by the process, including those made inside
+// libc (strdup) and sqlite, by interposing malloc/calloc/realloc.
+unsigned long alloc_count(void);
+
+#endif
@@ -0,0 +1,100 @@
+// Startup latency: blocking setup_collection vs. loading on a thread and
+// starting once the first cards are published, across deck sizes
+//
+// Usage: async_bench [work_dir] [max_notes]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/async_load.h"
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_MAX_NOTES 200000
+#define FIRST_CARDS 64      // what the game needs before it starts spawning
+#define RUNS 5
+
+typedef struct {
+    double start_ms;        // until collection_load_start returns
+    double first_ms;        // until FIRST_CARDS are published
+    double full_ms;         // until collection_load_finish returns
+} AsyncTimes;
+
+static void game_options(CollectionOptions *options) {
+    collection_default_options(options);
+    options->include_subdecks = 1;
+    options->load_schedule = 1;
+}
+
+static double best_blocking_ms(const char *path) {
+    CollectionOptions options;
+    double best = 0;
+
+    game_options(&options);
+    for (int run = 0; run < RUNS; run++) {
+        double start = now_ms();
+        CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, &options);
+        double elapsed = now_ms() - start;
+
+        if (!collection) return -1;
+        delete_collection(collection);
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+static int best_async(const char *path, AsyncTimes *best) {
+    CollectionOptions options;
+
+    game_options(&options);
+    for (int run = 0; run < RUNS; run++) {
+        AsyncTimes times;
+        double start = now_ms();
+
+        CollectionLoad *load = collection_load_start(path, SYNTH_DECK_NAME, &options);
+        if (!load) return -1;
+        times.start_ms = now_ms() - start;
+
+        collection_load_wait(load, FIRST_CARDS);
+        times.first_ms = now_ms() - start;
+
+        CardCollection *collection = collection_load_finish(load);
+        times.full_ms = now_ms() - start;
+        if (!collection) return -1;
+        delete_collection(collection);
+
+        if (run == 0 || times.first_ms < best->first_ms) best->first_ms = times.first_ms;
+        if (run == 0 || times.start_ms < best->start_ms) best->start_ms = times.start_ms;
+        if (run == 0 || times.full_ms < best->full_ms) best->full_ms = times.full_ms;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int max_notes = argc > 2 ? atoi(argv[2]) : DEFAULT_MAX_NOTES;
+    const int sizes[] = {1000, 10000, 50000, 200000};
+    char path[512];
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    if (max_notes <= 0) max_notes = DEFAULT_MAX_NOTES;
+
+    printf("%8s %12s | %10s %12s %10s\n", "notes", "blocking", "async start",
+           "first cards", "full load");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= max_notes; i++) {
+        AsyncTimes times;
+
+        snprintf(path, sizeof(path), "%s/anki_synth_%d.anki2", dir, sizes[i]);
+        if (synth_deck_ensure(path, sizes[i]) < 0) return 1;
+
+        double blocking_ms = best_blocking_ms(path);
+        if (blocking_ms < 0 || best_async(path, &times) < 0) return 1;
+
+        printf("%8d %9.2f ms | %8.3f ms %9.2f ms %7.2f ms\n", sizes[i], blocking_ms,
+               times.start_ms, times.first_ms, times.full_ms);
+    }
+    printf("\nThe window can open after \"async start\"; spawning begins after \"first cards\"\n");
+    return 0;
+}
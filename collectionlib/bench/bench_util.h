@@ -0,0 +1,14 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+// Monotonic clock in milliseconds
+double now_ms(void);
+
+// Resident set size in KiB, from /proc/self/statm
+long rss_kib(void);
+
+// Send stdout to /dev/null; returns a handle for restore_stdout
+int mute_stdout(void);
+void restore_stdout(int saved);
+
+#endif
@@ -0,0 +1,89 @@
+// Deck resolution: full decks-table scan with console output vs. the
+// indexed, prepared lookups in deck.c
+//
+// Usage: deck_bench [work_dir] [lookups]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "../include/deck.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_LOOKUPS 2000
+
+// The original find_deck_by_name: print every deck, compare names in C
+static long long legacy_find_deck(sqlite3 *db, const char *target) {
+    sqlite3_stmt *stmt;
+    long long ret = 0;
+
+    printf("\n=== QUERYING DECKS TABLE ===\n");
+    if (sqlite3_prepare_v2(db, "SELECT id, name, mtime_secs, usn FROM decks;", -1, &stmt, NULL) != SQLITE_OK) {
+        return 0;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        long long id = sqlite3_column_int64(stmt, 0);
+        const char *name = (const char*)sqlite3_column_text(stmt, 1);
+        if (!name) continue;
+
+        printf("Deck ID: %lld\nDeck Name: %s\nModified Time: %lld\nUSN: %d\n---\n",
+               id, name, (long long)sqlite3_column_int64(stmt, 2), sqlite3_column_int(stmt, 3));
+        if (strcmp(name, target) == 0) ret = id;
+    }
+    sqlite3_finalize(stmt);
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int lookups = argc > 2 ? atoi(argv[2]) : DEFAULT_LOOKUPS;
+    char path[512];
+    CardCollection collection;
+    DeckInfo info;
+    DeckList list;
+    long long found = 0;
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    if (lookups <= 0) lookups = DEFAULT_LOOKUPS;
+    snprintf(path, sizeof(path), "%s/anki_synth_%d.anki2", dir, 1000);
+    if (synth_deck_ensure(path, 1000) < 0) return 1;
+
+    memset(&collection, 0, sizeof(collection));
+    if (sqlite3_open_v2(path, &collection.db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) return 1;
+    register_anki_collations(collection.db);
+
+    // Console output goes to /dev/null here; a real terminal is far slower
+    double start = now_ms();
+    for (int i = 0; i < lookups; i++) found += legacy_find_deck(collection.db, SYNTH_DECK_NAME);
+    double legacy_ms = now_ms() - start;
+
+    start = now_ms();
+    for (int i = 0; i < lookups; i++) {
+        if (deck_find(&collection, SYNTH_DECK_NAME, &info) == 0) found += info.id;
+    }
+    double indexed_ms = now_ms() - start;
+
+    start = now_ms();
+    for (int i = 0; i < lookups; i++) {
+        deck_list_init(&list);
+        found += deck_find_with_children(&collection, SYNTH_DECK_NAME, &list);
+        deck_list_free(&list);
+    }
+    double children_ms = now_ms() - start;
+
+    deck_list_init(&list);
+    int total = deck_list_all(&collection, &list);
+    deck_list_free(&list);
+
+    printf("%d decks, %d lookups\n", total, lookups);
+    printf("%-26s %10.2f us/lookup\n", "scan + printf", legacy_ms * 1000.0 / lookups);
+    printf("%-26s %10.2f us/lookup\n", "deck_find", indexed_ms * 1000.0 / lookups);
+    printf("%-26s %10.2f us/lookup\n", "deck_find_with_children", children_ms * 1000.0 / lookups);
+
+    deck_finalize_statements(&collection);
+    sqlite3_close(collection.db);
+    return found == 0;
+}
@@ -0,0 +1,119 @@
+// Benchmark: strstr-based first-meaning extraction vs. the streaming
+// glossary extractor, on large Yomitan-generated meaning fields
+//
+// Usage: html_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/html.h"
+
+#define DEFAULT_ITERATIONS 20000
+#define NOTE_BUFFER_SIZE (64 * 1024)
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// The original extractor: three strstr scans and a heap copy
+static char* legacy_extract(const char *html_str) {
+    const char *glossary_start = strstr(html_str, "yomitan-glossary");
+    if (!glossary_start) return strdup(html_str);
+
+    const char *first_div = strstr(glossary_start, "<div>");
+    if (!first_div) return NULL;
+    first_div += 5;
+
+    const char *div_end = strstr(first_div, "</div>");
+    if (!div_end) return NULL;
+
+    size_t content_len = div_end - first_div;
+    char *result = malloc(content_len + 1);
+    if (result) {
+        memcpy(result, first_div, content_len);
+        result[content_len] = '\0';
+    }
+    return result;
+}
+
+// A Yomitan note with pitch/frequency blocks before the glossary and several
+// dictionaries of structured content inside it
+static size_t build_note(char *buf, size_t size, int preamble_blocks, int dictionaries) {
+    size_t len = 0;
+
+    for (int i = 0; i < preamble_blocks; i++) {
+        len += snprintf(buf + len, size - len,
+                        "<div class=\"yomitan-frequency\" data-dictionary=\"JPDB %d\">"
+                        "<span style=\"font-weight: bold;\">%d</span> &#x2605; &middot; "
+                        "<ruby>食<rt>た</rt></ruby>べる</div>", i, 1000 + i);
+    }
+
+    len += snprintf(buf + len, size - len,
+                    "<div style=\"text-align: left;\" class=\"yomitan-glossary\"><ol>");
+    for (int d = 0; d < dictionaries && len < size - 1024; d++) {
+        len += snprintf(buf + len, size - len,
+                        "<li data-dictionary=\"Dict %d\"><i>(v1, vt, Dict %d)</i> <span><ul>", d, d);
+        for (int e = 0; e < 6; e++) {
+            len += snprintf(buf + len, size - len,
+                            "<li><div data-sc-content=\"glossary\" style=\"margin-left: 0.5em;\">"
+                            "sense %d.%d: to eat &amp; drink <span class=\"tag\">(colloq)</span>"
+                            "</div></li>", d, e);
+        }
+        len += snprintf(buf + len, size - len, "</ul></span></li>");
+    }
+    len += snprintf(buf + len, size - len, "</ol></div>");
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    static char note[NOTE_BUFFER_SIZE];
+    char out[1024];
+    volatile size_t sink = 0;
+    const struct { int preamble, dictionaries; } shapes[] = {{0, 1}, {4, 5}, {20, 20}};
+
+    if (iterations <= 0) iterations = DEFAULT_ITERATIONS;
+
+    printf("%-10s %12s %10s %12s %12s %12s\n",
+           "bytes", "strstr ns", "strstr ok", "stream(1) ns", "stream(3) ns", "MB/s(3)");
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        size_t len = build_note(note, sizeof(note), shapes[s].preamble, shapes[s].dictionaries);
+
+        int legacy_ok = 0;
+        double start = now_ns();
+        for (long i = 0; i < iterations; i++) {
+            char *meaning = legacy_extract(note);
+            if (meaning) {
+                sink += meaning[0];
+                legacy_ok = 1;
+            }
+            free(meaning);
+        }
+        double legacy_ns = (now_ns() - start) / iterations;
+
+        start = now_ns();
+        for (long i = 0; i < iterations; i++) {
+            sink += html_extract_glossary(note, len, 1, out, sizeof(out));
+        }
+        double first_ns = (now_ns() - start) / iterations;
+
+        start = now_ns();
+        for (long i = 0; i < iterations; i++) {
+            sink += html_extract_glossary(note, len, 3, out, sizeof(out));
+        }
+        double three_ns = (now_ns() - start) / iterations;
+
+        // The strstr version only matches a bare "<div>", so attribute-bearing
+        // entries make it fail after scanning the whole field
+        printf("%-10zu %12.1f %10s %12.1f %12.1f %12.1f\n",
+               len, legacy_ns, legacy_ok ? "yes" : "no", first_ns, three_ns, len / three_ns * 1e3);
+    }
+
+    html_extract_glossary(note, strlen(note), 3, out, sizeof(out));
+    printf("first three entries: %s\n", out);
+    return sink == 0;
+}
@@ -0,0 +1,48 @@
+// Load-time and memory benchmark for setup_collection on synthetic decks
+//
+// Usage: load_bench [work_dir]
+// Synthetic collections of 1k/10k/100k notes are generated on first run.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    const int sizes[] = {1000, 10000, 100000};
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    printf("%-8s %8s %10s %12s %12s %10s\n",
+           "notes", "cards", "load ms", "us/card", "arena KiB", "rss KiB");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/anki_synth_%d.anki2", dir, sizes[i]);
+
+        if (synth_deck_ensure(path, sizes[i]) < 0) return 1;
+
+        long rss_before = rss_kib();
+        double start = now_ms();
+        CardCollection *collection = setup_collection(path, SYNTH_DECK_NAME);
+        double elapsed = now_ms() - start;
+        long rss_after = rss_kib();
+
+        if (!collection) {
+            fprintf(stderr, "Failed to load %s\n", path);
+            return 1;
+        }
+
+        int count = collection_count(collection);
+        printf("%-8d %8d %10.1f %12.2f %12zu %10ld\n",
+               sizes[i], count, elapsed, count ? elapsed * 1000.0 / count : 0.0,
+               collection->strings.total_bytes / 1024, rss_after - rss_before);
+
+        delete_collection(collection);
+    }
+
+    return 0;
+}
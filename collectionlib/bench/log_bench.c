@@ -0,0 +1,94 @@
+// Cost of collectionlib logging on a 10k-note load
+//
+// Usage: log_bench [work_dir] [notes]
+// Debug output goes to /dev/null, so the numbers show formatting and write
+// cost without a terminal in the way; a real console is slower still.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_NOTES 10000
+#define RUNS 5
+
+static long sink_messages;
+
+static void count_sink(CollectionLogLevel level, const char *message, void *user_data) {
+    (void)level;
+    (void)message;
+    (void)user_data;
+    sink_messages++;
+}
+
+static double best_load_ms(const char *path, int *count) {
+    CollectionOptions options;
+    double best = 0;
+
+    // Serial so the numbers reflect logging, not scheduling
+    collection_default_options(&options);
+    options.threads = 1;
+
+    for (int run = 0; run < RUNS; run++) {
+        int saved = mute_stdout();
+        double start = now_ms();
+        CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, &options);
+        double elapsed = now_ms() - start;
+        restore_stdout(saved);
+
+        if (!collection) return -1;
+        *count = collection_count(collection);
+        delete_collection(collection);
+
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int notes = argc > 2 ? atoi(argv[2]) : DEFAULT_NOTES;
+    const struct {
+        const char *name;
+        CollectionLogLevel level;
+        CollectionLogSink sink;
+    } modes[] = {
+        {"silent", COLLECTION_LOG_SILENT, NULL},
+        {"info", COLLECTION_LOG_INFO, NULL},
+        {"debug", COLLECTION_LOG_DEBUG, NULL},
+        {"debug+sink", COLLECTION_LOG_DEBUG, count_sink},
+    };
+    char path[512];
+    double silent = 0;
+
+    if (notes <= 0) notes = DEFAULT_NOTES;
+    snprintf(path, sizeof(path), "%s/anki_synth_%d.anki2", dir, notes);
+    if (synth_deck_ensure(path, notes) < 0) return 1;
+
+    // Warm the page cache so the first mode is not penalised
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    int warm_count = 0;
+    if (best_load_ms(path, &warm_count) < 0) return 1;
+
+    printf("%-12s %8s %10s %10s\n", "level", "cards", "load ms", "vs silent");
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        int count = 0;
+
+        collection_set_log_level(modes[i].level);
+        collection_set_log_sink(modes[i].sink, NULL);
+        double ms = best_load_ms(path, &count);
+        collection_set_log_sink(NULL, NULL);
+
+        if (ms < 0) {
+            fprintf(stderr, "Failed to load %s\n", path);
+            return 1;
+        }
+        if (i == 0) silent = ms;
+        printf("%-12s %8d %10.1f %9.2fx\n", modes[i].name, count, ms, ms / silent);
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Serial vs. pipelined deck loading on a 100k-note synthetic collection
+//
+// Usage: parallel_bench [work_dir] [notes]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_NOTES 100000
+#define RUNS 3
+
+static double best_load_ms(const char *path, int threads, int *count) {
+    CollectionOptions options;
+    double best = 0;
+
+    collection_default_options(&options);
+    options.threads = threads;
+
+    for (int run = 0; run < RUNS; run++) {
+        double start = now_ms();
+        CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, &options);
+        double elapsed = now_ms() - start;
+
+        if (!collection) return -1;
+        *count = collection_count(collection);
+        delete_collection(collection);
+
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int notes = argc > 2 ? atoi(argv[2]) : DEFAULT_NOTES;
+    const int thread_counts[] = {1, 2, 4, 8};
+    char path[512];
+    double serial = 0;
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    if (notes <= 0) notes = DEFAULT_NOTES;
+    snprintf(path, sizeof(path), "%s/anki_synth_%d.anki2", dir, notes);
+    if (synth_deck_ensure(path, notes) < 0) return 1;
+
+    printf("%-8s %8s %10s %8s\n", "threads", "cards", "load ms", "speedup");
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        int count = 0;
+        double ms = best_load_ms(path, thread_counts[i], &count);
+        if (ms < 0) {
+            fprintf(stderr, "Failed to load %s\n", path);
+            return 1;
+        }
+        if (i == 0) serial = ms;
+        printf("%-8d %8d %10.1f %7.2fx\n", thread_counts[i], count, ms, serial / ms);
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+// Microbenchmark: strdup+strtok_r field parsing vs. the zero-copy parser
+//
+// The legacy rows keep the original first-<div> substring as the meaning;
+// the "+ html_extract" row runs the legacy split with the same glossary
+// extraction as parse_card_fields, so those two compare like for like.
+//
+// Usage: parse_bench [corpus_file] [iterations]
+// The corpus holds one note per line with fields separated by 0x1F, e.g.
+//   sqlite3 collection.anki2 "SELECT flds FROM notes" > corpus.txt
+// Without a corpus, a built-in set of Yomitan-exported notes is used.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/card.h"
+#include "alloc_count.h"
+
+#define DEFAULT_ITERATIONS 200000
+#define MAX_CORPUS 100000
+
+static const char *builtin_corpus[] = {
+    "食べる\x1fたべる\x1f<div style=\"text-align: left;\" class=\"yomitan-glossary\"><ol>"
+    "<li data-dictionary=\"JMdict\"><i>(v1, vt, JMdict)</i> <span><ul><li><div>to eat</div></li>"
+    "<li><div>to live on (e.g. a salary)</div></li></ul></span></li></ol></div>"
+    "\x1f食[た]べる\x1f[sound:yomitan_ja_食べる.mp3]\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f",
+    "勉強\x1fべんきょう\x1f<div class=\"yomitan-glossary\" style=\"text-align: left;\"><ol>"
+    "<li data-dictionary=\"JMdict\"><i>(n, vs, vt, JMdict)</i> <span><ul><li><div>study</div></li>"
+    "<li><div>diligence; working hard</div></li><li><div>experience; lesson</div></li>"
+    "</ul></span></li></ol></div>\x1f勉強[べんきょう]\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f",
+    "  電車  \x1f でんしゃ \x1ftrain; electric train\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f",
+    "天気\x1fてんき\x1f<div class=\"yomitan-glossary\"><div>weather</div><div>fair weather</div></div>"
+    "\x1f天気[てんき]\x1f<img src=\"tenki.jpg\">\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f",
+};
+#define BUILTIN_COUNT (int)(sizeof(builtin_corpus) / sizeof(builtin_corpus[0]))
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// The original parser: copy, tokenize every field, strdup the first three
+static char* legacy_extract_meaning(const char *html_str) {
+    const char *glossary_start = strstr(html_str, "yomitan-glossary");
+    if (!glossary_start) return strdup(html_str);
+
+    const char *first_div = strstr(glossary_start, "<div>");
+    if (!first_div) return NULL;
+    first_div += 5;
+
+    const char *div_end = strstr(first_div, "</div>");
+    if (!div_end) return NULL;
+
+    size_t content_len = div_end - first_div;
+    char *result = malloc(content_len + 1);
+    if (result) {
+        memcpy(result, first_div, content_len);
+        result[content_len] = '\0';
+    }
+    return result;
+}
+
+// The legacy split, but with the meaning extracted as parse_card_fields does
+static char* html_extract_meaning(const char *html_str) {
+    char meaning[MEANING_BUFFER_SIZE];
+    int len = html_extract_glossary(html_str, strlen(html_str), MEANING_ENTRIES, meaning,
+                                    sizeof(meaning));
+    return len < 0 ? NULL : strndup(meaning, len);
+}
+
+static int legacy_parse(const char *fields_str, char **out, char *(*extract)(const char *)) {
+    char *fields_copy = strdup(fields_str);
+    char *saveptr;
+    int field_index = 0;
+
+    out[0] = out[1] = out[2] = NULL;
+    for (char *token = strtok_r(fields_copy, "\x1f", &saveptr);
+         token != NULL && field_index < 13;
+         token = strtok_r(NULL, "\x1f", &saveptr), field_index++) {
+        while (*token && isspace((unsigned char)*token)) token++;
+        char *end = token + strlen(token) - 1;
+        while (end > token && isspace((unsigned char)*end)) *end-- = '\0';
+
+        if (field_index < 2) out[field_index] = strdup(token);
+        else if (field_index == 2) out[2] = extract(token);
+    }
+    free(fields_copy);
+    return (out[0] && out[1] && out[2]) ? 0 : -1;
+}
+
+static int load_corpus(const char *path, char ***notes) {
+    static char line[65536];
+    int count = 0;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open corpus %s\n", path);
+        return -1;
+    }
+
+    *notes = malloc(MAX_CORPUS * sizeof(char *));
+    while (count < MAX_CORPUS && fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\n")] = '\0';
+        if (line[0]) (*notes)[count++] = strdup(line);
+    }
+    fclose(f);
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    char **notes = (char **)builtin_corpus;
+    int note_count = BUILTIN_COUNT;
+    long iterations = argc > 2 ? atol(argv[2]) : DEFAULT_ITERATIONS;
+    volatile size_t sink = 0;
+
+    if (argc > 1 && (note_count = load_corpus(argv[1], &notes)) <= 0) return 1;
+    if (iterations <= 0) iterations = DEFAULT_ITERATIONS;
+
+    size_t *lengths = malloc(note_count * sizeof(size_t));
+    for (int i = 0; i < note_count; i++) lengths[i] = strlen(notes[i]);
+
+    // Legacy paths: the original extractor, then the full one
+    double legacy_ns[2], legacy_allocs[2];
+    char *(*extractors[2])(const char *) = {legacy_extract_meaning, html_extract_meaning};
+    for (int e = 0; e < 2; e++) {
+        unsigned long allocs = alloc_count();
+        double start = now_ns();
+        for (long i = 0; i < iterations; i++) {
+            char *out[3];
+            if (legacy_parse(notes[i % note_count], out, extractors[e]) == 0) sink += strlen(out[2]);
+            free(out[0]);
+            free(out[1]);
+            free(out[2]);
+        }
+        legacy_ns[e] = (now_ns() - start) / iterations;
+        legacy_allocs[e] = (double)(alloc_count() - allocs) / iterations;
+    }
+
+    // Zero-copy split + arena copies; the arena is reset every 4096 notes
+    StringArena arena;
+    arena_init(&arena, ARENA_DEFAULT_BLOCK_SIZE);
+    unsigned long allocs = alloc_count();
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        CardData card;
+        int n = i % note_count;
+        if (parse_card_fields(notes[n], lengths[n], &card, &arena) == 0) sink += card.word[0];
+        if ((i & 4095) == 4095) arena_free(&arena);
+    }
+    double arena_ns = (now_ns() - start) / iterations;
+    double arena_allocs = (double)(alloc_count() - allocs) / iterations;
+    arena_free(&arena);
+
+    // Views only, no copies at all
+    allocs = alloc_count();
+    start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        CardFieldViews views;
+        char meaning[MEANING_BUFFER_SIZE];
+        int n = i % note_count;
+        if (split_card_fields(notes[n], lengths[n], &views) == 0) {
+            sink += html_extract_glossary(views.meaning.ptr, views.meaning.len,
+                                          MEANING_ENTRIES, meaning, sizeof(meaning));
+        }
+    }
+    double view_ns = (now_ns() - start) / iterations;
+    double view_allocs = (double)(alloc_count() - allocs) / iterations;
+
+    printf("corpus: %d notes, %ld iterations\n", note_count, iterations);
+    printf("%-22s %10s %14s\n", "parser", "ns/note", "allocs/note");
+    printf("%-22s %10.1f %14.3f\n", "strdup+strtok_r", legacy_ns[0], legacy_allocs[0]);
+    printf("%-22s %10.1f %14.3f\n", "  + html_extract", legacy_ns[1], legacy_allocs[1]);
+    printf("%-22s %10.1f %14.3f\n", "parse_card_fields", arena_ns, arena_allocs);
+    printf("%-22s %10.1f %14.3f\n", "split+html_extract", view_ns, view_allocs);
+
+    free(lengths);
+    return sink == 0;
+}
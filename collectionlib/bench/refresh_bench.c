@@ -0,0 +1,177 @@
+// Picking up edits made in Anki while the game runs: a full reload vs.
+// collection_refresh, which reads only the rows changed since the last one
+//
+// Each round edits some notes, reviews some cards, adds a few notes, deletes
+// two cards and moves one to another deck, the way Anki writes them (mod =
+// now, usn = -1, a grave per deleted card), then refreshes. Rounds land in
+// the same second, and rows stamped with the second of the last refresh are
+// read again, so later rounds also re-read the earlier ones: an upper bound.
+//
+// Usage: refresh_bench [work_dir] [notes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "../include/refresh.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_NOTES 50000
+#define RUNS 3
+#define ROUNDS 10
+#define EDITED_NOTES 20
+#define REVIEWED_CARDS 20
+#define ADDED_NOTES 5
+#define DELETED_CARDS 2
+#define NOTE_ID_BASE 1600000000000LL    // as synth_deck; a note's card id is its id + 1
+#define ADDED_ID_BASE 1650000000000LL
+
+static void game_options(CollectionOptions *options) {
+    collection_default_options(options);
+    options->include_subdecks = 1;
+    options->load_schedule = 1;
+}
+
+static int exec_bound(sqlite3 *db, const char *sql, long long a, long long b, const char *text) {
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Edit failed: %s\n", sqlite3_errmsg(db));
+        return -1;
+    }
+    sqlite3_bind_int64(stmt, 1, a);
+    sqlite3_bind_int64(stmt, 2, b);
+    if (text) sqlite3_bind_text(stmt, 3, text, -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt) == SQLITE_DONE ? 0 : -1;
+    sqlite3_finalize(stmt);
+    return rc;
+}
+
+// One round of changes, on a connection of its own as Anki would have
+static int edit_collection(sqlite3 *db, int notes, int round) {
+    long long now = (long long)time(NULL);
+    char fields[256];
+    int rc = 0;
+
+    sqlite3_exec(db, "BEGIN;", NULL, NULL, NULL);
+    for (int k = 0; k < EDITED_NOTES && rc == 0; k++) {
+        long long note_id = NOTE_ID_BASE + (round * 37 + k * 997) % (notes / 2);
+        snprintf(fields, sizeof(fields), "編集%d\x1fへんしゅう\x1f<div>edited %d.%d</div>\x1f\x1f",
+                 round, round, k);
+        rc = exec_bound(db, "UPDATE notes SET mod = ?1, usn = -1, flds = ?3 WHERE id = ?2;",
+                        now, note_id, fields);
+    }
+    for (int k = 0; k < REVIEWED_CARDS && rc == 0; k++) {
+        long long card_id = NOTE_ID_BASE + 1 + (round * 53 + k * 1009) % (notes / 2);
+        rc = exec_bound(db, "UPDATE cards SET mod = ?1, usn = -1, reps = reps + 1 WHERE id = ?2;",
+                        now, card_id, NULL);
+    }
+    for (int k = 0; k < ADDED_NOTES && rc == 0; k++) {
+        long long note_id = ADDED_ID_BASE + round * ADDED_NOTES + k;
+        snprintf(fields, sizeof(fields), "新語%d\x1fしんご\x1f<div>added %d.%d</div>\x1f\x1f",
+                 k, round, k);
+        rc = exec_bound(db, "INSERT INTO notes VALUES (?2, 'n' || ?2, 1, ?1, -1, '', ?3, 0, 0, 0, '');",
+                        now, note_id, fields);
+        if (rc == 0) {
+            rc = exec_bound(db, "INSERT INTO cards VALUES (?2 + 1, ?2, 1700000000000, 0, ?1, -1, "
+                                "0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '');", now, note_id, NULL);
+        }
+    }
+    for (int k = 0; k < DELETED_CARDS && rc == 0; k++) {
+        long long card_id = NOTE_ID_BASE + 1 + notes - 1 - round * DELETED_CARDS - k;
+        rc = exec_bound(db, "DELETE FROM cards WHERE id = ?2;", now, card_id, NULL);
+        if (rc == 0) {
+            rc = exec_bound(db, "INSERT INTO graves VALUES (-1, ?2, 0);", now, card_id, NULL);
+        }
+    }
+    if (rc == 0) {
+        long long card_id = NOTE_ID_BASE + 1 + notes / 2 + round;
+        rc = exec_bound(db, "UPDATE cards SET mod = ?1, usn = -1, did = did + 1 WHERE id = ?2;",
+                        now, card_id, NULL);
+    }
+    sqlite3_exec(db, rc == 0 ? "COMMIT;" : "ROLLBACK;", NULL, NULL, NULL);
+    return rc;
+}
+
+static double best_reload_ms(const char *path, const CollectionOptions *options) {
+    double best = 0;
+    for (int run = 0; run < RUNS; run++) {
+        double start = now_ms();
+        CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, options);
+        double elapsed = now_ms() - start;
+
+        if (!collection) return -1;
+        delete_collection(collection);
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int notes = argc > 2 ? atoi(argv[2]) : DEFAULT_NOTES;
+    CollectionOptions options;
+    char path[512];
+    sqlite3 *anki;
+    double first_ms = 0, idle_ms = 0, worst_ms = 0, total_ms = 0;
+    int failures = 0;
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    if (notes < 2 * ROUNDS * DELETED_CARDS + 100) notes = DEFAULT_NOTES;
+    game_options(&options);
+
+    // Edited every run, so always built fresh
+    snprintf(path, sizeof(path), "%s/anki_refresh_%d.anki2", dir, notes);
+    if (synth_deck_create(path, notes) < 0) return 1;
+
+    double reload_ms = best_reload_ms(path, &options);
+    CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, &options);
+    if (reload_ms < 0 || !collection || sqlite3_open(path, &anki) != SQLITE_OK) return 1;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        CollectionChanges changes;
+
+        // Nothing changed yet: the cost of polling. The first refresh also
+        // builds the card id lookup.
+        double start = now_ms();
+        if (collection_refresh(collection, NULL) != 0) failures++;
+        double elapsed = now_ms() - start;
+        if (round == 0) first_ms = elapsed;
+        else if (elapsed > idle_ms) idle_ms = elapsed;
+
+        if (edit_collection(anki, notes, round) < 0) return 1;
+
+        start = now_ms();
+        int changed = collection_refresh(collection, &changes);
+        elapsed = now_ms() - start;
+        total_ms += elapsed;
+        if (elapsed > worst_ms) worst_ms = elapsed;
+
+        // Every edit shows, in place, and nothing else moves
+        int first_edited = changes.edited.count ? changes.edited.items[0] : -1;
+        if (changed < 0 || changes.edited.count != EDITED_NOTES ||
+            collection->count - changes.first_added != ADDED_NOTES ||
+            changes.retired.count != DELETED_CARDS + 1 ||
+            changes.rescheduled.count < REVIEWED_CARDS ||
+            strncmp(collection->cards[first_edited].word, "編集", strlen("編集")) != 0) {
+            failures++;
+        }
+        collection_changes_free(&changes);
+    }
+
+    printf("%d notes, %d rounds of %d edits, %d reviews, %d adds, %d deletes, 1 move\n", notes,
+           ROUNDS, EDITED_NOTES, REVIEWED_CARDS, ADDED_NOTES, DELETED_CARDS);
+    printf("%-22s %9.2f ms\n", "full reload", reload_ms);
+    printf("%-22s %9.3f ms mean, %.3f ms worst (%.0fx faster)\n", "refresh", total_ms / ROUNDS,
+           worst_ms, reload_ms / (total_ms / ROUNDS));
+    printf("%-22s %9.3f ms worst, %.3f ms the first time\n", "refresh, no changes", idle_ms,
+           first_ms);
+    printf("%d cards after refreshes, %d rounds wrong\n", collection->count, failures);
+
+    sqlite3_close(anki);
+    delete_collection(collection);
+    return failures ? 1 : 0;
+}
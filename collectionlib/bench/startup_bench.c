@@ -0,0 +1,80 @@
+// Startup time: SQLite extraction vs. the mmap'd precompiled deck cache
+//
+// Usage: startup_bench [work_dir] [notes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "../include/deck_cache.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_NOTES 100000
+#define RUNS 5
+
+static double best_load_ms(const char *path, const char *cache_dir, int *count) {
+    CollectionOptions options;
+    double best = 0;
+
+    collection_default_options(&options);
+    options.cache_dir = cache_dir;
+
+    for (int run = 0; run < RUNS; run++) {
+        double start = now_ms();
+        CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, &options);
+        double elapsed = now_ms() - start;
+
+        if (!collection) return -1;
+        *count = collection_count(collection);
+        delete_collection(collection);
+
+        if (run == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int notes = argc > 2 ? atoi(argv[2]) : DEFAULT_NOTES;
+    char path[512], cache_path[1024];
+    int count = 0;
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    if (notes <= 0) notes = DEFAULT_NOTES;
+    snprintf(path, sizeof(path), "%s/anki_synth_%d.anki2", dir, notes);
+    if (synth_deck_ensure(path, notes) < 0) return 1;
+
+    // Start without a cache so the first cached run has to build it
+    const char *deck_name = SYNTH_DECK_NAME;
+    CardCollection *keyed = collection_create();
+    DeckInfo key;
+    if (!keyed || collection_open_decks(keyed, path, &deck_name, 1, 0, &key) < 0) return 1;
+    delete_collection(keyed);
+    deck_cache_path(dir, path, key.id, cache_path, sizeof(cache_path));
+    unlink(cache_path);
+
+    double sqlite_ms = best_load_ms(path, NULL, &count);
+    if (sqlite_ms < 0) return 1;
+
+    CollectionOptions options;
+    collection_default_options(&options);
+    options.cache_dir = dir;
+
+    double start = now_ms();
+    CardCollection *collection = setup_collection_with_options(path, SYNTH_DECK_NAME, &options);
+    double build_ms = now_ms() - start;
+    if (!collection) return 1;
+    delete_collection(collection);
+
+    double cache_ms = best_load_ms(path, dir, &count);
+    if (cache_ms < 0) return 1;
+
+    printf("%d cards\n", count);
+    printf("%-22s %10.1f ms\n", "sqlite load", sqlite_ms);
+    printf("%-22s %10.1f ms\n", "sqlite load + build", build_ms);
+    printf("%-22s %10.1f ms  (%.1fx)\n", "deck cache load", cache_ms, sqlite_ms / cache_ms);
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include "synth_deck.h"
+#include "../include/deck.h"
+
+#include <sqlite3.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FILLER_DECKS 200
+
+static const char *schema =
+    "CREATE TABLE col (id integer PRIMARY KEY, crt integer NOT NULL);"
+    "CREATE TABLE decks (id integer PRIMARY KEY NOT NULL, name text NOT NULL COLLATE unicase, "
+    "  mtime_secs integer NOT NULL, usn integer NOT NULL, common blob NOT NULL, kind blob NOT NULL);"
+    "CREATE UNIQUE INDEX idx_decks_name ON decks (name);"
+    "CREATE TABLE notes (id integer PRIMARY KEY, guid text NOT NULL, mid integer NOT NULL, "
+    "  mod integer NOT NULL, usn integer NOT NULL, tags text NOT NULL, flds text NOT NULL, "
+    "  sfld integer NOT NULL, csum integer NOT NULL, flags integer NOT NULL, data text NOT NULL);"
+    "CREATE TABLE cards (id integer PRIMARY KEY, nid integer NOT NULL, did integer NOT NULL, "
+    "  ord integer NOT NULL, mod integer NOT NULL, usn integer NOT NULL, type integer NOT NULL, "
+    "  queue integer NOT NULL, due integer NOT NULL, ivl integer NOT NULL, factor integer NOT NULL, "
+    "  reps integer NOT NULL, lapses integer NOT NULL, left integer NOT NULL, odue integer NOT NULL, "
+    "  odid integer NOT NULL, flags integer NOT NULL, data text NOT NULL);"
+    "CREATE INDEX ix_notes_usn ON notes (usn);"
+    "CREATE INDEX ix_cards_usn ON cards (usn);"
+    "CREATE INDEX ix_cards_nid ON cards (nid);"
+    "CREATE INDEX ix_cards_sched ON cards (did, queue, due);"
+    "CREATE TABLE revlog (id integer PRIMARY KEY, cid integer NOT NULL, usn integer NOT NULL, "
+    "  ease integer NOT NULL, ivl integer NOT NULL, lastIvl integer NOT NULL, factor integer NOT NULL, "
+    "  time integer NOT NULL, type integer NOT NULL);"
+    "CREATE INDEX ix_revlog_cid ON revlog (cid);"
+    "CREATE TABLE graves (usn integer NOT NULL, oid integer NOT NULL, type integer NOT NULL);"
+    // Created 200 days before the decks' mtime, so due days 0-400 straddle it
+    "INSERT INTO col VALUES (1, 1682720000);";
+
+static const char *kanji[] = {
+    "日", "本", "語", "勉", "強", "漢", "字", "先", "生", "学", "校", "電",
+    "車", "新", "聞", "天", "気", "食", "飲", "見", "行", "来", "話", "書",
+};
+static const char *kana[] = {
+    "か", "き", "く", "け", "こ", "さ", "し", "す", "せ", "そ", "た", "ち",
+    "に", "ほ", "ん", "ご", "べ", "きょ", "しゃ", "りゅ", "う", "い", "で", "ぶ",
+};
+#define KANJI_COUNT (unsigned)(sizeof(kanji) / sizeof(kanji[0]))
+#define KANA_COUNT (unsigned)(sizeof(kana) / sizeof(kana[0]))
+
+static unsigned next_rand(unsigned *state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFF;
+}
+
+// Build a note's fields the way Yomitan exports them: word, reading, glossary HTML
+static void build_fields(char *out, size_t size, int n, unsigned *rng) {
+    char word[64] = "";
+    char reading[64] = "";
+    int len = 1 + next_rand(rng) % 3;
+
+    for (int i = 0; i < len; i++) {
+        strcat(word, kanji[next_rand(rng) % KANJI_COUNT]);
+        strcat(reading, kana[next_rand(rng) % KANA_COUNT]);
+        strcat(reading, kana[next_rand(rng) % KANA_COUNT]);
+    }
+
+    snprintf(out, size,
+             "%s\x1f%s\x1f"
+             "<div style=\"text-align: left;\" class=\"yomitan-glossary\"><ol>"
+             "<li data-dictionary=\"JMdict\"><i>(n, vs, JMdict)</i> <span><ul>"
+             "<li><div>meaning %d</div></li><li><div>secondary sense %d</div></li>"
+             "</ul></span></li></ol></div>"
+             "\x1f%s\x1f<img src=\"audio_%d.mp3\">\x1f\x1f\x1f\x1f\x1f\x1f\x1f\x1f",
+             word, reading, n, n, reading, n);
+}
+
+int synth_deck_create(const char *path, int note_count) {
+    sqlite3 *db;
+    sqlite3_stmt *deck_stmt = NULL, *note_stmt = NULL, *card_stmt = NULL, *revlog_stmt = NULL;
+    long long revlog_id = 1650000000000LL;
+    unsigned rng = 12345;
+    char fields[2048];
+    int rc = -1;
+
+    unlink(path);
+    if (sqlite3_open(path, &db) != SQLITE_OK) {
+        fprintf(stderr, "Cannot create %s: %s\n", path, sqlite3_errmsg(db));
+        sqlite3_close(db);
+        return -1;
+    }
+    register_anki_collations(db);
+
+    if (sqlite3_exec(db, schema, NULL, NULL, NULL) != SQLITE_OK ||
+        sqlite3_exec(db, "BEGIN;", NULL, NULL, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Failed to create schema: %s\n", sqlite3_errmsg(db));
+        goto done;
+    }
+
+    if (sqlite3_prepare_v2(db, "INSERT INTO decks VALUES (?, ?, 1700000000, 0, x'', x'');",
+                           -1, &deck_stmt, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, "INSERT INTO notes VALUES (?, ?, 1, 1700000000, 0, '', ?, 0, 0, 0, '');",
+                           -1, &note_stmt, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, "INSERT INTO cards VALUES (?, ?, ?, 0, 1700000000, 0, 2, 2, ?, ?, "
+                               "2500, ?, ?, 0, 0, 0, 0, '');",
+                           -1, &card_stmt, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, "INSERT INTO revlog VALUES (?, ?, 0, ?, 1, 1, 2500, 5000, 1);",
+                           -1, &revlog_stmt, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Failed to prepare inserts: %s\n", sqlite3_errmsg(db));
+        goto done;
+    }
+
+    // The target deck sits among a few hundred unrelated ones; names are
+    // stored the way Anki does, with 0x1F between levels
+    for (int i = 0; i <= FILLER_DECKS + SYNTH_SUBDECKS; i++) {
+        char name[64];
+        if (i == 0) snprintf(name, sizeof(name), "%s", SYNTH_DECK_NAME);
+        else if (i <= FILLER_DECKS) snprintf(name, sizeof(name), "Filler\x1f" "Deck %d", i);
+        else snprintf(name, sizeof(name), "%s\x1f" "Sub %d", SYNTH_DECK_NAME, i - FILLER_DECKS);
+
+        sqlite3_bind_int64(deck_stmt, 1, SYNTH_DECK_ID + i);
+        sqlite3_bind_text(deck_stmt, 2, name, -1, SQLITE_TRANSIENT);
+        sqlite3_step(deck_stmt);
+        sqlite3_reset(deck_stmt);
+    }
+
+    for (int n = 0; n < note_count; n++) {
+        char guid[32];
+        long long note_id = 1600000000000LL + n;
+
+        build_fields(fields, sizeof(fields), n, &rng);
+        snprintf(guid, sizeof(guid), "g%d", n);
+
+        sqlite3_bind_int64(note_stmt, 1, note_id);
+        sqlite3_bind_text(note_stmt, 2, guid, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(note_stmt, 3, fields, -1, SQLITE_TRANSIENT);
+        sqlite3_step(note_stmt);
+        sqlite3_reset(note_stmt);
+
+        sqlite3_bind_int64(card_stmt, 1, note_id + 1);
+        sqlite3_bind_int64(card_stmt, 2, note_id);
+        sqlite3_bind_int64(card_stmt, 3, SYNTH_DECK_ID);
+        sqlite3_bind_int(card_stmt, 4, next_rand(&rng) % 400);     // due
+        sqlite3_bind_int(card_stmt, 5, 1 + next_rand(&rng) % 200); // ivl
+        sqlite3_bind_int(card_stmt, 6, next_rand(&rng) % 30);      // reps
+        sqlite3_bind_int(card_stmt, 7, next_rand(&rng) % 8);       // lapses
+        sqlite3_step(card_stmt);
+        sqlite3_reset(card_stmt);
+
+        // A short review history per card, about one answer in four Again
+        int reviews = next_rand(&rng) % 6;
+        for (int r = 0; r < reviews; r++) {
+            sqlite3_bind_int64(revlog_stmt, 1, revlog_id++);
+            sqlite3_bind_int64(revlog_stmt, 2, note_id + 1);
+            sqlite3_bind_int(revlog_stmt, 3, 1 + next_rand(&rng) % 4);
+            sqlite3_step(revlog_stmt);
+            sqlite3_reset(revlog_stmt);
+        }
+    }
+
+    if (sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK) rc = 0;
+
+done:
+    sqlite3_finalize(deck_stmt);
+    sqlite3_finalize(note_stmt);
+    sqlite3_finalize(card_stmt);
+    sqlite3_finalize(revlog_stmt);
+    sqlite3_close(db);
+    return rc;
+}
+
+int synth_deck_ensure(const char *path, int note_count) {
+    if (access(path, R_OK) == 0) return 0;
+    return synth_deck_create(path, note_count);
+}
@@ -0,0 +1,16 @@
+#ifndef SYNTH_DECK_H
+#define SYNTH_DECK_H
+
+#define SYNTH_DECK_ID 1700000000000LL
+#define SYNTH_DECK_NAME "Synthetic"
+#define SYNTH_SUBDECKS 3    // empty "Synthetic::Sub N" children
+
+// Write a synthetic collection.anki2 holding note_count notes (one card each)
+// in SYNTH_DECK_NAME, plus filler decks and empty subdecks. Existing files
+// are replaced.
+int synth_deck_create(const char *path, int note_count);
+
+// Create the file only if it does not exist yet
+int synth_deck_ensure(const char *path, int note_count);
+
+#endif
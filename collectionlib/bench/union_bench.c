@@ -0,0 +1,123 @@
+// Loading several decks: one setup_collection per deck vs. one union load
+// with shared string interning and duplicate-note merging
+//
+// Two synthetic profiles share their first notes, as profiles built from
+// the same dictionary exports do. The first profile is also named a second
+// time through one of its subdecks, which the union resolves on the same
+// connection and loads once.
+//
+// Usage: union_bench [work_dir] [notes]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/collection.h"
+#include "../include/log.h"
+#include "../include/union.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_NOTES 100000
+#define RUNS 3
+#define SOURCE_COUNT 3
+
+typedef struct {
+    double ms;
+    int cards;
+    size_t bytes;           // card array, string arenas and deck cache mappings
+} LoadResult;
+
+static size_t collection_bytes(const CardCollection *collection) {
+    return (size_t)collection->capacity * sizeof(CardData) + collection->strings.total_bytes +
+           collection->mapping_size;
+}
+
+static int load_separately(const DeckSource *sources, const CollectionOptions *options,
+                           LoadResult *best) {
+    for (int run = 0; run < RUNS; run++) {
+        CardCollection *collections[SOURCE_COUNT];
+        LoadResult result = {0, 0, 0};
+        double start = now_ms();
+
+        for (int i = 0; i < SOURCE_COUNT; i++) {
+            collections[i] = setup_collection_with_options(sources[i].db_path, sources[i].deck_name,
+                                                           options);
+            if (!collections[i]) return -1;
+        }
+        result.ms = now_ms() - start;
+
+        for (int i = 0; i < SOURCE_COUNT; i++) {
+            result.cards += collections[i]->count;
+            result.bytes += collection_bytes(collections[i]);
+            delete_collection(collections[i]);
+        }
+        if (run == 0 || result.ms < best->ms) *best = result;
+    }
+    return 0;
+}
+
+static int load_union(const DeckSource *sources, const CollectionOptions *options,
+                      LoadResult *best) {
+    for (int run = 0; run < RUNS; run++) {
+        LoadResult result;
+        double start = now_ms();
+
+        CardCollection *collection = setup_collection_union(sources, SOURCE_COUNT, options);
+        if (!collection) return -1;
+        result.ms = now_ms() - start;
+        result.cards = collection->count;
+        result.bytes = collection_bytes(collection);
+        delete_collection(collection);
+
+        if (run == 0 || result.ms < best->ms) *best = result;
+    }
+    return 0;
+}
+
+static void report(const char *label, const LoadResult *separate, const LoadResult *merged) {
+    printf("%-8s %-10s %9.1f ms %8d cards %8.1f MiB\n", label, "separate", separate->ms,
+           separate->cards, separate->bytes / (1024.0 * 1024.0));
+    printf("%-8s %-10s %9.1f ms %8d cards %8.1f MiB  (%.2fx time, %.2fx memory)\n", label, "union",
+           merged->ms, merged->cards, merged->bytes / (1024.0 * 1024.0),
+           separate->ms / merged->ms, (double)separate->bytes / merged->bytes);
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int notes = argc > 2 ? atoi(argv[2]) : DEFAULT_NOTES;
+    char first[512], second[512];
+    CollectionOptions options;
+    LoadResult separate, merged;
+
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    if (notes <= 0) notes = DEFAULT_NOTES;
+
+    snprintf(first, sizeof(first), "%s/anki_synth_%d.anki2", dir, notes);
+    snprintf(second, sizeof(second), "%s/anki_synth_%d.anki2", dir, notes / 2);
+    if (synth_deck_ensure(first, notes) < 0 || synth_deck_ensure(second, notes / 2) < 0) return 1;
+
+    const DeckSource sources[SOURCE_COUNT] = {
+        {first, SYNTH_DECK_NAME},
+        {first, SYNTH_DECK_NAME "::Sub 1"},
+        {second, SYNTH_DECK_NAME},
+    };
+
+    collection_default_options(&options);
+    options.include_subdecks = 1;
+
+    printf("%d + %d notes, %d sources\n", notes, notes / 2, SOURCE_COUNT);
+    if (load_separately(sources, &options, &separate) < 0 ||
+        load_union(sources, &options, &merged) < 0) {
+        return 1;
+    }
+    report("sqlite", &separate, &merged);
+
+    // Best of the runs is a warm one: the first load of each builds its caches
+    options.cache_dir = dir;
+    if (load_separately(sources, &options, &separate) < 0 ||
+        load_union(sources, &options, &merged) < 0) {
+        return 1;
+    }
+    report("cached", &separate, &merged);
+    return 0;
+}
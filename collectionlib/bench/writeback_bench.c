@@ -0,0 +1,159 @@
+// Cost of writing game results to the collection: one autocommitted INSERT
+// per result on the calling thread vs. the batched background writer
+//
+// Usage: writeback_bench [work_dir] [results]
+// The direct path is what a frame would pay per kill. The writer is measured
+// for caller-side submit latency and sustained commit throughput.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/log.h"
+#include "../include/review_writer.h"
+#include "bench_util.h"
+#include "synth_deck.h"
+
+#define DEFAULT_RESULTS 200000
+#define DIRECT_RESULTS 500      // each one is an fsync
+#define BENCH_NOTES 1000
+
+static ReviewResult make_result(int n) {
+    ReviewResult result;
+    result.card_id = 1600000000001LL + n % BENCH_NOTES;
+    result.time_ms = 1700000000000LL + n;
+    result.answer_ms = 500 + n % 4000;
+    result.outcome = n % 7 ? REVIEW_HIT : REVIEW_MISS;
+    return result;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, double *latency, int count, double elapsed_ms, long rows) {
+    qsort(latency, count, sizeof(double), compare_double);
+    printf("%-16s %9ld %12.0f %10.1f %10.1f %10.1f\n", name, rows, rows / (elapsed_ms / 1000.0),
+           latency[count / 2] * 1000.0, latency[count * 99 / 100] * 1000.0,
+           latency[count - 1] * 1000.0);
+}
+
+// What check_input would do without the writer: a statement per kill
+static int run_direct(const char *path, double *latency) {
+    sqlite3 *db;
+    sqlite3_stmt *insert;
+
+    if (sqlite3_open(path, &db) != SQLITE_OK ||
+        sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS " REVIEW_TABLE " (id integer PRIMARY KEY, "
+                         "cid integer, time integer, answer_ms integer, outcome integer);",
+                     NULL, NULL, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, "INSERT INTO " REVIEW_TABLE " (cid, time, answer_ms, outcome) "
+                               "VALUES (?, ?, ?, ?);", -1, &insert, NULL) != SQLITE_OK) {
+        fprintf(stderr, "Direct insert setup failed: %s\n", sqlite3_errmsg(db));
+        sqlite3_close(db);
+        return -1;
+    }
+
+    double start = now_ms();
+    for (int n = 0; n < DIRECT_RESULTS; n++) {
+        ReviewResult result = make_result(n);
+        double t = now_ms();
+        sqlite3_bind_int64(insert, 1, result.card_id);
+        sqlite3_bind_int64(insert, 2, result.time_ms);
+        sqlite3_bind_int(insert, 3, result.answer_ms);
+        sqlite3_bind_int(insert, 4, result.outcome);
+        sqlite3_step(insert);
+        sqlite3_reset(insert);
+        latency[n] = now_ms() - t;
+    }
+    report("direct", latency, DIRECT_RESULTS, now_ms() - start, DIRECT_RESULTS);
+
+    sqlite3_finalize(insert);
+    sqlite3_close(db);
+    return 0;
+}
+
+// Submit as fast as the caller can, waiting for a flush whenever the buffer
+// is full, so every result is written and throughput is the commit rate
+static int run_writer(const char *path, double *latency, int results) {
+    ReviewWriter *writer = review_writer_open(path);
+    if (!writer) return -1;
+
+    double start = now_ms();
+    for (int n = 0; n < results; n++) {
+        ReviewResult result = make_result(n);
+        double t = now_ms();
+        int rc = review_writer_submit(writer, &result);
+        latency[n] = now_ms() - t;
+
+        if (rc < 0) {
+            review_writer_flush(writer);
+            n--;
+        }
+    }
+    review_writer_flush(writer);
+    double elapsed = now_ms() - start;
+
+    long written = (long)writer->written;
+    long batches = (long)writer->batches;
+    report("writer", latency, results, elapsed, written);
+    printf("%-16s %9ld batches, %ld rows each on average\n", "", batches,
+           batches ? written / batches : 0);
+
+    // Quietly: the summary would count the full-buffer retries above as drops
+    collection_set_log_level(COLLECTION_LOG_SILENT);
+    review_writer_close(writer);
+    collection_set_log_level(COLLECTION_LOG_INFO);
+    return written == results ? 0 : -1;
+}
+
+static long count_rows(const char *path) {
+    sqlite3 *db;
+    sqlite3_stmt *stmt;
+    long rows = -1;
+
+    if (sqlite3_open(path, &db) == SQLITE_OK &&
+        sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM " REVIEW_TABLE ";", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) rows = sqlite3_column_int64(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return rows;
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = argc > 1 ? argv[1] : "/tmp";
+    int results = argc > 2 ? atoi(argv[2]) : DEFAULT_RESULTS;
+    char direct_path[512], writer_path[512];
+
+    if (results <= 0) results = DEFAULT_RESULTS;
+    snprintf(direct_path, sizeof(direct_path), "%s/anki_writeback_direct.anki2", dir);
+    snprintf(writer_path, sizeof(writer_path), "%s/anki_writeback_writer.anki2", dir);
+
+    // Fresh files each run so both start from the same rollback-journal state
+    if (synth_deck_create(direct_path, BENCH_NOTES) < 0 ||
+        synth_deck_create(writer_path, BENCH_NOTES) < 0) {
+        return 1;
+    }
+
+    double *latency = malloc((results > DIRECT_RESULTS ? results : DIRECT_RESULTS) * sizeof(double));
+    if (!latency) return 1;
+
+    printf("%-16s %9s %12s %10s %10s %10s\n", "mode", "rows", "rows/sec", "p50 us", "p99 us",
+           "max us");
+    if (run_direct(direct_path, latency) < 0) return 1;
+    if (run_writer(writer_path, latency, results) < 0) {
+        fprintf(stderr, "Writer lost results\n");
+        return 1;
+    }
+
+    long rows = count_rows(writer_path);
+    printf("%ld rows in %s\n", rows, REVIEW_TABLE);
+
+    free(latency);
+    unlink(direct_path);
+    unlink(writer_path);
+    return rows == results ? 0 : 1;
+}
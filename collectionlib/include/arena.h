@@ -0,0 +1,35 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+// One chunk of arena memory; blocks are never moved, so pointers stay valid
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t size;
+    char data[];
+} ArenaBlock;
+
+// Bump allocator for card strings, released all at once
+typedef struct {
+    ArenaBlock *head;
+    size_t block_size;
+    size_t total_bytes;     // bytes reserved from malloc
+} StringArena;
+
+void arena_init(StringArena *arena, size_t block_size);
+void* arena_alloc(StringArena *arena, size_t size);
+char* arena_strndup(StringArena *arena, const char *str, size_t len);
+char* arena_strdup(StringArena *arena, const char *str);
+
+// For structs kept with the strings; align is a power of two
+void* arena_alloc_aligned(StringArena *arena, size_t size, size_t align);
+void arena_free(StringArena *arena);
+
+// Move every block of src into dst; src is left empty
+void arena_merge(StringArena *dst, StringArena *src);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ASYNC_LOAD_H
+#define ASYNC_LOAD_H
+
+#include <pthread.h>
+
+#include "../include/collection.h"
+
+#define ASYNC_LOAD_RUNNING 0
+#define ASYNC_LOAD_DONE 1
+#define ASYNC_LOAD_FAILED 2
+
+// A collection loading on its own thread. The collection exists from the
+// start, and the caller may read cards [0, collection_published()) at any
+// time: they are final and the array does not move while loading. Anything
+// else in the collection (count, schedule, the database) belongs to the
+// loader until collection_load_finish.
+typedef struct {
+    CardCollection *collection;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;     // a publish, or the load ended
+    int state;                  // ASYNC_LOAD_*
+
+    char *db_path;
+    char *deck_name;
+    char *cache_dir;
+    CollectionOptions options;
+} CollectionLoad;
+
+// Start loading; NULL if the thread could not be started
+CollectionLoad* collection_load_start(const char *db_path, const char *deck_name,
+                                      const CollectionOptions *options);
+
+// ASYNC_LOAD_*; never blocks
+int collection_load_state(CollectionLoad *load);
+
+// Block until min_cards are published or the load ends; the published count
+int collection_load_wait(CollectionLoad *load, int min_cards);
+
+// Join the loader and hand over the collection, NULL if the load failed.
+// The load is freed either way.
+CardCollection* collection_load_finish(CollectionLoad *load);
+
+// Stop the loader at its next batch and free everything
+void collection_load_cancel(CollectionLoad *load);
+
+#endif
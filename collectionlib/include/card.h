@@ -1,19 +1,74 @@
 #ifndef CARD_H
 #define CARD_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
+#include "../include/arena.h"
+#include "../include/html.h"
+#include "../include/intern.h"
 
-// Structure to hold card data
+#define FIELD_SEPARATOR_CHAR '\x1f'  // Anki uses this separator between fields
+#define MEANING_ENTRIES 1               // glossary entries kept per card
+#define MEANING_BUFFER_SIZE 1024
+#define CARD_MAX_ANSWERS 4              // alternative readings kept per card
+
+// Non-owning slice of a string, not NUL-terminated
+typedef struct {
+    const char *ptr;
+    size_t len;
+} StringView;
+
+// The fields we use, as views into the note's flds buffer
+typedef struct {
+    StringView word;
+    StringView reading;
+    StringView meaning;
+} CardFieldViews;
+
+// One way to type a card's reading, normalized for matching (see reading.h)
+typedef struct {
+    const char *text;
+    uint32_t length;
+    uint32_t hash;          // reading_text_hash of text
+} CardAnswer;
+
+// Structure to hold card data; strings live in the collection's arena
 typedef struct {
     char *word;
     char *word_reading;
     char *word_meaning;
+    long long card_id;      // cards.id, to join review data
+    const CardAnswer *answers;  // filled in as the card is published
+    int answer_count;
 } CardData;
 
-int parse_card_fields(const char *fields_str, CardData *card); 
-void free_card_data(CardData *card);
+// Anki's cards.queue; negative values are suspended or buried cards
+#define CARD_QUEUE_NEW 0
+#define CARD_QUEUE_LEARNING 1       // due is a unix timestamp
+#define CARD_QUEUE_REVIEW 2         // due is a day number
+#define CARD_QUEUE_DAY_LEARNING 3   // due is a day number
+
+// Review state of one card, from the cards and revlog tables
+typedef struct {
+    float overdue_days;     // > 0 past due, < 0 not due yet, 0 for new cards
+    int queue;
+    int interval;           // days
+    int factor;             // ease in permille, 2500 = 250%
+    int reps;
+    int lapses;
+    int reviews;            // revlog entries
+    int failures;           // revlog entries answered Again
+} CardSchedule;
+
+int split_card_fields(const char *fields_str, size_t len, CardFieldViews *views);
+int parse_card_fields(const char *fields_str, size_t len, CardData *card, StringArena *arena);
+
+// As parse_card_fields, with the strings interned into a table shared with
+// other loaders; only the interning is done under its lock
+int parse_card_fields_shared(const char *fields_str, size_t len, CardData *card,
+                             SharedInternTable *strings);
 
 #endif
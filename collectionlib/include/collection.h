@@ -6,17 +6,101 @@
 #include <stdio.h>
 
 #include "../include/card.h"
+#include "../include/arena.h"
 
-#define MAX_CARDS 50
+#define INITIAL_CARD_CAPACITY 64
+#define COLLECTION_PUBLISH_CARDS 256    // serial loader publishes this many at a time
+#define LOADER_AUTO_THREADS 0
+
+// A row of the decks table
+typedef struct {
+    long long id;
+    long long mtime_secs;
+    int usn;
+} DeckInfo;
 
 // Structure to hold all cards
 typedef struct {
     sqlite3 *db;
-    CardData cards[MAX_CARDS];
+    CardData *cards;
     int count;
+    int capacity;
+    StringArena strings;    // backing store for every card string
+    SharedInternTable *shared_strings;  // when set, loaders intern card strings here instead
+    int defer_answers;      // leave answers to the collection the cards are merged into
+    void *mapping;          // deck cache the strings point into, if any
+    size_t mapping_size;
+    
+    long long *deck_ids;    // decks the cards were loaded from
+    int deck_count;
+    CardSchedule *schedule; // per card, if loaded with load_schedule
+    int *card_sources;      // per card, for unions of several files (see union.h)
+    int source_count;
+    
+    // Cards [0, published) are final. While an async load runs (loading is
+    // set) the array never moves once something is published, so another
+    // thread may read that prefix as the loader appends.
+    int published;
+    int loading;
+    int cancel;             // set to make a running load give up
+    void (*on_publish)(void *user_data, int published);
+    void *publish_data;
+    
+    // Where collection_refresh picks up (see refresh.h): rows edited at or
+    // after refresh_mod (unix seconds), or synced in with a usn above
+    // refresh_usn. Zero when the cards did not come from db.
+    long long refresh_mod;
+    long long refresh_usn;
+    unsigned char *retired;             // per card once a refresh retired one, else NULL
+    struct CollectionRefresh *refresh;  // lookups kept between refreshes
+    
+    // Prepared deck lookups, reused across calls
+    sqlite3_stmt *find_deck_stmt;
+    sqlite3_stmt *find_children_stmt;
 } CardCollection;
 
+// Load-time settings for setup_collection_with_options
+typedef struct {
+    int threads;            // parser threads; LOADER_AUTO_THREADS = one per CPU, 1 = serial
+    const char *cache_dir;  // where precompiled deck caches live; NULL disables them
+    int include_subdecks;   // also load cards from "Deck::Child" decks
+    int load_schedule;      // read review data into collection->schedule
+} CollectionOptions;
+
+void collection_default_options(CollectionOptions *options);
+
 CardCollection* setup_collection(const char *db_path, const char *deck_name);
+CardCollection* setup_collection_with_options(const char *db_path, const char *deck_name,
+                                              const CollectionOptions *options);
 void delete_collection(CardCollection *collection);
 
+// The two halves of setup_collection_with_options, for loaders that need the
+// collection before its cards: an empty collection, then the load into it.
+// On failure the collection is left for the caller to delete.
+CardCollection* collection_create(void);
+int collection_load_into(CardCollection *collection, const char *db_path, const char *deck_name,
+                         const CollectionOptions *options);
+
+// As collection_load_into, for several decks of one collection file. Decks
+// named more than once, directly or as subdecks, are loaded once.
+int collection_load_decks(CardCollection *collection, const char *db_path, const char **deck_names,
+                          int name_count, const CollectionOptions *options);
+
+// collection_load_decks in two steps: open the file and resolve the decks
+// into collection->deck_ids, giving the deck cache key; then load their
+// cards, from the deck cache when it is current, and the review data
+int collection_open_decks(CardCollection *collection, const char *db_path, const char **deck_names,
+                          int name_count, int include_subdecks, DeckInfo *key);
+int collection_load_cards(CardCollection *collection, const char *db_path, const DeckInfo *deck,
+                          const CollectionOptions *options);
+
+int collection_count(const CardCollection *collection);
+int collection_capacity(const CardCollection *collection);
+int collection_reserve(CardCollection *collection, int min_capacity);
+
+// Cards another thread may read; the same as the count once loading is done
+int collection_published(const CardCollection *collection);
+// Loader side: make every card appended so far visible
+void collection_publish(CardCollection *collection);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef DECK_H
+#define DECK_H
+
+#include <sqlite3.h>
+
+#include "../include/collection.h"
+
+#define DECK_NAME_SEPARATOR "::"        // as typed by users
+#define DECK_NAME_SEPARATOR_DB "\x1f"   // as stored in the decks table
+
+// One deck of a structured listing; name uses "::" between levels
+typedef struct {
+    DeckInfo info;
+    char *name;
+} DeckListEntry;
+
+typedef struct {
+    DeckListEntry *entries;
+    int count;
+    int capacity;
+    StringArena names;
+} DeckList;
+
+// Register the collations Anki declares on its tables (decks.name uses
+// "unicase"), so indexed lookups on those columns work outside Anki
+int register_anki_collations(sqlite3 *db);
+
+// Exact lookup of "Parent::Child" through the decks name index
+int deck_find(CardCollection *collection, const char *name, DeckInfo *info);
+
+// The named deck followed by all of its subdecks
+int deck_find_with_children(CardCollection *collection, const char *name, DeckList *list);
+
+// Every deck in the collection, ordered by name
+int deck_list_all(CardCollection *collection, DeckList *list);
+
+void deck_list_init(DeckList *list);
+void deck_list_free(DeckList *list);
+
+// Release the cached deck statements
+void deck_finalize_statements(CardCollection *collection);
+
+#endif
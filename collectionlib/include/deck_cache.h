@@ -0,0 +1,68 @@
+#ifndef DECK_CACHE_H
+#define DECK_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../include/collection.h"
+
+#define DECK_CACHE_MAGIC "ANKIDCK1"
+#define DECK_CACHE_VERSION 5
+#define DECK_CACHE_EXTENSION ".deckcache"
+
+// On-disk layout: header | entries[card_count] | answers[answer_count] |
+// string blob. All offsets are little-endian file offsets; strings are
+// NUL-terminated.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t card_count;
+    int64_t deck_id;
+    int64_t mtime_secs;         // deck mtime_secs when the cache was built
+    int64_t usn;
+    uint32_t meaning_entries;   // MEANING_ENTRIES the meanings were built with
+    uint32_t db_path_offset;    // source collection path, in the string blob
+    uint64_t entries_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint32_t source_count;      // DeckSources of a union cache, else 0
+    uint32_t reserved;
+    int64_t refresh_mod;        // collection refresh point of the cached cards
+    int64_t refresh_usn;
+    uint64_t answers_offset;
+    uint32_t answer_count;
+    uint32_t reserved2;
+} DeckCacheHeader;
+
+typedef struct {
+    int64_t card_id;
+    uint32_t word;
+    uint32_t reading;
+    uint32_t meaning;
+    uint32_t source;            // card_sources entry, for union caches
+    uint32_t first_answer;      // the card's answers, normalized when it was saved
+    uint32_t answers;
+} DeckCacheEntry;
+
+// A CardAnswer with its text in the string blob
+typedef struct {
+    uint32_t text;
+    uint32_t length;
+    uint32_t hash;
+} DeckCacheAnswer;
+
+// Cache file for a (collection, deck) pair inside cache_dir
+int deck_cache_path(const char *cache_dir, const char *db_path, long long deck_id,
+                    char *out, size_t size);
+
+// Map a cache file and point the collection's cards into it. Fails without
+// touching the collection if the file is missing, corrupt or stale.
+int deck_cache_load(const char *path, const char *db_path, const DeckInfo *deck,
+                    CardCollection *collection);
+
+// Write the loaded cards to path (via a temporary file and rename). Cards
+// saved without answers get them again as they are published.
+int deck_cache_save(const char *path, const char *db_path, const DeckInfo *deck,
+                    const CardCollection *collection);
+
+#endif
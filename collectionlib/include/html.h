@@ -0,0 +1,21 @@
+#ifndef HTML_H
+#define HTML_H
+
+#include <stddef.h>
+
+#define GLOSSARY_CLASS "yomitan-glossary"
+#define GLOSSARY_SEPARATOR "; "
+
+// Extract the first max_entries glossary entries from Yomitan-style HTML as
+// plain text: inline tags are stripped, entities decoded and whitespace
+// collapsed. Entries are the <div> elements inside the element whose class
+// list contains "yomitan-glossary", joined with GLOSSARY_SEPARATOR. Input
+// without a glossary is converted as a whole.
+//
+// Single forward pass, no allocation. Output is truncated on a UTF-8
+// boundary to fit out_size. Returns the length written, or -1 if a glossary
+// was present but held no entries.
+int html_extract_glossary(const char *html, size_t len, int max_entries,
+                          char *out, size_t out_size);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../include/arena.h"
+
+// Deduplicates strings: every distinct string is copied into the arena once
+// and later lookups return that copy, so equal interned strings are equal
+// pointers. The table itself is only needed while strings are being added.
+typedef struct {
+    StringArena *arena;         // owns the interned strings
+    const char **strings;       // open addressing, NULL when empty
+    uint64_t *hashes;
+    int capacity;               // power of two
+    int count;
+    size_t bytes_saved;         // copies avoided by returning an existing string
+} InternTable;
+
+int intern_init(InternTable *table, StringArena *arena, int expected);
+void intern_free(InternTable *table);
+
+// The interned copy of str, or NULL if out of memory. hash, if not NULL,
+// receives the string's hash for building keys from several strings.
+const char* intern_string(InternTable *table, const char *str, uint64_t *hash);
+
+// As intern_string, for the len bytes at str, which need not be terminated
+const char* intern_stringn(InternTable *table, const char *str, size_t len, uint64_t *hash);
+
+// A table that loaders on several threads add to, under lock
+typedef struct {
+    InternTable table;
+    pthread_mutex_t lock;
+} SharedInternTable;
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <sqlite3.h>
+
+#include "../include/collection.h"
+
+#define LOADER_BATCH_ROWS 256
+#define LOADER_MAX_THREADS 64
+#define LOADER_QUEUE_DEPTH 4    // batches in flight per worker
+
+// Step an already-bound cards query (note id, flds, card id) on the calling
+// thread while a pool of workers parses batches of rows into per-thread
+// arenas. Cards are appended to the collection in query order.
+int load_cards_parallel(sqlite3_stmt *stmt, CardCollection *collection, int threads);
+
+// Number of parser threads to use for a requested count (0 = one per CPU)
+int loader_thread_count(int requested);
+
+// Debug dump of one loaded card, shared by the serial and parallel loaders
+void report_card(const CardData *card, int index, long long card_id, long long note_id);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef LOG_H
+#define LOG_H
+
+typedef enum {
+    COLLECTION_LOG_SILENT = 0,
+    COLLECTION_LOG_ERROR = 1,
+    COLLECTION_LOG_INFO = 2,    // load progress and summaries (default)
+    COLLECTION_LOG_DEBUG = 3    // per-card and per-deck dumps
+} CollectionLogLevel;
+
+// Receives each formatted message, without a trailing newline
+typedef void (*CollectionLogSink)(CollectionLogLevel level, const char *message, void *user_data);
+
+extern CollectionLogLevel collection_log_level;
+
+void collection_set_log_level(CollectionLogLevel level);
+
+// Route messages to a callback; NULL restores stdout/stderr
+void collection_set_log_sink(CollectionLogSink sink, void *user_data);
+
+void collection_log_write(CollectionLogLevel level, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+// Disabled levels cost one comparison; arguments are never evaluated
+#define COLLECTION_LOG_ENABLED(level) ((level) <= collection_log_level)
+#define COLLECTION_LOG(level, ...) \
+    do { \
+        if (COLLECTION_LOG_ENABLED(level)) collection_log_write((level), __VA_ARGS__); \
+    } while (0)
+
+#endif
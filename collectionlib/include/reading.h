@@ -0,0 +1,33 @@
+#ifndef READING_H
+#define READING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../include/arena.h"
+#include "../include/card.h"
+
+#define READING_BUFFER_SIZE 1024
+
+// Turn a reading field into the answers a player can type: HTML stripped,
+// whitespace dropped, furigana markup such as "漢字[かんじ]" reduced to its
+// reading, katakana folded to hiragana, and alternatives split on , ; / 、
+// and their full-width forms. Duplicates and empty alternatives are left
+// out. The answers' text is written to out back to back, each terminated.
+// Returns the number of answers, at most max_answers.
+int reading_normalize(const char *reading, size_t len, char *out, size_t out_size,
+                      CardAnswer *answers, int max_answers);
+
+// Fold katakana to hiragana in place, so text typed or stored in either
+// script compares equal; what reading_normalize does to each answer. The
+// UTF-8 length does not change.
+void kana_fold(char *text, size_t length);
+
+// FNV-1a; what CardAnswer.hash holds, so typed input hashed the same way
+// can be compared without touching the text
+uint32_t reading_text_hash(const char *text, size_t length);
+
+// Fill card->answers from card->word_reading, in memory from arena
+int card_prepare_answers(CardData *card, StringArena *arena);
+
+#endif
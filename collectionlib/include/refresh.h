@@ -0,0 +1,56 @@
+#ifndef REFRESH_H
+#define REFRESH_H
+
+#include <stdint.h>
+
+#include "../include/collection.h"
+
+// Growable list of card indices
+typedef struct {
+    int *items;
+    int count;
+    int capacity;
+} CardIndexList;
+
+// What a refresh did to the collection. Card indices never change: edited
+// cards are patched where they are, new ones are appended, and cards that
+// were deleted or moved out of the loaded decks are retired, not removed.
+typedef struct {
+    CardIndexList edited;       // word, reading or meaning changed
+    CardIndexList rescheduled;  // review data reloaded
+    CardIndexList retired;      // deleted, or moved out of the loaded decks
+    CardIndexList restored;     // retired before, back in the decks now
+    int first_added;            // cards [first_added, count) are new
+} CollectionChanges;
+
+void collection_changes_init(CollectionChanges *changes);
+void collection_changes_free(CollectionChanges *changes);
+
+// Apply the notes and cards rows changed in db since the collection was
+// loaded or last refreshed. Anki stamps an edit with mod = now and usn = -1
+// until the next sync, and a sync gives the rows it brings in a usn above
+// any the collection had, so both cases are index lookups on usn; deleted
+// cards are found in the graves table. Replaced strings stay valid, so live
+// enemies keep pointing at what they showed. changes may be NULL.
+//
+// Runs on the thread that owns the collection; nothing else may read the
+// card array meanwhile, as appending may move it. Returns the number of
+// cards changed, or -1 if db was busy or the collection cannot be refreshed
+// (a union of several files, say); a later call picks up the same rows.
+int collection_refresh(CardCollection *collection, CollectionChanges *changes);
+
+// Record the refresh point of cards about to be read from db. now is taken
+// before the read, and the usn inside it, so no edit falls in between.
+int collection_refresh_mark(CardCollection *collection, long long now);
+
+// A hash of what a refresh would start from: the newest usn, the newest
+// unsynced edit and the unsynced deletions. Caches that cannot catch up by
+// refreshing, such as a union's, fold it into their key instead.
+int collection_change_stamp(CardCollection *collection, uint64_t *stamp);
+
+// Retired cards stay in the array but should not be shown again
+int collection_card_retired(const CardCollection *collection, int index);
+
+void collection_refresh_free(CardCollection *collection);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef REVIEW_WRITER_H
+#define REVIEW_WRITER_H
+
+#include <pthread.h>
+#include <sqlite3.h>
+
+#define REVIEW_WRITER_CAPACITY 4096     // results buffered between flushes
+#define REVIEW_WRITER_BATCH 256         // a fuller buffer wakes the writer early
+#define REVIEW_WRITER_INTERVAL_MS 1000  // otherwise it commits this often
+
+// Game results live in their own table next to Anki's, so they never touch
+// revlog or the scheduling Anki derives from it
+#define REVIEW_TABLE "typing_reviews"
+
+typedef enum {
+    REVIEW_MISS = 0,        // reached the bottom of the screen
+    REVIEW_HIT = 1
+} ReviewOutcome;
+
+typedef struct {
+    long long card_id;
+    long long time_ms;      // unix time of the answer, in milliseconds
+    int answer_ms;          // from spawn to answer
+    ReviewOutcome outcome;
+} ReviewResult;
+
+// Writes results on a thread with its own connection. The caller only
+// copies a result into a buffer under a mutex; the thread swaps buffers and
+// inserts the batch with one prepared statement inside one transaction, in
+// WAL mode, so nothing on the caller's side waits for SQLite or fsync.
+typedef struct {
+    sqlite3 *db;
+    sqlite3_stmt *insert;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t flushed;
+
+    ReviewResult *pending;      // filled by callers
+    ReviewResult *writing;      // owned by the thread while it commits
+    int pending_count;
+    int closing;
+    unsigned long flush_requests;
+    unsigned long flushes_done;
+
+    // Statistics, read under lock
+    unsigned long submitted;
+    unsigned long written;
+    unsigned long dropped;      // buffer full, or a batch failed to commit
+    unsigned long batches;
+} ReviewWriter;
+
+// Open db_path and start the thread. The thread puts the database in WAL
+// mode and creates the results table, retrying while another connection
+// holds the file; results submitted meanwhile wait in the buffer. NULL if
+// the file cannot be opened.
+ReviewWriter* review_writer_open(const char *db_path);
+
+// Queue a result; never blocks on I/O. -1 if the buffer is full (dropped).
+int review_writer_submit(ReviewWriter *writer, const ReviewResult *result);
+
+// Wait until everything submitted so far is committed (or dropped, if the
+// database could not be prepared)
+void review_writer_flush(ReviewWriter *writer);
+
+// Flush, stop the thread and close the connection
+void review_writer_close(ReviewWriter *writer);
+
+#endif
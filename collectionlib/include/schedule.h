@@ -0,0 +1,27 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include "../include/collection.h"
+
+#define SECONDS_PER_DAY 86400
+
+// Fill collection->schedule, one entry per card, from the cards and revlog
+// rows of the decks the collection was loaded from. Due dates are measured
+// against now, in days since the collection was created (col.crt). Cards
+// without a cards row keep a zeroed, new-card entry.
+int collection_load_schedule(CardCollection *collection);
+
+// The same for some of the cards of a collection built elsewhere, such as a
+// union of several files: cards[indices[i]] for i < count (every card up
+// to count when indices is NULL) come from deck_ids in db. Their entries in
+// schedule are overwritten; the rest are left alone.
+int schedule_load_cards(sqlite3 *db, const long long *deck_ids, int deck_count,
+                        const CardData *cards, const int *indices, int count,
+                        CardSchedule *schedule);
+
+// Reload the entries of a few cards by id, one indexed lookup each, for
+// when scanning every card of the decks would cost more (see refresh.h)
+int schedule_reload_cards(sqlite3 *db, const CardData *cards, const int *indices, int count,
+                          CardSchedule *schedule);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Scoped timers for profiling builds. Compile with -DCOLLECTION_TRACE
+// (make PROFILE=1) to record them; otherwise every TRACE_ macro expands to
+// nothing and instrumented code is identical to uninstrumented code.
+
+#define TRACE_RING_SIZE (1 << 18)   // most recent events kept; a power of two
+
+typedef struct {
+    const char *name;       // a string literal, never copied
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t thread;        // small per-thread id, 1 for the first thread seen
+} TraceEvent;
+
+typedef struct {
+    const char *name;
+    uint64_t start_ns;
+} TraceScope;
+
+uint64_t trace_now_ns(void);
+
+// Append a finished span to the ring; safe from any thread, never blocks.
+// The oldest events are overwritten once the ring is full.
+void trace_record(const char *name, uint64_t start_ns, uint64_t end_ns);
+
+// Total spans recorded so far, including overwritten ones
+uint64_t trace_event_count(void);
+
+// Write the events still in the ring as Chrome trace-event JSON, for
+// chrome://tracing or Perfetto. Returns the number of events written.
+int trace_export_chrome(const char *path);
+
+static inline void trace_scope_end(TraceScope *scope) {
+    trace_record(scope->name, scope->start_ns, trace_now_ns());
+}
+
+#ifdef COLLECTION_TRACE
+#define TRACE_ENABLED 1
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+// Times the rest of the enclosing block
+#define TRACE_SCOPE(name) \
+    TraceScope TRACE_CONCAT(trace_scope_, __LINE__) __attribute__((cleanup(trace_scope_end))) = \
+        {(name), trace_now_ns()}
+#else
+#define TRACE_ENABLED 0
+#define TRACE_SCOPE(name) do { } while (0)
+#endif
+
+#endif
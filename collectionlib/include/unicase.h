@@ -0,0 +1,12 @@
+#ifndef UNICASE_H
+#define UNICASE_H
+
+#include <stddef.h>
+
+// Compare two UTF-8 strings the way Anki's "unicase" collation does: both
+// are case folded in full (so "ß" equals "SS" and "Ａ" equals "ａ") and
+// the folded code points compared in order. Returns <0, 0 or >0. Bytes that
+// are not valid UTF-8 compare as themselves.
+int unicase_compare(const char *a, size_t len_a, const char *b, size_t len_b);
+
+#endif
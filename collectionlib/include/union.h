@@ -0,0 +1,26 @@
+#ifndef UNION_H
+#define UNION_H
+
+#include "../include/collection.h"
+
+// One deck to draw cards from; several may name the same collection file
+typedef struct {
+    const char *db_path;
+    const char *deck_name;
+} DeckSource;
+
+// Load the union of several decks, across one or more collection files,
+// into one card set. Each file is opened once, on its own thread, with its
+// decks loaded together (and cached together when options->cache_dir is
+// set). The results are merged through one intern table, so a string
+// shared by many notes is stored once, and a note whose word and reading
+// both match an earlier card is dropped as a duplicate.
+//
+// The union has no database of its own (collection->db is NULL) and card
+// ids are only unique within a file: card_sources[i] is the index of the
+// first source naming card i's file. Schedules are merged when
+// options->load_schedule is set.
+CardCollection* setup_collection_union(const DeckSource *sources, int source_count,
+                                       const CollectionOptions *options);
+
+#endif
@@ -0,0 +1,106 @@
+#include "../include/arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+void arena_init(StringArena *arena, size_t block_size) {
+    arena->head = NULL;
+    arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->total_bytes = 0;
+}
+
+static ArenaBlock* new_block(StringArena *arena, size_t size) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+    if (!block) return NULL;
+
+    block->next = NULL;
+    block->used = 0;
+    block->size = size;
+    arena->total_bytes += size;
+    return block;
+}
+
+void* arena_alloc(StringArena *arena, size_t size) {
+    ArenaBlock *block = arena->head;
+
+    if (size > arena->block_size) {
+        // Oversized requests get a dedicated block behind the current one,
+        // so the free space left in the head block is not abandoned
+        block = new_block(arena, size);
+        if (!block) return NULL;
+
+        if (arena->head) {
+            block->next = arena->head->next;
+            arena->head->next = block;
+        } else {
+            arena->head = block;
+        }
+        block->used = size;
+        return block->data;
+    }
+
+    if (!block || block->size - block->used < size) {
+        block = new_block(arena, arena->block_size);
+        if (!block) return NULL;
+
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void *ptr = block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+void* arena_alloc_aligned(StringArena *arena, size_t size, size_t align) {
+    char *ptr = arena_alloc(arena, size + align - 1);
+    if (!ptr) return NULL;
+
+    return ptr + (-(uintptr_t)ptr & (align - 1));
+}
+
+char* arena_strndup(StringArena *arena, const char *str, size_t len) {
+    char *copy = arena_alloc(arena, len + 1);
+    if (!copy) return NULL;
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char* arena_strdup(StringArena *arena, const char *str) {
+    return arena_strndup(arena, str, strlen(str));
+}
+
+void arena_free(StringArena *arena) {
+    ArenaBlock *block = arena->head;
+
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->head = NULL;
+    arena->total_bytes = 0;
+}
+
+void arena_merge(StringArena *dst, StringArena *src) {
+    if (!src->head) return;
+
+    ArenaBlock *last = src->head;
+    while (last->next) last = last->next;
+
+    // Keep dst's head in front so its free space is still used first
+    if (dst->head) {
+        last->next = dst->head->next;
+        dst->head->next = src->head;
+    } else {
+        dst->head = src->head;
+    }
+
+    dst->total_bytes += src->total_bytes;
+    src->head = NULL;
+    src->total_bytes = 0;
+}
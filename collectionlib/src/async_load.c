@@ -0,0 +1,113 @@
+#include "../include/async_load.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/log.h"
+
+static void on_publish(void *user_data, int published) {
+    CollectionLoad *load = user_data;
+    (void)published;
+
+    pthread_mutex_lock(&load->lock);
+    pthread_cond_broadcast(&load->changed);
+    pthread_mutex_unlock(&load->lock);
+}
+
+static void* load_main(void *arg) {
+    CollectionLoad *load = arg;
+    int rc = collection_load_into(load->collection, load->db_path, load->deck_name, &load->options);
+
+    pthread_mutex_lock(&load->lock);
+    load->state = rc < 0 ? ASYNC_LOAD_FAILED : ASYNC_LOAD_DONE;
+    pthread_cond_broadcast(&load->changed);
+    pthread_mutex_unlock(&load->lock);
+    return NULL;
+}
+
+static void load_free(CollectionLoad *load) {
+    pthread_cond_destroy(&load->changed);
+    pthread_mutex_destroy(&load->lock);
+    free(load->db_path);
+    free(load->deck_name);
+    free(load->cache_dir);
+    free(load);
+}
+
+CollectionLoad* collection_load_start(const char *db_path, const char *deck_name,
+                                      const CollectionOptions *options) {
+    CollectionLoad *load = calloc(1, sizeof(CollectionLoad));
+    if (!load) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to allocate collection load");
+        return NULL;
+    }
+    pthread_mutex_init(&load->lock, NULL);
+    pthread_cond_init(&load->changed, NULL);
+
+    // The caller's strings may not outlive this call
+    load->options = *options;
+    load->db_path = strdup(db_path);
+    load->deck_name = strdup(deck_name);
+    load->cache_dir = options->cache_dir ? strdup(options->cache_dir) : NULL;
+    load->options.cache_dir = load->cache_dir;
+    load->collection = collection_create();
+
+    if (!load->db_path || !load->deck_name || (options->cache_dir && !load->cache_dir) ||
+        !load->collection) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to allocate collection load");
+        delete_collection(load->collection);
+        load_free(load);
+        return NULL;
+    }
+
+    load->collection->loading = 1;
+    load->collection->on_publish = on_publish;
+    load->collection->publish_data = load;
+
+    if (pthread_create(&load->thread, NULL, load_main, load) != 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to start collection loader thread");
+        delete_collection(load->collection);
+        load_free(load);
+        return NULL;
+    }
+    return load;
+}
+
+int collection_load_state(CollectionLoad *load) {
+    pthread_mutex_lock(&load->lock);
+    int state = load->state;
+    pthread_mutex_unlock(&load->lock);
+    return state;
+}
+
+int collection_load_wait(CollectionLoad *load, int min_cards) {
+    pthread_mutex_lock(&load->lock);
+    while (load->state == ASYNC_LOAD_RUNNING &&
+           collection_published(load->collection) < min_cards) {
+        pthread_cond_wait(&load->changed, &load->lock);
+    }
+    pthread_mutex_unlock(&load->lock);
+    return collection_published(load->collection);
+}
+
+CardCollection* collection_load_finish(CollectionLoad *load) {
+    CardCollection *collection = load->collection;
+
+    pthread_join(load->thread, NULL);
+    collection->loading = 0;
+    collection->on_publish = NULL;
+    collection->publish_data = NULL;
+
+    if (load->state == ASYNC_LOAD_FAILED) {
+        delete_collection(collection);
+        collection = NULL;
+    }
+    load_free(load);
+    return collection;
+}
+
+void collection_load_cancel(CollectionLoad *load) {
+    if (!load) return;
+    __atomic_store_n(&load->collection->cancel, 1, __ATOMIC_RELAXED);
+    delete_collection(collection_load_finish(load));
+}
@@ -1,107 +1,90 @@
 #include "../include/card.h"
 
-#define FIELD_SEPARATOR "\x1f"  // Anki uses this separator between fields
+static StringView trim_view(const char *start, const char *end) {
+    while (start < end && isspace((unsigned char)*start)) start++;
+    while (end > start && isspace((unsigned char)end[-1])) end--;
 
-// Function to extract first meaning from HTML
-char* extract_first_meaning_from_html(const char *html_str) {
-    if (!html_str) return NULL;
-    
-    // Look for yomitan-glossary class
-    const char *glossary_start = strstr(html_str, "yomitan-glossary");
-    if (!glossary_start) {
-        // No HTML structure, return as is
-        return strdup(html_str);
-    }
-    
-    // Find the first inner <div> after yomitan-glossary
-    const char *first_div = strstr(glossary_start, "<div>");
-    if (!first_div) return NULL;
-    
-    // Move past the opening <div>
-    first_div += 5; // length of "<div>"
-    
-    // Find the closing </div>
-    const char *div_end = strstr(first_div, "</div>");
-    if (!div_end) return NULL;
+    StringView view = {start, (size_t)(end - start)};
+    return view;
+}
+
+// Split the first three fields in a single pass, without copying. Empty
+// fields keep their position; scanning stops once the meaning is found.
+int split_card_fields(const char *fields_str, size_t len, CardFieldViews *views) {
+    if (!fields_str || !views) return -1;
     
-    // Calculate length of content
-    size_t content_len = div_end - first_div;
+    StringView *slots[] = {&views->word, &views->reading, &views->meaning};
+    const char *cursor = fields_str;
+    const char *end = fields_str + len;
     
-    // Allocate and copy the content
-    char *result = (char *)malloc(content_len + 1);
-    if (result) {
-        strncpy(result, first_div, content_len);
-        result[content_len] = '\0';
+    for (int field_index = 0; field_index < 3; field_index++) {
+        if (cursor > end) return -1;  // Note has fewer than three fields
+        
+        const char *sep = memchr(cursor, FIELD_SEPARATOR_CHAR, end - cursor);
+        const char *field_end = sep ? sep : end;
+        
+        *slots[field_index] = trim_view(cursor, field_end);
+        cursor = field_end + 1;
     }
     
-    return result;
+    return 0;
 }
 
-// Function to parse fields from the note
-int parse_card_fields(const char *fields_str, CardData *card) {
-    if (!fields_str || !card) return -1;
-    
-    // Make a copy of the string to tokenize
-    char *fields_copy = strdup(fields_str);
-    if (!fields_copy) return -1;
+// The fields a card keeps, as views into the note and its meaning decoded
+// into the caller's buffer of MEANING_BUFFER_SIZE. Returns the meaning's
+// length, or -1 for a note that makes no card.
+static int extract_card_fields(const char *fields_str, size_t len, CardFieldViews *views,
+                               char *meaning) {
+    if (!fields_str) return -1;
+    if (split_card_fields(fields_str, len, views) < 0) return -1;
     
-    // Initialize card fields
-    card->word = NULL;
-    card->word_reading = NULL;
-    card->word_meaning = NULL;
+    // A card needs something to show and something to type
+    if (views->word.len == 0 || views->reading.len == 0) return -1;
     
-    // Parse fields using the separator
-    char *saveptr;
-    char *token;
-    int field_index = 0;
+    return html_extract_glossary(views->meaning.ptr, views->meaning.len,
+                                 MEANING_ENTRIES, meaning, MEANING_BUFFER_SIZE);
+}
+
+// Function to parse fields from the note into arena-backed strings
+int parse_card_fields(const char *fields_str, size_t len, CardData *card, StringArena *arena) {
+    if (!card || !arena) return -1;
     
-    token = strtok_r(fields_copy, FIELD_SEPARATOR, &saveptr);
-    while (token != NULL && field_index < 13) {
-        // Trim whitespace
-        while (*token && isspace(*token)) token++;
-        char *end = token + strlen(token) - 1;
-        while (end > token && isspace(*end)) *end-- = '\0';
-        
-        switch (field_index) {
-            case 0:  // Word
-                card->word = strdup(token);
-                break;
-            case 1:  // Word Reading
-                card->word_reading = strdup(token);
-                break;
-            case 2:  // Word Meaning
-                card->word_meaning = extract_first_meaning_from_html(token);
-                break;
-            // Skip other fields (3-12)
-        }
-        
-        field_index++;
-        token = strtok_r(NULL, FIELD_SEPARATOR, &saveptr);
-    }
+    CardFieldViews views;
+    char meaning[MEANING_BUFFER_SIZE];
+    int meaning_len = extract_card_fields(fields_str, len, &views, meaning);
+    if (meaning_len < 0) return -1;
     
-    free(fields_copy);
+    card->word = arena_strndup(arena, views.word.ptr, views.word.len);
+    card->word_reading = arena_strndup(arena, views.reading.ptr, views.reading.len);
+    card->word_meaning = arena_strndup(arena, meaning, meaning_len);
+    card->answers = NULL;
+    card->answer_count = 0;
     
     // Check if we got all required fields
     if (!card->word || !card->word_reading || !card->word_meaning) {
-        free_card_data(card);
         return -1;
     }
     
     return 0;
 }
 
-// Function to free card data
-void free_card_data(CardData *card) {
-    if (card->word) {
-        free(card->word);
-        card->word = NULL;
-    }
-    if (card->word_reading) {
-        free(card->word_reading);
-        card->word_reading = NULL;
-    }
-    if (card->word_meaning) {
-        free(card->word_meaning);
-        card->word_meaning = NULL;
-    }
+int parse_card_fields_shared(const char *fields_str, size_t len, CardData *card,
+                             SharedInternTable *strings) {
+    if (!card || !strings) return -1;
+    
+    CardFieldViews views;
+    char meaning[MEANING_BUFFER_SIZE];
+    int meaning_len = extract_card_fields(fields_str, len, &views, meaning);
+    if (meaning_len < 0) return -1;
+    
+    pthread_mutex_lock(&strings->lock);
+    card->word = (char *)intern_stringn(&strings->table, views.word.ptr, views.word.len, NULL);
+    card->word_reading = (char *)intern_stringn(&strings->table, views.reading.ptr,
+                                                views.reading.len, NULL);
+    card->word_meaning = (char *)intern_stringn(&strings->table, meaning, meaning_len, NULL);
+    pthread_mutex_unlock(&strings->lock);
+    card->answers = NULL;
+    card->answer_count = 0;
+    
+    return card->word && card->word_reading && card->word_meaning ? 0 : -1;
 }
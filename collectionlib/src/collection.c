@@ -1,151 +1,421 @@
 
 #include "../include/collection.h"
+#include "../include/loader.h"
+#include "../include/deck_cache.h"
+#include "../include/deck.h"
+#include "../include/log.h"
+#include "../include/reading.h"
+#include "../include/refresh.h"
+#include "../include/schedule.h"
+#include "../include/trace.h"
 #include <stdio.h>
+#include <sys/mman.h>
+#include <time.h>
 
 // Function to free all cards
 void free_card_collection(CardCollection *collection) {
-    for (int i = 0; i < collection->count; i++) {
-        free_card_data(&collection->cards[i]);
+    free(collection->cards);
+    free(collection->schedule);
+    free(collection->card_sources);
+    free(collection->retired);
+    free(collection->deck_ids);
+    arena_free(&collection->strings);
+    if (collection->mapping) {
+        munmap(collection->mapping, collection->mapping_size);
+        collection->mapping = NULL;
+        collection->mapping_size = 0;
     }
+    collection->cards = NULL;
+    collection->schedule = NULL;
+    collection->card_sources = NULL;
+    collection->source_count = 0;
+    collection->retired = NULL;
+    collection->refresh_mod = 0;
+    collection->deck_ids = NULL;
+    collection->deck_count = 0;
     collection->count = 0;
+    collection->published = 0;
+    collection->capacity = 0;
+}
+
+// Grow the card array so it can hold at least min_capacity cards
+int collection_reserve(CardCollection *collection, int min_capacity) {
+    if (min_capacity <= collection->capacity) return 0;
+    
+    // Moving the array would pull it out from under an async reader
+    if (collection->loading && collection_published(collection) > 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Card array is published, cannot grow it to %d cards",
+                       min_capacity);
+        return -1;
+    }
+
+    int capacity = collection->capacity ? collection->capacity : INITIAL_CARD_CAPACITY;
+    while (capacity < min_capacity) capacity *= 2;
+
+    CardData *cards = realloc(collection->cards, capacity * sizeof(CardData));
+    if (!cards) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to grow card array to %d cards", capacity);
+        return -1;
+    }
+
+    collection->cards = cards;
+    collection->capacity = capacity;
+    return 0;
+}
+
+int collection_published(const CardCollection *collection) {
+    return collection ? __atomic_load_n(&collection->published, __ATOMIC_ACQUIRE) : 0;
+}
+
+void collection_publish(CardCollection *collection) {
+    if (collection->count == collection->published) return;
+    
+    // Readings are normalized once, here, whichever loader made the cards,
+    // unless they came with answers from the deck cache or are only passing
+    // through to a union. A card left without answers just cannot be typed.
+    for (int i = collection->published; i < collection->count && !collection->defer_answers; i++) {
+        if (collection->cards[i].answers) continue;
+        if (card_prepare_answers(&collection->cards[i], &collection->strings) < 0) {
+            COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to normalize the reading of card %d", i);
+        }
+    }
+    
+    // Release: a reader that sees the new count also sees the cards
+    __atomic_store_n(&collection->published, collection->count, __ATOMIC_RELEASE);
+    if (collection->on_publish) collection->on_publish(collection->publish_data, collection->count);
+}
+
+void report_card(const CardData *card, int index, long long card_id, long long note_id) {
+    collection_log_write(COLLECTION_LOG_DEBUG, "\n--- Card %d (Card ID: %lld, Note ID: %lld) ---\n"
+                         "Word: %s\nWord Reading: %s\nWord Meaning: %s",
+                         index + 1, card_id, note_id,
+                         card->word, card->word_reading, card->word_meaning);
 }
 
 // Function to extract cards from a deck
-int extract_cards_from_deck(size_t deck_id, CardCollection *collection) {
+int extract_cards_from_deck(size_t deck_id, CardCollection *collection, int threads) {
+    TRACE_SCOPE("extract_cards_from_deck");
     sqlite3 *db = collection->db;
     sqlite3_stmt *stmt;
     const char *sql = 
         "SELECT n.id, n.flds, c.id "
         "FROM cards c "
         "JOIN notes n ON c.nid = n.id "
-        "WHERE c.did = ? "
-        "LIMIT ?;";
-    
-    collection->count = 0;
+        "WHERE c.did = ?;";
     
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "Failed to prepare cards query: %s\n", sqlite3_errmsg(db));
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to prepare cards query: %s", sqlite3_errmsg(db));
         return -1;
     }
     
     sqlite3_bind_int64(stmt, 1, deck_id);
-    sqlite3_bind_int(stmt, 2, MAX_CARDS);
     
-    printf("\n=== EXTRACTING CARDS FROM DECK %zu ===\n", deck_id);
+    COLLECTION_LOG(COLLECTION_LOG_INFO, "\n=== EXTRACTING CARDS FROM DECK %zu ===", deck_id);
+    
+    if (loader_thread_count(threads) > 1) {
+        int loaded = load_cards_parallel(stmt, collection, threads);
+        sqlite3_finalize(stmt);
+        if (loaded < 0) return -1;
+        
+        COLLECTION_LOG(COLLECTION_LOG_INFO, "\n=== TOTAL CARDS EXTRACTED: %d ===", collection->count);
+        return collection->count;
+    }
     
-    while (sqlite3_step(stmt) == SQLITE_ROW && collection->count < MAX_CARDS) {
+    while (!__atomic_load_n(&collection->cancel, __ATOMIC_RELAXED) && sqlite3_step(stmt) == SQLITE_ROW) {
         long long note_id = sqlite3_column_int64(stmt, 0);
         const char *fields = (const char*)sqlite3_column_text(stmt, 1);
+        int fields_len = sqlite3_column_bytes(stmt, 1);
         long long card_id = sqlite3_column_int64(stmt, 2);
         
         if (!fields) continue;
         
+        if (collection_reserve(collection, collection->count + 1) < 0) {
+            sqlite3_finalize(stmt);
+            return -1;
+        }
+        
         CardData *card = &collection->cards[collection->count];
         
-        if (parse_card_fields(fields, card) == 0) {
-            printf("\n--- Card %d (Card ID: %lld, Note ID: %lld) ---\n", 
-                   collection->count + 1, card_id, note_id);
-            printf("Word: %s\n", card->word);
-            printf("Word Reading: %s\n", card->word_reading);
-            printf("Word Meaning: %s\n", card->word_meaning);
-            
+        int parsed = collection->shared_strings
+                     ? parse_card_fields_shared(fields, fields_len, card, collection->shared_strings)
+                     : parse_card_fields(fields, fields_len, card, &collection->strings);
+        if (parsed == 0) {
+            card->card_id = card_id;
+            if (COLLECTION_LOG_ENABLED(COLLECTION_LOG_DEBUG)) {
+                report_card(card, collection->count, card_id, note_id);
+            }
             collection->count++;
+            if (collection->count - collection->published >= COLLECTION_PUBLISH_CARDS) {
+                collection_publish(collection);
+            }
         }
     }
     
     sqlite3_finalize(stmt);
+    collection_publish(collection);
+    if (__atomic_load_n(&collection->cancel, __ATOMIC_RELAXED)) return -1;
     
-    printf("\n=== TOTAL CARDS EXTRACTED: %d ===\n", collection->count);
+    COLLECTION_LOG(COLLECTION_LOG_INFO, "\n=== TOTAL CARDS EXTRACTED: %d ===", collection->count);
     
     return collection->count;
 }
 
-size_t find_deck_by_name(sqlite3 *db, const char *target_deck_name) {
+void collection_default_options(CollectionOptions *options) {
+    options->threads = LOADER_AUTO_THREADS;
+    options->cache_dir = NULL;
+    options->include_subdecks = 0;
+    options->load_schedule = 0;
+}
+
+// Resolve the requested deck, and its subdecks when asked. The returned
+// DeckInfo has the deck's id and the newest mtime/usn of any included deck.
+static int resolve_decks(CardCollection *collection, const char *deck_name,
+                         int include_subdecks, DeckList *decks, DeckInfo *key) {
+    TRACE_SCOPE("resolve_decks");
+    
+    if (!include_subdecks) {
+        if (deck_find(collection, deck_name, key) < 0) return -1;
+        
+        decks->entries = malloc(sizeof(DeckListEntry));
+        if (!decks->entries) return -1;
+        decks->entries[0].info = *key;
+        decks->entries[0].name = NULL;
+        decks->count = decks->capacity = 1;
+        return 0;
+    }
+    
+    if (deck_find_with_children(collection, deck_name, decks) < 0) return -1;
+    
+    *key = decks->entries[0].info;
+    for (int i = 1; i < decks->count; i++) {
+        if (decks->entries[i].info.mtime_secs > key->mtime_secs) {
+            key->mtime_secs = decks->entries[i].info.mtime_secs;
+        }
+        if (decks->entries[i].info.usn > key->usn) key->usn = decks->entries[i].info.usn;
+    }
+    return 0;
+}
+
+CardCollection* setup_collection(const char *db_path, const char *deck_name) {
+    CollectionOptions options;
+    collection_default_options(&options);
+    return setup_collection_with_options(db_path, deck_name, &options);
+}
+
+CardCollection* collection_create(void) {
+    CardCollection *collection = calloc(1, sizeof(CardCollection));
+    if (!collection) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to allocate collection");
+        return NULL;
+    }
+    arena_init(&collection->strings, ARENA_DEFAULT_BLOCK_SIZE);
+    return collection;
+}
+
+// Cards in the included decks, so the array is allocated once and never
+// moves while an async reader holds the published prefix
+static int count_deck_cards(CardCollection *collection) {
     sqlite3_stmt *stmt;
-    size_t ret = 0;
+    int total = 0;
     
-    // Now query the decks table directly
-    printf("\n=== QUERYING DECKS TABLE ===\n");
-    const char *decks_sql = "SELECT id, name, mtime_secs, usn FROM decks;";
+    if (sqlite3_prepare_v2(collection->db, "SELECT COUNT(*) FROM cards WHERE did = ?;", -1,
+                           &stmt, NULL) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to prepare card count: %s",
+                       sqlite3_errmsg(collection->db));
+        return -1;
+    }
+    for (int i = 0; i < collection->deck_count; i++) {
+        sqlite3_bind_int64(stmt, 1, collection->deck_ids[i]);
+        if (sqlite3_step(stmt) == SQLITE_ROW) total += sqlite3_column_int(stmt, 0);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return total;
+}
+
+// Count and extract inside one read transaction, so the count holds and
+// the refresh point matches what was read
+static int extract_cards(CardCollection *collection, int threads) {
+    int cards_extracted = 0;
+    long long now = (long long)time(NULL);
     
-    if (sqlite3_prepare_v2(db, decks_sql, -1, &stmt, NULL) != SQLITE_OK) {
-        fprintf(stderr, "Failed to prepare decks query: %s\n", sqlite3_errmsg(db));
-        return 0;
+    sqlite3_exec(collection->db, "BEGIN;", NULL, NULL, NULL);
+    
+    if (collection_refresh_mark(collection, now) < 0) {
+        COLLECTION_LOG(COLLECTION_LOG_INFO, "No refresh point; edits show after a reload");
+    }
+    int expected = count_deck_cards(collection);
+    if (expected < 0 || collection_reserve(collection, expected) < 0) cards_extracted = -1;
+    
+    for (int i = 0; i < collection->deck_count && cards_extracted >= 0; i++) {
+        cards_extracted = extract_cards_from_deck(collection->deck_ids[i], collection, threads);
     }
     
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        long long deck_id = sqlite3_column_int64(stmt, 0);
-        const char *deck_name = (const char*)sqlite3_column_text(stmt, 1);
-        long long mtime = sqlite3_column_int64(stmt, 2);
-        int usn = sqlite3_column_int(stmt, 3);
+    sqlite3_exec(collection->db, "COMMIT;", NULL, NULL, NULL);
+    return cards_extracted;
+}
+
+// Every deck behind the given names, each once, into collection->deck_ids.
+// The DeckInfo that keys the deck cache has the newest mtime/usn of them all
+// and, as its id, a hash of include_subdecks and the deck ids in load order:
+// a deck with and without its subdecks, or after one moved out of its
+// hierarchy, is a different set of cards and must not share a cache.
+static int resolve_deck_set(CardCollection *collection, const char **deck_names, int name_count,
+                            int include_subdecks, DeckInfo *key) {
+    uint64_t id_hash = 0xcbf29ce484222325ULL;
+    
+    id_hash = (id_hash ^ (include_subdecks ? 1 : 0)) * 0x100000001b3ULL;
+    
+    for (int n = 0; n < name_count; n++) {
+        DeckList decks;
+        DeckInfo info;
+        deck_list_init(&decks);
         
-        if (!deck_name) continue;
+        if (resolve_decks(collection, deck_names[n], include_subdecks, &decks, &info) < 0) {
+            COLLECTION_LOG(COLLECTION_LOG_ERROR, "Deck not found: %s", deck_names[n]);
+            deck_list_free(&decks);
+            return -1;
+        }
+        COLLECTION_LOG(COLLECTION_LOG_INFO, "Target deck found at ID: %lld (%d deck%s)",
+                       info.id, decks.count, decks.count == 1 ? "" : "s");
         
-        // Check if this is the target deck
-        int is_target = (target_deck_name && strcmp(deck_name, target_deck_name) == 0);
+        long long *ids = realloc(collection->deck_ids,
+                                 (collection->deck_count + decks.count) * sizeof(long long));
+        if (!ids) {
+            deck_list_free(&decks);
+            return -1;
+        }
+        collection->deck_ids = ids;
         
-        // Print deck information
-        printf("Deck ID: %lld\n", deck_id);
-        printf("Deck Name: %s\n", deck_name);
-        printf("Modified Time: %lld\n", mtime);
-        printf("USN: %d\n", usn);
-        printf("---\n");
+        // Overlapping names, say a deck and one of its subdecks, load once
+        for (int i = 0; i < decks.count; i++) {
+            long long id = decks.entries[i].info.id;
+            int seen = 0;
+            for (int j = 0; j < collection->deck_count && !seen; j++) seen = ids[j] == id;
+            if (seen) continue;
+            
+            ids[collection->deck_count++] = id;
+            for (int b = 0; b < 8; b++) {
+                id_hash ^= (uint64_t)id >> (b * 8) & 0xFF;
+                id_hash *= 0x100000001b3ULL;
+            }
+        }
+        deck_list_free(&decks);
         
-        if (is_target) {
-            ret = deck_id;
+        if (n == 0) {
+            *key = info;
+        } else {
+            if (info.mtime_secs > key->mtime_secs) key->mtime_secs = info.mtime_secs;
+            if (info.usn > key->usn) key->usn = info.usn;
         }
     }
     
-    sqlite3_finalize(stmt);
-    return ret;
+    key->id = (long long)(id_hash >> 1);
+    return 0;
 }
 
-CardCollection* setup_collection(const char *db_path, const char *deck_name) {
+int collection_load_into(CardCollection *collection, const char *db_path, const char *deck_name,
+                         const CollectionOptions *options) {
+    return collection_load_decks(collection, db_path, &deck_name, 1, options);
+}
 
-    CardCollection *collection = malloc(sizeof(CardCollection));
-    if (!collection) {
-        fprintf(stderr, "Failed to allocate collection\n");
-        return NULL;
+int collection_load_decks(CardCollection *collection, const char *db_path, const char **deck_names,
+                          int name_count, const CollectionOptions *options) {
+    TRACE_SCOPE("setup_collection");
+    DeckInfo deck;
+    
+    if (collection_open_decks(collection, db_path, deck_names, name_count,
+                              options->include_subdecks, &deck) < 0) {
+        return -1;
     }
+    return collection_load_cards(collection, db_path, &deck, options);
+}
 
+int collection_open_decks(CardCollection *collection, const char *db_path, const char **deck_names,
+                          int name_count, int include_subdecks, DeckInfo *key) {
     // Open database
     if (sqlite3_open(db_path, &collection->db) != SQLITE_OK) {
-        fprintf(stderr, "Cannot open database: %s\n", sqlite3_errmsg(collection->db));
-        return NULL;
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Cannot open database: %s", sqlite3_errmsg(collection->db));
+        return -1;
     }
     
-    printf("Opened Anki collection: %s\n\n", db_path);
-    size_t deck_id = find_deck_by_name(collection->db, deck_name);
+    COLLECTION_LOG(COLLECTION_LOG_INFO, "Opened Anki collection: %s\n", db_path);
+    register_anki_collations(collection->db);
     
-    if (deck_id == 0) {
-        printf("Deck not found.\n");
-        sqlite3_close(collection->db);
-        return NULL;
-    }
+    if (name_count < 1) return -1;
+    return resolve_deck_set(collection, deck_names, name_count, include_subdecks, key);
+}
+
+int collection_load_cards(CardCollection *collection, const char *db_path, const DeckInfo *deck,
+                          const CollectionOptions *options) {
+    // A precompiled cache for an unchanged deck replaces the whole extraction
+    char cache_path[1024];
+    int use_cache = options->cache_dir &&
+                    deck_cache_path(options->cache_dir, db_path, deck->id,
+                                    cache_path, sizeof(cache_path)) == 0;
     
-    printf("Target deck found at ID: %zu\n", deck_id);
+    if (use_cache && deck_cache_load(cache_path, db_path, deck, collection) == 0) {
+        COLLECTION_LOG(COLLECTION_LOG_INFO, "Loaded %d cards from deck cache %s",
+                       collection->count, cache_path);
+        
+        // Editing notes leaves the deck row alone, so the cache can be
+        // behind on them; catch up from where it was written
+        collection_refresh(collection, NULL);
+        collection_publish(collection);
+    } else {
+        // Extract cards from the deck and any included subdecks
+        if (extract_cards(collection, options->threads) < 0) {
+            if (!__atomic_load_n(&collection->cancel, __ATOMIC_RELAXED)) {
+                COLLECTION_LOG(COLLECTION_LOG_ERROR, "Error extracting cards.");
+            }
+            return -1;
+        }
+        
+        if (use_cache) {
+            deck_cache_save(cache_path, db_path, deck, collection);
+        }
+        
+        // The cards are now stored in memory in the collection structure
+        COLLECTION_LOG(COLLECTION_LOG_INFO, "\n=== CARDS SUCCESSFULLY LOADED INTO MEMORY ===");
+        COLLECTION_LOG(COLLECTION_LOG_DEBUG, "Example: collection.cards[0].word = \"%s\"", 
+                       collection->count > 0 ? collection->cards[0].word : "N/A");
+    }
     
-    // Extract cards from the deck
-    int cards_extracted = extract_cards_from_deck(deck_id, collection);
+    // Review data changes with every Anki session, so it is never cached
+    if (options->load_schedule && collection_load_schedule(collection) < 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "No review data; cards will be unscheduled");
+    }
+
+    return 0;
+}
+
+CardCollection* setup_collection_with_options(const char *db_path, const char *deck_name,
+                                              const CollectionOptions *options) {
+    CardCollection *collection = collection_create();
+    if (!collection) return NULL;
     
-    if (cards_extracted < 0) {
-        printf("Error extracting cards.\n");
-        free_card_collection(collection);
-        sqlite3_close(collection->db);
+    if (collection_load_into(collection, db_path, deck_name, options) < 0) {
+        delete_collection(collection);
         return NULL;
     }
-    
-    // The cards are now stored in memory in the collection structure
-    printf("\n=== CARDS SUCCESSFULLY LOADED INTO MEMORY ===\n");
-    printf("You can now access the cards through the collection structure.\n");
-    printf("Example: collection.cards[0].word = \"%s\"\n", 
-           collection->count > 0 ? collection->cards[0].word : "N/A");
-
     return collection;
 }
 
 void delete_collection(CardCollection *collection) {
+    if (!collection) return;
+    
     // Clean up
     free_card_collection(collection);
-    sqlite3_close(collection->db);    
+    collection_refresh_free(collection);
+    deck_finalize_statements(collection);
+    sqlite3_close(collection->db);
+    free(collection);
+}
+
+int collection_count(const CardCollection *collection) {
+    return collection ? collection->count : 0;
+}
+
+int collection_capacity(const CardCollection *collection) {
+    return collection ? collection->capacity : 0;
 }
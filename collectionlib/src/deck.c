@@ -0,0 +1,191 @@
+#include "../include/deck.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/log.h"
+#include "../include/unicase.h"
+
+#define DECK_NAME_MAX 512
+#define INITIAL_DECK_CAPACITY 16
+
+static const char *find_deck_sql =
+    "SELECT id, mtime_secs, usn FROM decks WHERE name = ?;";
+
+// Children sort between "Parent\x1f" and "Parent\x20", so the name index
+// serves the range directly
+static const char *find_children_sql =
+    "SELECT id, name, mtime_secs, usn FROM decks "
+    "WHERE name = ?1 OR (name > ?1 || char(31) AND name < ?1 || char(32)) "
+    "ORDER BY name;";
+
+static const char *list_decks_sql =
+    "SELECT id, name, mtime_secs, usn FROM decks ORDER BY name;";
+
+// Anki's unicase collation; it has to order names exactly as Anki does, or
+// lookups through the index Anki built would miss rows
+static int unicase_collate(void *arg, int len_a, const void *a, int len_b, const void *b) {
+    (void)arg;
+    return unicase_compare(a, (size_t)len_a, b, (size_t)len_b);
+}
+
+int register_anki_collations(sqlite3 *db) {
+    if (sqlite3_create_collation(db, "unicase", SQLITE_UTF8, NULL, unicase_collate) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to register unicase collation: %s",
+                       sqlite3_errmsg(db));
+        return -1;
+    }
+    return 0;
+}
+
+// Convert between the "::" form users type and the 0x1F form Anki stores
+static int convert_separators(const char *name, const char *from, const char *to,
+                              char *out, size_t size) {
+    size_t from_len = strlen(from);
+    size_t to_len = strlen(to);
+    size_t len = 0;
+
+    while (*name) {
+        if (strncmp(name, from, from_len) == 0) {
+            if (len + to_len >= size) return -1;
+            memcpy(out + len, to, to_len);
+            len += to_len;
+            name += from_len;
+        } else {
+            if (len + 1 >= size) return -1;
+            out[len++] = *name++;
+        }
+    }
+    out[len] = '\0';
+    return 0;
+}
+
+static int prepare_cached(sqlite3 *db, sqlite3_stmt **stmt, const char *sql) {
+    if (*stmt) {
+        sqlite3_reset(*stmt);
+        sqlite3_clear_bindings(*stmt);
+        return 0;
+    }
+    if (sqlite3_prepare_v2(db, sql, -1, stmt, NULL) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to prepare decks query: %s", sqlite3_errmsg(db));
+        *stmt = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int deck_find(CardCollection *collection, const char *name, DeckInfo *info) {
+    char db_name[DECK_NAME_MAX];
+    int found = 0;
+
+    if (!name || convert_separators(name, DECK_NAME_SEPARATOR, DECK_NAME_SEPARATOR_DB,
+                                    db_name, sizeof(db_name)) < 0) {
+        return -1;
+    }
+    if (prepare_cached(collection->db, &collection->find_deck_stmt, find_deck_sql) < 0) return -1;
+
+    sqlite3_stmt *stmt = collection->find_deck_stmt;
+    sqlite3_bind_text(stmt, 1, db_name, -1, SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        info->id = sqlite3_column_int64(stmt, 0);
+        info->mtime_secs = sqlite3_column_int64(stmt, 1);
+        info->usn = sqlite3_column_int(stmt, 2);
+        found = 1;
+    }
+
+    sqlite3_reset(stmt);
+    return found ? 0 : -1;
+}
+
+void deck_list_init(DeckList *list) {
+    list->entries = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    arena_init(&list->names, 4096);
+}
+
+void deck_list_free(DeckList *list) {
+    free(list->entries);
+    arena_free(&list->names);
+    list->entries = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+// Append every row of a (id, name, mtime_secs, usn) query to the list
+static int collect_decks(sqlite3_stmt *stmt, DeckList *list) {
+    char display[DECK_NAME_MAX];
+    int rc;
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const char *name = (const char*)sqlite3_column_text(stmt, 1);
+        if (!name) continue;
+
+        if (list->count == list->capacity) {
+            int capacity = list->capacity ? list->capacity * 2 : INITIAL_DECK_CAPACITY;
+            DeckListEntry *entries = realloc(list->entries, capacity * sizeof(DeckListEntry));
+            if (!entries) return -1;
+            list->entries = entries;
+            list->capacity = capacity;
+        }
+
+        DeckListEntry *entry = &list->entries[list->count];
+        entry->info.id = sqlite3_column_int64(stmt, 0);
+        entry->info.mtime_secs = sqlite3_column_int64(stmt, 2);
+        entry->info.usn = sqlite3_column_int(stmt, 3);
+
+        if (convert_separators(name, DECK_NAME_SEPARATOR_DB, DECK_NAME_SEPARATOR,
+                               display, sizeof(display)) < 0) {
+            continue;
+        }
+        entry->name = arena_strdup(&list->names, display);
+        if (!entry->name) return -1;
+        list->count++;
+    }
+
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+int deck_find_with_children(CardCollection *collection, const char *name, DeckList *list) {
+    char db_name[DECK_NAME_MAX];
+
+    if (!name || convert_separators(name, DECK_NAME_SEPARATOR, DECK_NAME_SEPARATOR_DB,
+                                    db_name, sizeof(db_name)) < 0) {
+        return -1;
+    }
+    if (prepare_cached(collection->db, &collection->find_children_stmt, find_children_sql) < 0) {
+        return -1;
+    }
+
+    sqlite3_stmt *stmt = collection->find_children_stmt;
+    sqlite3_bind_text(stmt, 1, db_name, -1, SQLITE_TRANSIENT);
+
+    int rc = collect_decks(stmt, list);
+    sqlite3_reset(stmt);
+
+    if (rc < 0) return -1;
+    return list->count > 0 ? list->count : -1;
+}
+
+int deck_list_all(CardCollection *collection, DeckList *list) {
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(collection->db, list_decks_sql, -1, &stmt, NULL) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to prepare decks query: %s",
+                       sqlite3_errmsg(collection->db));
+        return -1;
+    }
+
+    int rc = collect_decks(stmt, list);
+    sqlite3_finalize(stmt);
+    return rc < 0 ? -1 : list->count;
+}
+
+void deck_finalize_statements(CardCollection *collection) {
+    sqlite3_finalize(collection->find_deck_stmt);
+    sqlite3_finalize(collection->find_children_stmt);
+    collection->find_deck_stmt = NULL;
+    collection->find_children_stmt = NULL;
+}
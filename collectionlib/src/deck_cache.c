@@ -0,0 +1,274 @@
+#include "../include/deck_cache.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/log.h"
+#include "../include/trace.h"
+
+// FNV-1a, used to give each collection path its own cache file name
+static uint64_t hash_path(const char *path) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        hash ^= *p;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+int deck_cache_path(const char *cache_dir, const char *db_path, long long deck_id,
+                    char *out, size_t size) {
+    int n = snprintf(out, size, "%s/%016llx-%lld%s", cache_dir,
+                     (unsigned long long)hash_path(db_path), deck_id, DECK_CACHE_EXTENSION);
+    return (n < 0 || (size_t)n >= size) ? -1 : 0;
+}
+
+// The sections must follow each other inside the file, with the string blob
+// ending it; compared by subtraction so no corrupt size can wrap around
+static int sections_fit(const DeckCacheHeader *header, size_t file_size) {
+    if (header->entries_offset < sizeof(DeckCacheHeader) ||
+        header->answers_offset < header->entries_offset ||
+        header->strings_offset < header->answers_offset || header->strings_offset > file_size) {
+        return 0;
+    }
+    uint64_t entries_size = header->answers_offset - header->entries_offset;
+    uint64_t answers_size = header->strings_offset - header->answers_offset;
+    if (header->card_count > INT_MAX ||
+        header->card_count > entries_size / sizeof(DeckCacheEntry) ||
+        header->answer_count > answers_size / sizeof(DeckCacheAnswer)) {
+        return 0;
+    }
+    return header->strings_size == file_size - header->strings_offset;
+}
+
+static int header_matches(const DeckCacheHeader *header, size_t file_size,
+                          const char *db_path, const DeckInfo *deck) {
+    if (memcmp(header->magic, DECK_CACHE_MAGIC, sizeof(header->magic)) != 0) return 0;
+    if (header->version != DECK_CACHE_VERSION) return 0;
+    if (header->meaning_entries != MEANING_ENTRIES) return 0;
+
+    // Stale if the deck changed since the cache was written
+    if (header->deck_id != deck->id || header->mtime_secs != deck->mtime_secs ||
+        header->usn != deck->usn) {
+        return 0;
+    }
+
+    if (!sections_fit(header, file_size)) return 0;
+    const char *strings = (const char *)header + header->strings_offset;
+    if (header->strings_size == 0 || strings[header->strings_size - 1] != '\0') return 0;
+    if (header->db_path_offset >= header->strings_size) return 0;
+
+    return strcmp(strings + header->db_path_offset, db_path) == 0;
+}
+
+// Every offset and index in the answers and entries, checked before the
+// collection is touched so a corrupt file cannot leave it half overwritten
+static int entries_valid(const DeckCacheHeader *header) {
+    const char *base = (const char *)header;
+    const DeckCacheEntry *entries = (const DeckCacheEntry *)(base + header->entries_offset);
+    const DeckCacheAnswer *saved = (const DeckCacheAnswer *)(base + header->answers_offset);
+    uint64_t strings_size = header->strings_size;
+
+    for (uint32_t i = 0; i < header->answer_count; i++) {
+        if (saved[i].text >= strings_size || saved[i].length >= strings_size - saved[i].text) {
+            return 0;
+        }
+    }
+    for (uint32_t i = 0; i < header->card_count; i++) {
+        const DeckCacheEntry *entry = &entries[i];
+        if (entry->word >= strings_size || entry->reading >= strings_size ||
+            entry->meaning >= strings_size ||
+            (header->source_count && entry->source >= header->source_count) ||
+            entry->answers > CARD_MAX_ANSWERS || entry->answers > header->answer_count ||
+            entry->first_answer > header->answer_count - entry->answers) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int deck_cache_load(const char *path, const char *db_path, const DeckInfo *deck,
+                    CardCollection *collection) {
+    TRACE_SCOPE("deck_cache_load");
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(DeckCacheHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = st.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return -1;
+
+    const DeckCacheHeader *header = mapping;
+    if (!header_matches(header, size, db_path, deck) || !entries_valid(header)) {
+        munmap(mapping, size);
+        return -1;
+    }
+
+    const char *strings = (const char *)mapping + header->strings_offset;
+    const DeckCacheEntry *entries =
+        (const DeckCacheEntry *)((const char *)mapping + header->entries_offset);
+    const DeckCacheAnswer *saved =
+        (const DeckCacheAnswer *)((const char *)mapping + header->answers_offset);
+    int count = (int)header->card_count;
+
+    // Answers point at their text, so they are the one part not used in place
+    int *sources = NULL;
+    CardAnswer *answers = NULL;
+    if (collection_reserve(collection, count) < 0 ||
+        (header->source_count && !(sources = malloc((count ? count : 1) * sizeof(int)))) ||
+        (header->answer_count &&
+         !(answers = arena_alloc_aligned(&collection->strings,
+                                         header->answer_count * sizeof(CardAnswer),
+                                         _Alignof(CardAnswer))))) {
+        free(sources);
+        munmap(mapping, size);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < header->answer_count; i++) {
+        answers[i].text = strings + saved[i].text;
+        answers[i].length = saved[i].length;
+        answers[i].hash = saved[i].hash;
+    }
+
+    // No parsing: the cards just point into the mapped string blob
+    for (int i = 0; i < count; i++) {
+        const DeckCacheEntry *entry = &entries[i];
+        if (sources) sources[i] = (int)entry->source;
+        CardData *card = &collection->cards[i];
+        card->word = (char *)strings + entry->word;
+        card->word_reading = (char *)strings + entry->reading;
+        card->word_meaning = (char *)strings + entry->meaning;
+        card->card_id = entry->card_id;
+        card->answers = entry->answers ? &answers[entry->first_answer] : NULL;
+        card->answer_count = (int)entry->answers;
+    }
+
+    collection->count = count;
+    if (sources) {
+        free(collection->card_sources);
+        collection->card_sources = sources;
+        collection->source_count = (int)header->source_count;
+    }
+    collection->refresh_mod = header->refresh_mod;
+    collection->refresh_usn = header->refresh_usn;
+    collection->mapping = mapping;
+    collection->mapping_size = size;
+    return 0;
+}
+
+static int write_string(FILE *f, const char *str, uint64_t *offset, uint32_t *out) {
+    size_t len = strlen(str) + 1;
+    if (*offset + len > UINT32_MAX) return -1;
+
+    *out = (uint32_t)*offset;
+    *offset += len;
+    return fwrite(str, 1, len, f) == len ? 0 : -1;
+}
+
+int deck_cache_save(const char *path, const char *db_path, const DeckInfo *deck,
+                    const CardCollection *collection) {
+    TRACE_SCOPE("deck_cache_save");
+    char tmp_path[1024];
+    DeckCacheHeader header;
+    DeckCacheEntry *entries;
+    DeckCacheAnswer *answers;
+    uint32_t answer_count = 0, next_answer = 0;
+    uint64_t offset = 0;
+    int rc = -1;
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return -1;
+
+    for (int i = 0; i < collection->count; i++) answer_count += collection->cards[i].answer_count;
+
+    entries = calloc(collection->count > 0 ? (size_t)collection->count : 1, sizeof(DeckCacheEntry));
+    answers = malloc((answer_count ? answer_count : 1) * sizeof(DeckCacheAnswer));
+    if (!entries || !answers) {
+        free(entries);
+        free(answers);
+        return -1;
+    }
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Cannot write deck cache %s", tmp_path);
+        free(entries);
+        free(answers);
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DECK_CACHE_MAGIC, sizeof(header.magic));
+    header.version = DECK_CACHE_VERSION;
+    header.card_count = collection->count;
+    header.deck_id = deck->id;
+    header.mtime_secs = deck->mtime_secs;
+    header.usn = deck->usn;
+    header.meaning_entries = MEANING_ENTRIES;
+    header.source_count = collection->card_sources ? (uint32_t)collection->source_count : 0;
+    header.refresh_mod = collection->refresh_mod;
+    header.refresh_usn = collection->refresh_usn;
+    header.answer_count = answer_count;
+    header.entries_offset = sizeof(DeckCacheHeader);
+    header.answers_offset = header.entries_offset + (uint64_t)collection->count * sizeof(DeckCacheEntry);
+    header.strings_offset = header.answers_offset + (uint64_t)answer_count * sizeof(DeckCacheAnswer);
+
+    // Strings go straight after the (not yet filled) entry and answer tables
+    if (fseek(f, (long)header.strings_offset, SEEK_SET) != 0 ||
+        write_string(f, db_path, &offset, &header.db_path_offset) < 0) {
+        goto done;
+    }
+    for (int i = 0; i < collection->count; i++) {
+        const CardData *card = &collection->cards[i];
+        entries[i].card_id = card->card_id;
+        entries[i].source = collection->card_sources ? (uint32_t)collection->card_sources[i] : 0;
+        if (write_string(f, card->word, &offset, &entries[i].word) < 0 ||
+            write_string(f, card->word_reading, &offset, &entries[i].reading) < 0 ||
+            write_string(f, card->word_meaning, &offset, &entries[i].meaning) < 0) {
+            goto done;
+        }
+
+        entries[i].first_answer = next_answer;
+        entries[i].answers = (uint32_t)card->answer_count;
+        for (int k = 0; k < card->answer_count; k++) {
+            const CardAnswer *answer = &card->answers[k];
+            DeckCacheAnswer *out = &answers[next_answer++];
+            if (write_string(f, answer->text, &offset, &out->text) < 0) goto done;
+            out->length = answer->length;
+            out->hash = answer->hash;
+        }
+    }
+    header.strings_size = offset;
+
+    if (fseek(f, 0, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, f) != 1 ||
+        fwrite(entries, sizeof(DeckCacheEntry), collection->count, f) != (size_t)collection->count ||
+        fwrite(answers, sizeof(DeckCacheAnswer), header.answer_count, f) != header.answer_count) {
+        goto done;
+    }
+    rc = 0;
+
+done:
+    if (fclose(f) != 0) rc = -1;
+    free(entries);
+    free(answers);
+
+    if (rc == 0 && rename(tmp_path, path) != 0) rc = -1;
+    if (rc != 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to write deck cache %s", path);
+        unlink(tmp_path);
+    }
+    return rc;
+}
@@ -0,0 +1,452 @@
+#include "../include/html.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+#define TAG_NAME_MAX 16
+#define ENTITY_NAME_MAX 10
+#define REPLACEMENT_CHAR 0xFFFD
+
+// Caller-provided output with whitespace collapsing
+typedef struct {
+    char *out;
+    size_t size;
+    size_t len;
+    int pending_space;
+    int need_separator;
+    int full;
+} TextSink;
+
+typedef struct {
+    const char *name;
+    const char *text;
+} NamedEntity;
+
+static const NamedEntity named_entities[] = {
+    {"amp", "&"}, {"lt", "<"}, {"gt", ">"}, {"quot", "\""}, {"apos", "'"},
+    {"nbsp", " "}, {"hellip", "\xE2\x80\xA6"}, {"ndash", "\xE2\x80\x93"},
+    {"mdash", "\xE2\x80\x94"}, {"middot", "\xC2\xB7"},
+    {NULL, NULL}
+};
+
+#define TAG_BLOCK 1     // separates words visually; the tag becomes whitespace
+#define TAG_SKIP 2      // content is never part of the meaning (ruby readings etc.)
+#define TAG_DIV 4
+
+typedef struct {
+    const char *name;
+    int flags;
+} TagClass;
+
+static const TagClass tag_classes[] = {
+    {"div", TAG_BLOCK | TAG_DIV}, {"br", TAG_BLOCK}, {"p", TAG_BLOCK},
+    {"li", TAG_BLOCK}, {"ul", TAG_BLOCK}, {"ol", TAG_BLOCK}, {"tr", TAG_BLOCK},
+    {"td", TAG_BLOCK}, {"table", TAG_BLOCK},
+    {"rt", TAG_SKIP}, {"rp", TAG_SKIP}, {"script", TAG_SKIP}, {"style", TAG_SKIP},
+    {NULL, 0}
+};
+
+// isspace and isalnum in the C locale, without the calls
+static inline int is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline int is_alnum(unsigned char c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+static int classify_tag(const char *name) {
+    for (int i = 0; tag_classes[i].name; i++) {
+        if (tag_classes[i].name[0] == name[0] && strcmp(tag_classes[i].name, name) == 0) {
+            return tag_classes[i].flags;
+        }
+    }
+    return 0;
+}
+
+static void sink_put(TextSink *sink, char c) {
+    if (sink->full) return;
+    if (sink->len + 1 >= sink->size) {
+        sink->full = 1;
+        return;
+    }
+    sink->out[sink->len++] = c;
+}
+
+static void sink_space(TextSink *sink) {
+    if (sink->len > 0) sink->pending_space = 1;
+}
+
+static void sink_text(TextSink *sink, const char *text, size_t len) {
+    const char *p = text;
+    const char *end = text + len;
+
+    while (p < end && !sink->full) {
+        if (is_space((unsigned char)*p)) {
+            sink_space(sink);
+            p++;
+            continue;
+        }
+
+        const char *word = p;
+        while (p < end && !is_space((unsigned char)*p)) p++;
+
+        if (sink->need_separator) {
+            for (const char *s = GLOSSARY_SEPARATOR; *s; s++) sink_put(sink, *s);
+            sink->need_separator = 0;
+            sink->pending_space = 0;
+        }
+        if (sink->pending_space) {
+            sink_put(sink, ' ');
+            sink->pending_space = 0;
+        }
+
+        // Copy the whole word at once, truncating at the buffer end
+        size_t n = p - word;
+        size_t room = sink->size - 1 - sink->len;
+        if (n > room) {
+            n = room;
+            sink->full = 1;
+        }
+        memcpy(sink->out + sink->len, word, n);
+        sink->len += n;
+    }
+}
+
+// Drop a multi-byte sequence cut short by truncation, then terminate
+static size_t sink_finish(TextSink *sink) {
+    if (sink->full && sink->len > 0) {
+        size_t lead = sink->len;
+        int back = 0;
+
+        while (lead > 0 && back < 3 && ((unsigned char)sink->out[lead - 1] & 0xC0) == 0x80) {
+            lead--;
+            back++;
+        }
+        if (lead > 0) {
+            unsigned char c = (unsigned char)sink->out[lead - 1];
+            size_t expected = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : 4;
+            if (lead - 1 + expected > sink->len) sink->len = lead - 1;
+        }
+    }
+    sink->out[sink->len] = '\0';
+    return sink->len;
+}
+
+static size_t encode_utf8(unsigned long cp, char *buf) {
+    if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) cp = REPLACEMENT_CHAR;
+
+    if (cp < 0x80) {
+        buf[0] = (char)cp;
+        return 1;
+    } else if (cp < 0x800) {
+        buf[0] = (char)(0xC0 | (cp >> 6));
+        buf[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        buf[0] = (char)(0xE0 | (cp >> 12));
+        buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    buf[0] = (char)(0xF0 | (cp >> 18));
+    buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    buf[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// Decode the entity starting at p ('&'); returns bytes consumed, 0 if not an entity
+static size_t decode_entity(const char *p, const char *end, char *buf, size_t *buf_len) {
+    const char *semi = NULL;
+    size_t limit = (size_t)(end - p) < ENTITY_NAME_MAX + 2 ? (size_t)(end - p) : ENTITY_NAME_MAX + 2;
+
+    for (size_t i = 1; i < limit; i++) {
+        if (p[i] == ';') {
+            semi = p + i;
+            break;
+        }
+    }
+    if (!semi || semi == p + 1) return 0;
+
+    const char *name = p + 1;
+    size_t name_len = semi - name;
+
+    if (name[0] == '#') {
+        unsigned long cp = 0;
+        int hex = name_len > 1 && (name[1] == 'x' || name[1] == 'X');
+        size_t i = hex ? 2 : 1;
+
+        if (i >= name_len) return 0;
+        for (; i < name_len; i++) {
+            unsigned char c = (unsigned char)name[i];
+            if (hex && isxdigit(c)) cp = cp * 16 + (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+            else if (!hex && isdigit(c)) cp = cp * 10 + (c - '0');
+            else return 0;
+        }
+        *buf_len = encode_utf8(cp, buf);
+        return semi - p + 1;
+    }
+
+    for (int i = 0; named_entities[i].name; i++) {
+        if (strlen(named_entities[i].name) == name_len &&
+            memcmp(named_entities[i].name, name, name_len) == 0) {
+            *buf_len = strlen(named_entities[i].text);
+            memcpy(buf, named_entities[i].text, *buf_len);
+            return semi - p + 1;
+        }
+    }
+    return 0;
+}
+
+// True if the class attribute value contains token as a whole word
+static int class_has_token(const char *value, size_t len, const char *token) {
+    size_t token_len = strlen(token);
+    const char *end = value + len;
+    const char *p = value;
+
+    while (p < end) {
+        while (p < end && is_space((unsigned char)*p)) p++;
+        const char *word = p;
+        while (p < end && !is_space((unsigned char)*p)) p++;
+
+        if ((size_t)(p - word) == token_len && memcmp(word, token, token_len) == 0) return 1;
+    }
+    return 0;
+}
+
+typedef struct {
+    char name[TAG_NAME_MAX];
+    int closing;
+    int self_closing;
+    int is_glossary;
+} Tag;
+
+// Parse the tag starting at p ('<'); returns the position just past '>'.
+// Attributes are only read when want_class asks for the glossary class;
+// otherwise they are skipped, minding quotes, to the closing '>'.
+static const char* parse_tag(const char *p, const char *end, Tag *tag, int want_class) {
+    size_t n = 0;
+
+    memset(tag, 0, sizeof(Tag));
+    p++;
+
+    // Comments and doctypes carry no text
+    if (p < end && *p == '!') {
+        if (end - p >= 3 && p[1] == '-' && p[2] == '-') {
+            for (p += 3; p + 2 < end; p++) {
+                if (p[0] == '-' && p[1] == '-' && p[2] == '>') return p + 3;
+            }
+            return end;
+        }
+        const char *close = memchr(p, '>', end - p);
+        return close ? close + 1 : end;
+    }
+
+    if (p < end && *p == '/') {
+        tag->closing = 1;
+        p++;
+    }
+    while (p < end && is_alnum((unsigned char)*p)) {
+        if (n + 1 < TAG_NAME_MAX) tag->name[n++] = (char)(*p >= 'A' && *p <= 'Z' ? *p | 0x20 : *p);
+        p++;
+    }
+
+    // Same grammar as below, without keeping anything
+    if (!want_class) {
+        while (p < end && *p != '>') {
+            if (*p == '/') tag->self_closing = 1;
+            if (*p++ != '=') continue;
+
+            while (p < end && is_space((unsigned char)*p)) p++;
+            if (p < end && (*p == '"' || *p == '\'')) {
+                const char *close = memchr(p + 1, *p, end - p - 1);
+                p = close ? close + 1 : end;
+            } else {
+                while (p < end && *p != '>' && !is_space((unsigned char)*p)) p++;
+            }
+        }
+        return p < end ? p + 1 : end;
+    }
+
+    // Attributes; quoted values may contain '>'
+    while (p < end && *p != '>') {
+        if (is_space((unsigned char)*p)) {
+            p++;
+            continue;
+        }
+        if (*p == '/') {
+            tag->self_closing = 1;
+            p++;
+            continue;
+        }
+
+        const char *attr = p;
+        while (p < end && *p != '=' && *p != '>' && *p != '/' && !is_space((unsigned char)*p)) p++;
+        size_t attr_len = p - attr;
+
+        while (p < end && is_space((unsigned char)*p)) p++;
+        if (p >= end || *p != '=') continue;
+        p++;
+        while (p < end && is_space((unsigned char)*p)) p++;
+
+        const char *value = p;
+        if (p < end && (*p == '"' || *p == '\'')) {
+            char quote = *p++;
+            value = p;
+            while (p < end && *p != quote) p++;
+        } else {
+            while (p < end && *p != '>' && !is_space((unsigned char)*p)) p++;
+        }
+        size_t value_len = p - value;
+        if (p < end && (*p == '"' || *p == '\'')) p++;
+
+        if (attr_len == 5 && strncasecmp(attr, "class", 5) == 0 &&
+            class_has_token(value, value_len, GLOSSARY_CLASS)) {
+            tag->is_glossary = 1;
+        }
+    }
+
+    return p < end ? p + 1 : end;
+}
+
+// Bounded substring search; memchr finds candidates for the first byte
+static const char* find_in_range(const char *start, const char *end, const char *needle) {
+    size_t needle_len = strlen(needle);
+
+    while ((size_t)(end - start) >= needle_len) {
+        const char *hit = memchr(start, needle[0], end - start - needle_len + 1);
+        if (!hit) return NULL;
+        if (memcmp(hit, needle, needle_len) == 0) return hit;
+        start = hit + 1;
+    }
+    return NULL;
+}
+
+// Jump to the glossary <div> without tokenizing everything before it: find
+// the class name, back up to the enclosing '<' and confirm with a real tag
+// parse. Returns the position just past the opening tag, or NULL.
+static const char* find_glossary(const char *html, const char *end) {
+    const char *from = html;
+    const char *hit;
+
+    while ((hit = find_in_range(from, end, GLOSSARY_CLASS)) != NULL) {
+        const char *open = hit;
+        while (open > html && *open != '<' && *open != '>') open--;
+
+        if (*open == '<') {
+            Tag tag;
+            const char *after = parse_tag(open, end, &tag, 1);
+            if (tag.is_glossary && !tag.closing && strcmp(tag.name, "div") == 0) return after;
+        }
+        from = hit + 1;
+    }
+    return NULL;
+}
+
+int html_extract_glossary(const char *html, size_t len, int max_entries,
+                          char *out, size_t out_size) {
+    if (!html || !out || out_size == 0) return -1;
+    if (max_entries < 1) max_entries = 1;
+
+    TextSink sink = {out, out_size, 0, 0, 0, 0};
+    const char *end = html + len;
+    const char *p = find_glossary(html, end);
+
+    int div_depth = 0;
+    int glossary_depth = 0;     // div depth of the glossary element, 0 without one
+    int entry_depth = 0;        // div depth of the entry being copied, 0 if none
+    int entries = 0;
+    int skip_depth = 0;
+    char skip_name[TAG_NAME_MAX] = "";
+
+    if (p) {
+        div_depth = glossary_depth = 1;
+    } else {
+        p = html;
+    }
+
+    while (p < end) {
+        // A '<' that cannot start a tag is plain text
+        int tag_start = *p == '<' && p + 1 < end &&
+                        (isalpha((unsigned char)p[1]) || p[1] == '/' || p[1] == '!');
+
+        // Outside an entry, text and entities are dropped: jump to the next tag
+        int emitting = !skip_depth && (!glossary_depth || entry_depth);
+        if (!emitting && !tag_start) {
+            const char *next = memchr(p + 1, '<', end - p - 1);
+            p = next ? next : end;
+            continue;
+        }
+
+        // Text runs are copied up to the next markup character
+        if (*p != '&' && !tag_start) {
+            const char *run = p++;
+            while (p < end && *p != '<' && *p != '&') p++;
+            sink_text(&sink, run, p - run);
+            continue;
+        }
+
+        if (*p == '&') {
+            char buf[4];
+            size_t buf_len = 0;
+            size_t used = decode_entity(p, end, buf, &buf_len);
+
+            if (used == 0) {
+                sink_text(&sink, "&", 1);
+                p++;
+            } else {
+                sink_text(&sink, buf, buf_len);
+                p += used;
+            }
+            continue;
+        }
+
+        Tag tag;
+        p = parse_tag(p, end, &tag, 0);
+        if (tag.name[0] == '\0') continue;
+
+        if (skip_depth) {
+            if (strcmp(tag.name, skip_name) == 0 && !tag.self_closing) {
+                skip_depth += tag.closing ? -1 : 1;
+            }
+            continue;
+        }
+
+        int flags = classify_tag(tag.name);
+        if ((flags & TAG_SKIP) && !tag.closing && !tag.self_closing) {
+            strcpy(skip_name, tag.name);
+            skip_depth = 1;
+            continue;
+        }
+
+        if (flags & TAG_BLOCK) sink_space(&sink);
+        if (!(flags & TAG_DIV) || tag.self_closing) continue;
+
+        if (!tag.closing) {
+            div_depth++;
+            if (glossary_depth && !entry_depth) {
+                entry_depth = div_depth;
+                sink.need_separator = entries > 0;
+                sink.pending_space = 0;
+            }
+            continue;
+        }
+
+        if (glossary_depth && div_depth == entry_depth) {
+            entry_depth = 0;
+            if (++entries >= max_entries) break;
+        } else if (glossary_depth && div_depth == glossary_depth) {
+            break;
+        }
+        if (div_depth > 0) div_depth--;
+    }
+
+    if (glossary_depth && entries == 0 && !entry_depth && sink.len == 0) {
+        out[0] = '\0';
+        return -1;
+    }
+
+    return (int)sink_finish(&sink);
+}
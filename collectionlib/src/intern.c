@@ -0,0 +1,126 @@
+#include "../include/intern.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/log.h"
+
+#define INTERN_MIN_CAPACITY 64
+
+// FNV-1a; the length comes out of the same pass
+static uint64_t hash_string(const char *str, size_t *len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const unsigned char *p = (const unsigned char *)str;
+
+    for (; *p; p++) {
+        hash ^= *p;
+        hash *= 0x100000001b3ULL;
+    }
+    *len = (size_t)(p - (const unsigned char *)str);
+    return hash;
+}
+
+static int table_alloc(InternTable *table, int capacity) {
+    table->strings = calloc(capacity, sizeof(const char *));
+    table->hashes = malloc(capacity * sizeof(uint64_t));
+    if (!table->strings || !table->hashes) {
+        free(table->strings);
+        free(table->hashes);
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to allocate intern table of %d slots", capacity);
+        return -1;
+    }
+    table->capacity = capacity;
+    return 0;
+}
+
+int intern_init(InternTable *table, StringArena *arena, int expected) {
+    int capacity = INTERN_MIN_CAPACITY;
+    while (capacity < expected * 2) capacity *= 2;
+
+    memset(table, 0, sizeof(*table));
+    table->arena = arena;
+    return table_alloc(table, capacity);
+}
+
+void intern_free(InternTable *table) {
+    free(table->strings);
+    free(table->hashes);
+    table->strings = NULL;
+    table->hashes = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+// Double the table, reusing the stored hashes
+static int grow(InternTable *table) {
+    const char **strings = table->strings;
+    uint64_t *hashes = table->hashes;
+    int capacity = table->capacity;
+
+    if (table_alloc(table, capacity * 2) < 0) {
+        table->strings = strings;
+        table->hashes = hashes;
+        return -1;
+    }
+
+    int mask = table->capacity - 1;
+    for (int i = 0; i < capacity; i++) {
+        if (!strings[i]) continue;
+        int slot = (int)(hashes[i] & mask);
+        while (table->strings[slot]) slot = (slot + 1) & mask;
+        table->strings[slot] = strings[i];
+        table->hashes[slot] = hashes[i];
+    }
+
+    free(strings);
+    free(hashes);
+    return 0;
+}
+
+static uint64_t hash_bytes(const char *str, size_t len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static const char* intern_hashed(InternTable *table, const char *str, size_t len, uint64_t h) {
+    int mask = table->capacity - 1;
+    int slot = (int)(h & mask);
+
+    for (; table->strings[slot]; slot = (slot + 1) & mask) {
+        const char *kept = table->strings[slot];
+        if (table->hashes[slot] == h && strncmp(kept, str, len) == 0 && kept[len] == '\0') {
+            table->bytes_saved += len + 1;
+            return kept;
+        }
+    }
+
+    char *copy = arena_strndup(table->arena, str, len);
+    if (!copy) return NULL;
+
+    table->strings[slot] = copy;
+    table->hashes[slot] = h;
+    table->count++;
+
+    // Keep probes short: at most half full
+    if (table->count * 2 > table->capacity && grow(table) < 0) return NULL;
+    return copy;
+}
+
+const char* intern_string(InternTable *table, const char *str, uint64_t *hash) {
+    size_t len;
+    uint64_t h = hash_string(str, &len);
+
+    if (hash) *hash = h;
+    return intern_hashed(table, str, len, h);
+}
+
+const char* intern_stringn(InternTable *table, const char *str, size_t len, uint64_t *hash) {
+    uint64_t h = hash_bytes(str, len);
+
+    if (hash) *hash = h;
+    return intern_hashed(table, str, len, h);
+}
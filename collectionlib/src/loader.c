@@ -0,0 +1,274 @@
+#include "../include/loader.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/log.h"
+#include "../include/trace.h"
+
+// A run of consecutive query rows; workers parse it in place
+typedef struct LoadBatch {
+    struct LoadBatch *next;     // queue link
+    int row_count;
+    char *text;                 // flds of every row, back to back
+    size_t text_len;
+    size_t text_cap;
+    size_t offsets[LOADER_BATCH_ROWS];
+    int lengths[LOADER_BATCH_ROWS];
+    long long note_ids[LOADER_BATCH_ROWS];
+    long long card_ids[LOADER_BATCH_ROWS];
+    CardData cards[LOADER_BATCH_ROWS];
+    int card_rows[LOADER_BATCH_ROWS];   // source row of each parsed card
+    int card_count;
+    int parsed;                 // set by the worker once cards are final
+} LoadBatch;
+
+// Bounded FIFO between the reader and the workers
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    LoadBatch *head;
+    LoadBatch *tail;
+    int queued;
+    int limit;
+    int closed;
+} BatchQueue;
+
+typedef struct {
+    pthread_t thread;
+    BatchQueue *queue;
+    StringArena arena;
+    SharedInternTable *shared;  // interns strings instead of the arena, if set
+} LoadWorker;
+
+static void queue_push(BatchQueue *queue, LoadBatch *batch) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->queued >= queue->limit) {
+        pthread_cond_wait(&queue->not_full, &queue->lock);
+    }
+
+    batch->next = NULL;
+    if (queue->tail) queue->tail->next = batch;
+    else queue->head = batch;
+    queue->tail = batch;
+    queue->queued++;
+
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Blocks until a batch is available; NULL once the queue is closed and drained
+static LoadBatch* queue_pop(BatchQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (!queue->head && !queue->closed) {
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+    }
+
+    LoadBatch *batch = queue->head;
+    if (batch) {
+        queue->head = batch->next;
+        if (!queue->head) queue->tail = NULL;
+        queue->queued--;
+        pthread_cond_signal(&queue->not_full);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+    return batch;
+}
+
+static void queue_close(BatchQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static void* worker_main(void *arg) {
+    LoadWorker *worker = arg;
+    LoadBatch *batch;
+
+    while ((batch = queue_pop(worker->queue)) != NULL) {
+        TRACE_SCOPE("parse_batch");
+
+        for (int row = 0; row < batch->row_count; row++) {
+            CardData *card = &batch->cards[batch->card_count];
+            const char *fields = batch->text + batch->offsets[row];
+
+            int parsed = worker->shared
+                         ? parse_card_fields_shared(fields, batch->lengths[row], card, worker->shared)
+                         : parse_card_fields(fields, batch->lengths[row], card, &worker->arena);
+            if (parsed == 0) {
+                batch->card_rows[batch->card_count++] = row;
+            }
+        }
+
+        // Parsed strings live in the worker arena now
+        free(batch->text);
+        batch->text = NULL;
+        __atomic_store_n(&batch->parsed, 1, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+static int batch_append(LoadBatch *batch, long long note_id, const char *fields, int len,
+                        long long card_id) {
+    if (batch->text_len + len > batch->text_cap) {
+        size_t cap = batch->text_cap ? batch->text_cap : 16 * 1024;
+        while (cap < batch->text_len + len) cap *= 2;
+
+        char *text = realloc(batch->text, cap);
+        if (!text) return -1;
+        batch->text = text;
+        batch->text_cap = cap;
+    }
+
+    int row = batch->row_count++;
+    memcpy(batch->text + batch->text_len, fields, len);
+    batch->offsets[row] = batch->text_len;
+    batch->lengths[row] = len;
+    batch->note_ids[row] = note_id;
+    batch->card_ids[row] = card_id;
+    batch->text_len += len;
+    return 0;
+}
+
+// Append parsed batches to the collection in query order, stopping at the
+// first one still being parsed, and publish what was appended. The worker
+// arenas holding their strings are only merged at the end, but arena blocks
+// never move, so the published cards stay valid throughout.
+static int merge_parsed(LoadBatch **batches, int batch_count, int *merged,
+                        CardCollection *collection, int failed) {
+    int start = *merged;
+
+    while (*merged < batch_count && __atomic_load_n(&batches[*merged]->parsed, __ATOMIC_ACQUIRE)) {
+        LoadBatch *batch = batches[(*merged)++];
+
+        if (!failed && collection_reserve(collection, collection->count + batch->card_count) < 0) {
+            failed = 1;
+        }
+        for (int i = 0; !failed && i < batch->card_count; i++) {
+            int row = batch->card_rows[i];
+            collection->cards[collection->count] = batch->cards[i];
+            collection->cards[collection->count].card_id = batch->card_ids[row];
+            if (COLLECTION_LOG_ENABLED(COLLECTION_LOG_DEBUG)) {
+                report_card(&batch->cards[i], collection->count,
+                            batch->card_ids[row], batch->note_ids[row]);
+            }
+            collection->count++;
+        }
+
+        free(batch->text);
+        free(batch);
+        batches[*merged - 1] = NULL;
+    }
+
+    if (!failed && *merged > start) collection_publish(collection);
+    return failed;
+}
+
+int loader_thread_count(int requested) {
+    if (requested <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        requested = cpus > 0 ? (int)cpus : 1;
+    }
+    return requested > LOADER_MAX_THREADS ? LOADER_MAX_THREADS : requested;
+}
+
+int load_cards_parallel(sqlite3_stmt *stmt, CardCollection *collection, int threads) {
+    TRACE_SCOPE("load_cards_parallel");
+    BatchQueue queue;
+    LoadWorker workers[LOADER_MAX_THREADS];
+    LoadBatch **batches = NULL;
+    int batch_count = 0, batch_cap = 0, merged = 0;
+    LoadBatch *current = NULL;
+    int started = 0;
+    int failed = 0;
+
+    threads = loader_thread_count(threads);
+
+    memset(&queue, 0, sizeof(queue));
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.not_empty, NULL);
+    pthread_cond_init(&queue.not_full, NULL);
+    queue.limit = threads * LOADER_QUEUE_DEPTH;
+
+    for (; started < threads; started++) {
+        workers[started].queue = &queue;
+        workers[started].shared = collection->shared_strings;
+        arena_init(&workers[started].arena, ARENA_DEFAULT_BLOCK_SIZE);
+        if (pthread_create(&workers[started].thread, NULL, worker_main, &workers[started]) != 0) {
+            COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to start loader thread %d", started);
+            break;
+        }
+    }
+    if (started == 0) failed = 1;
+
+    // This thread is the reader: it only steps SQLite and copies row text
+    while (!failed && !__atomic_load_n(&collection->cancel, __ATOMIC_RELAXED) &&
+           sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *fields = (const char*)sqlite3_column_text(stmt, 1);
+        int fields_len = sqlite3_column_bytes(stmt, 1);
+
+        if (!fields) continue;
+
+        if (!current) {
+            if (batch_count == batch_cap) {
+                int cap = batch_cap ? batch_cap * 2 : 64;
+                LoadBatch **grown = realloc(batches, cap * sizeof(LoadBatch *));
+                if (!grown) {
+                    failed = 1;
+                    break;
+                }
+                batches = grown;
+                batch_cap = cap;
+            }
+            current = calloc(1, sizeof(LoadBatch));
+            if (!current) {
+                failed = 1;
+                break;
+            }
+            batches[batch_count++] = current;
+        }
+
+        if (batch_append(current, sqlite3_column_int64(stmt, 0), fields, fields_len,
+                         sqlite3_column_int64(stmt, 2)) < 0) {
+            failed = 1;
+            break;
+        }
+
+        if (current->row_count == LOADER_BATCH_ROWS) {
+            queue_push(&queue, current);
+            current = NULL;
+            failed = merge_parsed(batches, batch_count, &merged, collection, failed);
+        }
+    }
+    if (__atomic_load_n(&collection->cancel, __ATOMIC_RELAXED)) failed = 1;
+
+    if (current && !failed) queue_push(&queue, current);
+    queue_close(&queue);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        arena_merge(&collection->strings, &workers[i].arena);
+    }
+
+    // Whatever is left, still in batch order so the result matches the
+    // serial loader
+    failed = merge_parsed(batches, batch_count, &merged, collection, failed);
+    for (int b = merged; b < batch_count; b++) {
+        free(batches[b]->text);
+        free(batches[b]);
+    }
+    free(batches);
+
+    pthread_cond_destroy(&queue.not_full);
+    pthread_cond_destroy(&queue.not_empty);
+    pthread_mutex_destroy(&queue.lock);
+
+    return failed ? -1 : collection->count;
+}
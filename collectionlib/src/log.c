@@ -0,0 +1,41 @@
+#include "../include/log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#define LOG_MESSAGE_MAX 1024
+
+CollectionLogLevel collection_log_level = COLLECTION_LOG_INFO;
+
+static CollectionLogSink log_sink = NULL;
+static void *log_user_data = NULL;
+
+void collection_set_log_level(CollectionLogLevel level) {
+    collection_log_level = level;
+}
+
+void collection_set_log_sink(CollectionLogSink sink, void *user_data) {
+    log_sink = sink;
+    log_user_data = user_data;
+}
+
+void collection_log_write(CollectionLogLevel level, const char *format, ...) {
+    va_list args;
+
+    if (!COLLECTION_LOG_ENABLED(level)) return;
+
+    if (!log_sink) {
+        FILE *out = level == COLLECTION_LOG_ERROR ? stderr : stdout;
+        va_start(args, format);
+        vfprintf(out, format, args);
+        va_end(args);
+        fputc('\n', out);
+        return;
+    }
+
+    char message[LOG_MESSAGE_MAX];
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    log_sink(level, message, log_user_data);
+}
@@ -0,0 +1,183 @@
+#include "../include/reading.h"
+
+#include <string.h>
+
+#include "../include/html.h"
+
+// Answers being written into the caller's buffer
+typedef struct {
+    char *out;
+    size_t size;
+    size_t len;
+    size_t start;           // where the current answer began
+    size_t base;            // where the text a furigana reading replaces began
+    int full;               // out ran out of room; the rest is dropped
+    CardAnswer *answers;
+    int count;
+    int max;
+} AnswerWriter;
+
+uint32_t reading_text_hash(const char *text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Bytes in the UTF-8 sequence led by lead; stray continuation bytes are one
+static size_t sequence_length(unsigned char lead, size_t left) {
+    size_t n = lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+    return n < left ? n : left;
+}
+
+// ASCII whitespace, the no-break space of a decoded &nbsp; and U+3000
+static size_t space_length(const unsigned char *p, size_t left) {
+    if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') return 1;
+    if (left >= 2 && p[0] == 0xC2 && p[1] == 0xA0) return 2;
+    if (left >= 3 && p[0] == 0xE3 && p[1] == 0x80 && p[2] == 0x80) return 3;
+    return 0;
+}
+
+// , ; / and 、，；／
+static size_t separator_length(const unsigned char *p, size_t left) {
+    if (*p == ',' || *p == ';' || *p == '/') return 1;
+    if (left < 3) return 0;
+    if (p[0] == 0xE3 && p[1] == 0x80 && p[2] == 0x81) return 3;
+    if (p[0] == 0xEF && p[1] == 0xBC && (p[2] == 0x8C || p[2] == 0x9B || p[2] == 0x8F)) return 3;
+    return 0;
+}
+
+// Katakana U+30A1-U+30F6 are hiragana U+3041-U+3096 plus 0x60, and so are
+// the iteration marks U+30FD-U+30FE. All are E3 82/83 xx in UTF-8.
+void kana_fold(char *text, size_t length) {
+    unsigned char *p = (unsigned char *)text;
+    unsigned char *end = p + length;
+
+    while (p + 2 < end) {
+        if (p[0] != 0xE3 || (p[1] != 0x82 && p[1] != 0x83)) {
+            p++;
+            continue;
+        }
+        unsigned code = 0x3000 | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        if ((code >= 0x30A1 && code <= 0x30F6) || code == 0x30FD || code == 0x30FE) {
+            code -= 0x60;
+            p[1] = 0x80 | ((code >> 6) & 0x3F);
+            p[2] = 0x80 | (code & 0x3F);
+        }
+        p += 3;
+    }
+}
+
+// Whole sequences only, always leaving room for the terminator
+static void put(AnswerWriter *writer, const unsigned char *bytes, size_t n) {
+    if (writer->full || writer->len + n + 1 > writer->size) {
+        writer->full = 1;
+        return;
+    }
+    memcpy(writer->out + writer->len, bytes, n);
+    writer->len += n;
+}
+
+static void end_answer(AnswerWriter *writer) {
+    char *text = writer->out + writer->start;
+    size_t length = writer->len - writer->start;
+    int keep = length > 0 && writer->count < writer->max;
+
+    if (keep) {
+        kana_fold(text, length);
+        for (int i = 0; i < writer->count && keep; i++) {
+            keep = writer->answers[i].length != length ||
+                   memcmp(writer->answers[i].text, text, length) != 0;
+        }
+    }
+
+    if (keep) {
+        CardAnswer *answer = &writer->answers[writer->count++];
+        text[length] = '\0';
+        answer->text = text;
+        answer->length = (uint32_t)length;
+        answer->hash = reading_text_hash(text, length);
+        writer->len++;
+    } else {
+        writer->len = writer->start;
+    }
+    writer->start = writer->base = writer->len;
+}
+
+int reading_normalize(const char *reading, size_t len, char *out, size_t out_size,
+                      CardAnswer *answers, int max_answers) {
+    char plain[READING_BUFFER_SIZE];
+    AnswerWriter writer = {out, out_size, 0, 0, 0, 0, answers, 0, max_answers};
+
+    if (!reading || out_size == 0) return 0;
+
+    // Tags and entities go first, so markup cannot split an answer
+    int plain_len = html_extract_glossary(reading, len, 1, plain, sizeof(plain));
+    if (plain_len <= 0) return 0;
+
+    const unsigned char *p = (const unsigned char *)plain;
+    const unsigned char *end = p + plain_len;
+    while (p < end) {
+        size_t n;
+        if ((n = space_length(p, end - p))) {
+            writer.base = writer.len;
+            p += n;
+            continue;
+        }
+        if ((n = separator_length(p, end - p))) {
+            end_answer(&writer);
+            p += n;
+            continue;
+        }
+
+        // Furigana: the bracketed reading replaces the text since the last
+        // space or bracket. Pitch accent after a ; or , is dropped.
+        const unsigned char *close = *p == '[' ? memchr(p + 1, ']', end - p - 1) : NULL;
+        if (close) {
+            writer.len = writer.base;
+            for (const unsigned char *q = p + 1; q < close && *q != ';' && *q != ','; q += n) {
+                n = sequence_length(*q, close - q);
+                if (!space_length(q, close - q)) put(&writer, q, n);
+            }
+            writer.base = writer.len;
+            p = close + 1;
+            continue;
+        }
+
+        n = sequence_length(*p, end - p);
+        put(&writer, p, n);
+        p += n;
+    }
+    end_answer(&writer);
+    return writer.count;
+}
+
+int card_prepare_answers(CardData *card, StringArena *arena) {
+    char text[READING_BUFFER_SIZE];
+    CardAnswer found[CARD_MAX_ANSWERS];
+    int count = reading_normalize(card->word_reading, strlen(card->word_reading),
+                                  text, sizeof(text), found, CARD_MAX_ANSWERS);
+
+    card->answers = NULL;
+    card->answer_count = 0;
+    if (count == 0) return 0;
+
+    // The answers, then their text, in one allocation
+    const CardAnswer *last = &found[count - 1];
+    size_t text_len = (size_t)(last->text - text) + last->length + 1;
+    CardAnswer *answers = arena_alloc_aligned(arena, count * sizeof(CardAnswer) + text_len,
+                                              _Alignof(CardAnswer));
+    if (!answers) return -1;
+
+    char *copy = (char *)(answers + count);
+    memcpy(copy, text, text_len);
+    for (int i = 0; i < count; i++) {
+        answers[i] = found[i];
+        answers[i].text = copy + (found[i].text - text);
+    }
+    card->answers = answers;
+    card->answer_count = count;
+    return 0;
+}
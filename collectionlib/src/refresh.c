@@ -0,0 +1,458 @@
+#include "../include/refresh.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/log.h"
+#include "../include/reading.h"
+#include "../include/schedule.h"
+#include "../include/trace.h"
+
+#define CARD_MAP_MIN_CAPACITY 64
+#define SCRATCH_BLOCK_SIZE 4096
+
+// Every card of a note edited, or synced in, since the refresh point
+static const char *changed_notes_sql =
+    "SELECT c.id, c.did, n.flds FROM notes n JOIN cards c ON c.nid = n.id "
+    "WHERE (n.usn = -1 AND n.mod >= ?1) OR n.usn > ?2;";
+
+// Cards moved, reviewed or added since; with their note, as a new card needs it
+static const char *changed_cards_sql =
+    "SELECT c.id, c.did, n.flds FROM cards c JOIN notes n ON n.id = c.nid "
+    "WHERE (c.usn = -1 AND c.mod >= ?1) OR c.usn > ?2;";
+
+// Deleted cards; Anki keeps their graves until they are synced
+static const char *deleted_cards_sql =
+    "SELECT oid FROM graves WHERE type = 0 AND (usn = -1 OR usn > ?1);";
+
+static const char *max_usn_sql =
+    "SELECT MAX((SELECT MAX(usn) FROM notes), (SELECT MAX(usn) FROM cards));";
+
+// Index lookups on usn, like the refresh queries
+static const char *change_stamp_sql =
+    "SELECT (SELECT MAX(usn) FROM notes), (SELECT MAX(usn) FROM cards), "
+    "(SELECT MAX(mod) FROM notes WHERE usn = -1), (SELECT MAX(mod) FROM cards WHERE usn = -1);";
+
+static const char *unsynced_graves_sql = "SELECT COUNT(*) FROM graves WHERE usn = -1;";
+
+// Statements and the card id lookup, built on the first refresh
+struct CollectionRefresh {
+    sqlite3_stmt *changed_notes;
+    sqlite3_stmt *changed_cards;
+    sqlite3_stmt *deleted_cards;    // NULL in files without a graves table
+    sqlite3_stmt *max_usn;
+
+    // cards.id -> card index, open addressing; cards [0, mapped) are in it
+    long long *ids;
+    int *indices;
+    int mask;
+    int mapped;
+
+    int retired_capacity;
+    const CardSchedule *schedule;   // collection->schedule as last seen
+    int schedule_capacity;
+};
+
+void collection_changes_init(CollectionChanges *changes) {
+    memset(changes, 0, sizeof(*changes));
+}
+
+static void list_free(CardIndexList *list) {
+    free(list->items);
+    list->items = NULL;
+    list->count = list->capacity = 0;
+}
+
+void collection_changes_free(CollectionChanges *changes) {
+    list_free(&changes->edited);
+    list_free(&changes->rescheduled);
+    list_free(&changes->retired);
+    list_free(&changes->restored);
+}
+
+static int list_push(CardIndexList *list, int index) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 16;
+        int *items = realloc(list->items, capacity * sizeof(int));
+        if (!items) return -1;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = index;
+    return 0;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int map_slot(const struct CollectionRefresh *refresh, long long card_id) {
+    uint64_t hash = (uint64_t)card_id * 0x9E3779B97F4A7C15ULL;
+    return (int)((hash ^ hash >> 32) & (uint64_t)refresh->mask);
+}
+
+static int map_find(const struct CollectionRefresh *refresh, long long card_id) {
+    for (int slot = map_slot(refresh, card_id); refresh->indices[slot] >= 0;
+         slot = (slot + 1) & refresh->mask) {
+        if (refresh->ids[slot] == card_id) return refresh->indices[slot];
+    }
+    return -1;
+}
+
+static void map_insert(struct CollectionRefresh *refresh, long long card_id, int index) {
+    int slot = map_slot(refresh, card_id);
+    while (refresh->indices[slot] >= 0) slot = (slot + 1) & refresh->mask;
+    refresh->ids[slot] = card_id;
+    refresh->indices[slot] = index;
+}
+
+// Map every card, rebuilding at double the size once it is half full.
+// Only done once a changed row turns up, so a refresh that finds nothing,
+// such as most catch-ups after a deck cache load, never builds the map.
+static int map_sync(struct CollectionRefresh *refresh, const CardCollection *collection) {
+    if (collection->count * 2 >= refresh->mask + 1) {
+        int capacity = CARD_MAP_MIN_CAPACITY;
+        while (capacity < collection->count * 2) capacity *= 2;
+
+        long long *ids = malloc(capacity * sizeof(long long));
+        int *indices = malloc(capacity * sizeof(int));
+        if (!ids || !indices) {
+            free(ids);
+            free(indices);
+            COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to allocate card lookup of %d slots", capacity);
+            return -1;
+        }
+        free(refresh->ids);
+        free(refresh->indices);
+        refresh->ids = ids;
+        refresh->indices = indices;
+        refresh->mask = capacity - 1;
+        refresh->mapped = 0;
+        memset(indices, 0xFF, capacity * sizeof(int));
+    }
+
+    for (; refresh->mapped < collection->count; refresh->mapped++) {
+        map_insert(refresh, collection->cards[refresh->mapped].card_id, refresh->mapped);
+    }
+    return 0;
+}
+
+static int prepare(sqlite3 *db, const char *sql, sqlite3_stmt **stmt) {
+    if (sqlite3_prepare_v2(db, sql, -1, stmt, NULL) != SQLITE_OK) {
+        *stmt = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static struct CollectionRefresh* refresh_state(CardCollection *collection) {
+    if (collection->refresh) return collection->refresh;
+
+    struct CollectionRefresh *refresh = calloc(1, sizeof(struct CollectionRefresh));
+    if (!refresh) return NULL;
+    refresh->mask = -1;
+
+    if (prepare(collection->db, changed_notes_sql, &refresh->changed_notes) < 0 ||
+        prepare(collection->db, changed_cards_sql, &refresh->changed_cards) < 0 ||
+        prepare(collection->db, max_usn_sql, &refresh->max_usn) < 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to prepare refresh queries: %s",
+                       sqlite3_errmsg(collection->db));
+        collection->refresh = refresh;
+        collection_refresh_free(collection);
+        return NULL;
+    }
+    prepare(collection->db, deleted_cards_sql, &refresh->deleted_cards);
+
+    collection->refresh = refresh;
+    return refresh;
+}
+
+static int read_max_usn(sqlite3_stmt *stmt, long long *usn) {
+    int rc = sqlite3_step(stmt) == SQLITE_ROW ? 0 : -1;
+    if (rc == 0) *usn = sqlite3_column_int64(stmt, 0);
+    sqlite3_reset(stmt);
+    return rc;
+}
+
+int collection_refresh_mark(CardCollection *collection, long long now) {
+    sqlite3_stmt *stmt;
+    long long usn = 0;
+
+    collection->refresh_mod = 0;
+    if (prepare(collection->db, max_usn_sql, &stmt) < 0) return -1;
+
+    int rc = read_max_usn(stmt, &usn);
+    sqlite3_finalize(stmt);
+    if (rc < 0) return -1;
+
+    collection->refresh_mod = now;
+    collection->refresh_usn = usn;
+    return 0;
+}
+
+static uint64_t stamp_row(sqlite3_stmt *stmt, uint64_t stamp) {
+    if (sqlite3_step(stmt) != SQLITE_ROW) return stamp;
+    for (int i = 0; i < sqlite3_column_count(stmt); i++) {
+        stamp = (stamp ^ (uint64_t)sqlite3_column_int64(stmt, i)) * 0x100000001b3ULL;
+    }
+    return stamp;
+}
+
+int collection_change_stamp(CardCollection *collection, uint64_t *stamp) {
+    sqlite3_stmt *stmt;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    if (!collection->db || prepare(collection->db, change_stamp_sql, &stmt) < 0) return -1;
+    hash = stamp_row(stmt, hash);
+    sqlite3_finalize(stmt);
+
+    // Files without a graves table have nothing to add
+    if (prepare(collection->db, unsynced_graves_sql, &stmt) == 0) {
+        hash = stamp_row(stmt, hash);
+        sqlite3_finalize(stmt);
+    }
+
+    *stamp = hash;
+    return 0;
+}
+
+int collection_card_retired(const CardCollection *collection, int index) {
+    return collection->retired && collection->retired[index];
+}
+
+// Per-card arrays the collection only has sometimes follow the card array
+static int grow_side_arrays(CardCollection *collection, struct CollectionRefresh *refresh) {
+    if (collection->retired && refresh->retired_capacity < collection->capacity) {
+        unsigned char *retired = realloc(collection->retired, collection->capacity);
+        if (!retired) return -1;
+        memset(retired + refresh->retired_capacity, 0,
+               collection->capacity - refresh->retired_capacity);
+        collection->retired = retired;
+        refresh->retired_capacity = collection->capacity;
+    }
+
+    // The loader sizes review data to the cards it had
+    if (collection->schedule != refresh->schedule) {
+        refresh->schedule = collection->schedule;
+        refresh->schedule_capacity = collection->count;
+    }
+    if (collection->schedule && refresh->schedule_capacity < collection->capacity) {
+        CardSchedule *schedule = realloc(collection->schedule,
+                                         collection->capacity * sizeof(CardSchedule));
+        if (!schedule) return -1;
+        memset(schedule + refresh->schedule_capacity, 0,
+               (collection->capacity - refresh->schedule_capacity) * sizeof(CardSchedule));
+        collection->schedule = schedule;
+        refresh->schedule = schedule;
+        refresh->schedule_capacity = collection->capacity;
+    }
+    return 0;
+}
+
+static int retire_card(CardCollection *collection, struct CollectionRefresh *refresh, int index,
+                       CollectionChanges *changes) {
+    if (collection_card_retired(collection, index)) return 0;
+
+    if (!collection->retired) {
+        collection->retired = calloc(collection->capacity, 1);
+        if (!collection->retired) return -1;
+        refresh->retired_capacity = collection->capacity;
+    }
+    collection->retired[index] = 1;
+    return list_push(&changes->retired, index);
+}
+
+static int copy_strings(CardData *card, const CardData *parsed, StringArena *strings) {
+    card->word = arena_strdup(strings, parsed->word);
+    card->word_reading = arena_strdup(strings, parsed->word_reading);
+    card->word_meaning = arena_strdup(strings, parsed->word_meaning);
+    return card->word && card->word_reading && card->word_meaning ? 0 : -1;
+}
+
+static int append_card(CardCollection *collection, struct CollectionRefresh *refresh,
+                       const CardData *parsed, long long card_id, CollectionChanges *changes) {
+    if (collection_reserve(collection, collection->count + 1) < 0 ||
+        grow_side_arrays(collection, refresh) < 0) {
+        return -1;
+    }
+
+    int index = collection->count;
+    CardData *card = &collection->cards[index];
+    if (copy_strings(card, parsed, &collection->strings) < 0) return -1;
+    card->card_id = card_id;
+    card->answers = NULL;
+    card->answer_count = 0;
+    collection->count++;
+
+    if (map_sync(refresh, collection) < 0) return -1;
+    return collection->schedule ? list_push(&changes->rescheduled, index) : 0;
+}
+
+static int loaded_deck(const CardCollection *collection, long long deck_id) {
+    for (int i = 0; i < collection->deck_count; i++) {
+        if (collection->deck_ids[i] == deck_id) return 1;
+    }
+    return 0;
+}
+
+static int same_text(const CardData *a, const CardData *b) {
+    return strcmp(a->word, b->word) == 0 && strcmp(a->word_reading, b->word_reading) == 0 &&
+           strcmp(a->word_meaning, b->word_meaning) == 0;
+}
+
+// One (card id, deck id, flds) row. The note is parsed into scratch first,
+// so a row that changed nothing we show costs no collection memory.
+static int apply_row(CardCollection *collection, struct CollectionRefresh *refresh,
+                     sqlite3_stmt *stmt, int card_changed, StringArena *scratch,
+                     CollectionChanges *changes) {
+    long long card_id = sqlite3_column_int64(stmt, 0);
+    const char *fields = (const char *)sqlite3_column_text(stmt, 2);
+    CardData parsed;
+
+    if (map_sync(refresh, collection) < 0) return -1;
+    int index = map_find(refresh, card_id);
+
+    // Cards the loader would have skipped go the way of deleted ones
+    if (!loaded_deck(collection, sqlite3_column_int64(stmt, 1)) || !fields ||
+        parse_card_fields(fields, sqlite3_column_bytes(stmt, 2), &parsed, scratch) < 0) {
+        return index >= 0 ? retire_card(collection, refresh, index, changes) : 0;
+    }
+    if (index < 0) return append_card(collection, refresh, &parsed, card_id, changes);
+
+    if (collection_card_retired(collection, index)) {
+        collection->retired[index] = 0;
+        if (list_push(&changes->restored, index) < 0) return -1;
+    }
+
+    CardData *card = &collection->cards[index];
+    if (!same_text(card, &parsed)) {
+        if (copy_strings(card, &parsed, &collection->strings) < 0 ||
+            card_prepare_answers(card, &collection->strings) < 0 ||
+            list_push(&changes->edited, index) < 0) {
+            return -1;
+        }
+    }
+
+    if (card_changed && collection->schedule) return list_push(&changes->rescheduled, index);
+    return 0;
+}
+
+static int apply_changed_rows(CardCollection *collection, struct CollectionRefresh *refresh,
+                              sqlite3_stmt *stmt, int card_changed, StringArena *scratch,
+                              CollectionChanges *changes) {
+    int step, rc = 0;
+
+    sqlite3_bind_int64(stmt, 1, collection->refresh_mod);
+    sqlite3_bind_int64(stmt, 2, collection->refresh_usn);
+    while (rc == 0 && (step = sqlite3_step(stmt)) == SQLITE_ROW) {
+        rc = apply_row(collection, refresh, stmt, card_changed, scratch, changes);
+    }
+    if (rc == 0 && step != SQLITE_DONE) rc = -1;
+    sqlite3_reset(stmt);
+    return rc;
+}
+
+static int apply_deleted_rows(CardCollection *collection, struct CollectionRefresh *refresh,
+                              CollectionChanges *changes) {
+    sqlite3_stmt *stmt = refresh->deleted_cards;
+    int step, rc = 0;
+
+    if (!stmt) return 0;
+
+    sqlite3_bind_int64(stmt, 1, collection->refresh_usn);
+    while (rc == 0 && (step = sqlite3_step(stmt)) == SQLITE_ROW) {
+        rc = map_sync(refresh, collection);
+        int index = rc == 0 ? map_find(refresh, sqlite3_column_int64(stmt, 0)) : -1;
+        if (index >= 0) rc = retire_card(collection, refresh, index, changes);
+    }
+    if (rc == 0 && step != SQLITE_DONE) rc = -1;
+    sqlite3_reset(stmt);
+    return rc;
+}
+
+// Review data of the cards reviewed or added; a card listed twice loads once
+static int reload_schedule(CardCollection *collection, CardIndexList *rescheduled) {
+    if (!collection->schedule || rescheduled->count == 0) return 0;
+
+    qsort(rescheduled->items, rescheduled->count, sizeof(int), compare_ints);
+    int unique = 0;
+    for (int i = 0; i < rescheduled->count; i++) {
+        if (unique == 0 || rescheduled->items[unique - 1] != rescheduled->items[i]) {
+            rescheduled->items[unique++] = rescheduled->items[i];
+        }
+    }
+    rescheduled->count = unique;
+
+    return schedule_reload_cards(collection->db, collection->cards, rescheduled->items, unique,
+                                 collection->schedule);
+}
+
+int collection_refresh(CardCollection *collection, CollectionChanges *changes) {
+    TRACE_SCOPE("collection_refresh");
+    CollectionChanges local;
+    StringArena scratch;
+    long long now = (long long)time(NULL);
+    long long usn = collection->refresh_usn;
+    int rc = 0;
+
+    if (!changes) changes = &local;
+    collection_changes_init(changes);
+    changes->first_added = collection->count;
+    if (!collection->db || collection->refresh_mod == 0) return -1;
+
+    struct CollectionRefresh *refresh = refresh_state(collection);
+    if (!refresh) return -1;
+
+    arena_init(&scratch, SCRATCH_BLOCK_SIZE);
+
+    // One read transaction, so the usn read first covers every row after it
+    sqlite3_exec(collection->db, "BEGIN;", NULL, NULL, NULL);
+    if (read_max_usn(refresh->max_usn, &usn) < 0 ||
+        apply_changed_rows(collection, refresh, refresh->changed_notes, 0, &scratch, changes) < 0 ||
+        apply_changed_rows(collection, refresh, refresh->changed_cards, 1, &scratch, changes) < 0 ||
+        apply_deleted_rows(collection, refresh, changes) < 0 ||
+        reload_schedule(collection, &changes->rescheduled) < 0) {
+        rc = -1;
+    }
+    sqlite3_exec(collection->db, "COMMIT;", NULL, NULL, NULL);
+    arena_free(&scratch);
+
+    // Whatever was appended is final; a failed refresh is simply run again
+    // from the same point, as every change applies idempotently
+    collection_publish(collection);
+    if (rc == 0) {
+        collection->refresh_mod = now;
+        if (usn > collection->refresh_usn) collection->refresh_usn = usn;
+        rc = changes->edited.count + (collection->count - changes->first_added) +
+             changes->retired.count + changes->restored.count;
+        if (rc > 0) {
+            COLLECTION_LOG(COLLECTION_LOG_INFO,
+                           "Refreshed collection: %d edited, %d added, %d retired, %d restored",
+                           changes->edited.count, collection->count - changes->first_added,
+                           changes->retired.count, changes->restored.count);
+        }
+    } else {
+        COLLECTION_LOG(COLLECTION_LOG_INFO, "Collection refresh failed, left for the next one: %s",
+                       sqlite3_errmsg(collection->db));
+    }
+
+    if (changes == &local) collection_changes_free(&local);
+    return rc;
+}
+
+void collection_refresh_free(CardCollection *collection) {
+    struct CollectionRefresh *refresh = collection->refresh;
+    if (!refresh) return;
+
+    sqlite3_finalize(refresh->changed_notes);
+    sqlite3_finalize(refresh->changed_cards);
+    sqlite3_finalize(refresh->deleted_cards);
+    sqlite3_finalize(refresh->max_usn);
+    free(refresh->ids);
+    free(refresh->indices);
+    free(refresh);
+    collection->refresh = NULL;
+}
@@ -0,0 +1,238 @@
+#include "../include/review_writer.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../include/log.h"
+#include "../include/trace.h"
+
+#define BUSY_TIMEOUT_MS 5000
+
+static const char *create_table_sql =
+    "CREATE TABLE IF NOT EXISTS " REVIEW_TABLE " ("
+    "id integer PRIMARY KEY, cid integer NOT NULL, time integer NOT NULL, "
+    "answer_ms integer NOT NULL, outcome integer NOT NULL);"
+    "CREATE INDEX IF NOT EXISTS ix_" REVIEW_TABLE "_cid ON " REVIEW_TABLE " (cid);";
+
+static const char *insert_sql =
+    "INSERT INTO " REVIEW_TABLE " (cid, time, answer_ms, outcome) VALUES (?, ?, ?, ?);";
+
+static int exec(sqlite3 *db, const char *sql) {
+    char *error = NULL;
+    if (sqlite3_exec(db, sql, NULL, NULL, &error) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Review writer: %s", error ? error : sqlite3_errmsg(db));
+        sqlite3_free(error);
+        return -1;
+    }
+    return 0;
+}
+
+// One transaction for the whole batch; on failure the batch is dropped
+// rather than retried forever, and the caller counts it
+static int commit_batch(ReviewWriter *writer, const ReviewResult *results, int count) {
+    TRACE_SCOPE("review_writer_commit");
+
+    if (exec(writer->db, "BEGIN IMMEDIATE;") < 0) return -1;
+
+    for (int i = 0; i < count; i++) {
+        sqlite3_bind_int64(writer->insert, 1, results[i].card_id);
+        sqlite3_bind_int64(writer->insert, 2, results[i].time_ms);
+        sqlite3_bind_int(writer->insert, 3, results[i].answer_ms);
+        sqlite3_bind_int(writer->insert, 4, results[i].outcome);
+
+        int rc = sqlite3_step(writer->insert);
+        sqlite3_reset(writer->insert);
+        if (rc != SQLITE_DONE) {
+            COLLECTION_LOG(COLLECTION_LOG_ERROR, "Review writer: %s", sqlite3_errmsg(writer->db));
+            exec(writer->db, "ROLLBACK;");
+            return -1;
+        }
+    }
+
+    return exec(writer->db, "COMMIT;");
+}
+
+static void deadline_after(struct timespec *ts, int ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// WAL commits append to the log; NORMAL syncs only at checkpoints. Switching
+// to WAL needs the file to itself, so while another connection reads (the
+// game's loader, at startup) this gives SQLITE_BUSY and is tried again.
+static int prepare_database(ReviewWriter *writer) {
+    int rc = sqlite3_exec(writer->db, "PRAGMA journal_mode=WAL;", NULL, NULL, NULL);
+    if (rc == SQLITE_OK) rc = sqlite3_exec(writer->db, "PRAGMA synchronous=NORMAL;", NULL, NULL, NULL);
+    if (rc == SQLITE_OK) rc = sqlite3_exec(writer->db, create_table_sql, NULL, NULL, NULL);
+    if (rc == SQLITE_OK) rc = sqlite3_prepare_v2(writer->db, insert_sql, -1, &writer->insert, NULL);
+
+    if (rc != SQLITE_OK && rc != SQLITE_BUSY && rc != SQLITE_LOCKED) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Review writer: %s", sqlite3_errmsg(writer->db));
+    }
+    return rc;
+}
+
+// Retry every interval until the database is ready; results queue meanwhile.
+// On close, one last try waits out the busy timeout. 0 once ready.
+static int wait_for_database(ReviewWriter *writer) {
+    struct timespec deadline;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        int closing = writer->closing;
+        pthread_mutex_unlock(&writer->lock);
+
+        if (closing) sqlite3_busy_timeout(writer->db, BUSY_TIMEOUT_MS);
+        int rc = prepare_database(writer);
+        if (rc == SQLITE_OK) {
+            sqlite3_busy_timeout(writer->db, BUSY_TIMEOUT_MS);
+            return 0;
+        }
+        if (closing || (rc != SQLITE_BUSY && rc != SQLITE_LOCKED)) break;
+
+        pthread_mutex_lock(&writer->lock);
+        deadline_after(&deadline, REVIEW_WRITER_INTERVAL_MS);
+        while (!writer->closing) {
+            if (pthread_cond_timedwait(&writer->wake, &writer->lock, &deadline) == ETIMEDOUT) break;
+        }
+    }
+
+    COLLECTION_LOG(COLLECTION_LOG_ERROR, "Review writer cannot prepare the collection; "
+                   "results will not be saved");
+    return -1;
+}
+
+static void* writer_main(void *arg) {
+    ReviewWriter *writer = arg;
+    struct timespec deadline;
+    int ready = wait_for_database(writer) == 0;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        deadline_after(&deadline, REVIEW_WRITER_INTERVAL_MS);
+        while (!writer->closing && writer->pending_count < REVIEW_WRITER_BATCH &&
+               writer->flushes_done == writer->flush_requests) {
+            if (pthread_cond_timedwait(&writer->wake, &writer->lock, &deadline) == ETIMEDOUT) break;
+        }
+
+        // Swap buffers so callers keep submitting while this batch commits
+        ReviewResult *batch = writer->pending;
+        int count = writer->pending_count;
+        unsigned long flush_target = writer->flush_requests;
+        int closing = writer->closing;
+
+        writer->pending = writer->writing;
+        writer->writing = batch;
+        writer->pending_count = 0;
+        pthread_mutex_unlock(&writer->lock);
+
+        int rc = count > 0 ? (ready ? commit_batch(writer, batch, count) : -1) : 0;
+
+        pthread_mutex_lock(&writer->lock);
+        if (count > 0) {
+            if (rc == 0) {
+                writer->written += count;
+                writer->batches++;
+            } else {
+                writer->dropped += count;
+            }
+        }
+        writer->flushes_done = flush_target;
+        pthread_cond_broadcast(&writer->flushed);
+
+        if (closing && writer->pending_count == 0) break;
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+ReviewWriter* review_writer_open(const char *db_path) {
+    ReviewWriter *writer = calloc(1, sizeof(ReviewWriter));
+    if (!writer) return NULL;
+
+    writer->pending = malloc(REVIEW_WRITER_CAPACITY * sizeof(ReviewResult));
+    writer->writing = malloc(REVIEW_WRITER_CAPACITY * sizeof(ReviewResult));
+    if (!writer->pending || !writer->writing) goto fail;
+
+    if (sqlite3_open(db_path, &writer->db) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Review writer cannot open %s: %s", db_path,
+                       sqlite3_errmsg(writer->db));
+        goto fail;
+    }
+
+    // The database is prepared on the thread, so a reader holding the file
+    // (the game's loader) never stalls the caller
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->wake, NULL);
+    pthread_cond_init(&writer->flushed, NULL);
+    if (pthread_create(&writer->thread, NULL, writer_main, writer) != 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to start review writer thread");
+        pthread_cond_destroy(&writer->flushed);
+        pthread_cond_destroy(&writer->wake);
+        pthread_mutex_destroy(&writer->lock);
+        goto fail;
+    }
+    return writer;
+
+fail:
+    sqlite3_finalize(writer->insert);
+    sqlite3_close(writer->db);
+    free(writer->pending);
+    free(writer->writing);
+    free(writer);
+    return NULL;
+}
+
+int review_writer_submit(ReviewWriter *writer, const ReviewResult *result) {
+    int rc = 0;
+
+    pthread_mutex_lock(&writer->lock);
+    if (writer->pending_count == REVIEW_WRITER_CAPACITY) {
+        writer->dropped++;
+        rc = -1;
+    } else {
+        writer->pending[writer->pending_count++] = *result;
+        writer->submitted++;
+        if (writer->pending_count == REVIEW_WRITER_BATCH) pthread_cond_signal(&writer->wake);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return rc;
+}
+
+void review_writer_flush(ReviewWriter *writer) {
+    pthread_mutex_lock(&writer->lock);
+    unsigned long target = ++writer->flush_requests;
+    pthread_cond_signal(&writer->wake);
+    while (writer->flushes_done < target) {
+        pthread_cond_wait(&writer->flushed, &writer->lock);
+    }
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void review_writer_close(ReviewWriter *writer) {
+    if (!writer) return;
+
+    pthread_mutex_lock(&writer->lock);
+    writer->closing = 1;
+    pthread_cond_signal(&writer->wake);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    COLLECTION_LOG(COLLECTION_LOG_INFO, "Review writer: %lu results written in %lu batches, %lu dropped",
+                   writer->written, writer->batches, writer->dropped);
+
+    pthread_cond_destroy(&writer->flushed);
+    pthread_cond_destroy(&writer->wake);
+    pthread_mutex_destroy(&writer->lock);
+    sqlite3_finalize(writer->insert);
+    sqlite3_close(writer->db);
+    free(writer->pending);
+    free(writer->writing);
+    free(writer);
+}
@@ -0,0 +1,200 @@
+#include "../include/schedule.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/log.h"
+#include "../include/trace.h"
+
+static const char *col_created_sql = "SELECT crt FROM col;";
+
+static const char *card_schedule_sql =
+    "SELECT id, queue, due, ivl, factor, reps, lapses FROM cards WHERE did = ?;";
+
+static const char *card_reviews_sql =
+    "SELECT r.cid, COUNT(*), SUM(r.ease = 1) FROM revlog r "
+    "JOIN cards c ON c.id = r.cid WHERE c.did = ? GROUP BY r.cid;";
+
+static const char *one_card_schedule_sql =
+    "SELECT queue, due, ivl, factor, reps, lapses FROM cards WHERE id = ?;";
+
+static const char *one_card_reviews_sql =
+    "SELECT COUNT(*), SUM(ease = 1) FROM revlog WHERE cid = ?;";
+
+// Cards sorted by id, so query rows find their card with a binary search
+typedef struct {
+    long long card_id;
+    int index;
+} CardIdEntry;
+
+static int compare_card_ids(const void *a, const void *b) {
+    long long x = ((const CardIdEntry *)a)->card_id;
+    long long y = ((const CardIdEntry *)b)->card_id;
+    return (x > y) - (x < y);
+}
+
+static int find_card(const CardIdEntry *ids, int count, long long card_id) {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ids[mid].card_id == card_id) return ids[mid].index;
+        if (ids[mid].card_id < card_id) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+static float overdue_days(int queue, long long due, long long today, long long now) {
+    switch (queue) {
+    case CARD_QUEUE_NEW:
+        return 0.0f;
+    case CARD_QUEUE_LEARNING:
+        return (float)(now - due) / SECONDS_PER_DAY;
+    default:
+        return (float)(today - due);
+    }
+}
+
+// queue, due, ivl, factor, reps, lapses from column first on
+static void read_card_row(sqlite3_stmt *stmt, int first, CardSchedule *entry,
+                          long long today, long long now) {
+    entry->queue = sqlite3_column_int(stmt, first);
+    entry->overdue_days = overdue_days(entry->queue, sqlite3_column_int64(stmt, first + 1),
+                                       today, now);
+    entry->interval = sqlite3_column_int(stmt, first + 2);
+    entry->factor = sqlite3_column_int(stmt, first + 3);
+    entry->reps = sqlite3_column_int(stmt, first + 4);
+    entry->lapses = sqlite3_column_int(stmt, first + 5);
+}
+
+static int prepare(sqlite3 *db, const char *sql, sqlite3_stmt **stmt) {
+    if (sqlite3_prepare_v2(db, sql, -1, stmt, NULL) != SQLITE_OK) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to prepare review query: %s", sqlite3_errmsg(db));
+        *stmt = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+// Days since the collection was created (col.crt)
+static int collection_day(sqlite3_stmt *created, long long now, long long *today) {
+    if (sqlite3_step(created) != SQLITE_ROW) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Collection has no creation time");
+        return -1;
+    }
+    *today = (now - sqlite3_column_int64(created, 0)) / SECONDS_PER_DAY;
+    return 0;
+}
+
+int schedule_load_cards(sqlite3 *db, const long long *deck_ids, int deck_count,
+                        const CardData *cards, const int *indices, int count,
+                        CardSchedule *schedule) {
+    sqlite3_stmt *created = NULL, *card_rows = NULL, *reviews = NULL;
+    CardIdEntry *ids = NULL;
+    long long now = (long long)time(NULL);
+    long long today;
+    int rc = -1;
+
+    if (prepare(db, col_created_sql, &created) < 0 ||
+        prepare(db, card_schedule_sql, &card_rows) < 0 ||
+        prepare(db, card_reviews_sql, &reviews) < 0) {
+        goto done;
+    }
+    if (collection_day(created, now, &today) < 0) goto done;
+
+    ids = malloc((count ? count : 1) * sizeof(CardIdEntry));
+    if (!ids) goto done;
+
+    for (int i = 0; i < count; i++) {
+        ids[i].index = indices ? indices[i] : i;
+        ids[i].card_id = cards[ids[i].index].card_id;
+    }
+    qsort(ids, count, sizeof(CardIdEntry), compare_card_ids);
+
+    for (int d = 0; d < deck_count; d++) {
+        sqlite3_bind_int64(card_rows, 1, deck_ids[d]);
+        while (sqlite3_step(card_rows) == SQLITE_ROW) {
+            int index = find_card(ids, count, sqlite3_column_int64(card_rows, 0));
+            if (index < 0) continue;
+
+            read_card_row(card_rows, 1, &schedule[index], today, now);
+        }
+        sqlite3_reset(card_rows);
+
+        sqlite3_bind_int64(reviews, 1, deck_ids[d]);
+        while (sqlite3_step(reviews) == SQLITE_ROW) {
+            int index = find_card(ids, count, sqlite3_column_int64(reviews, 0));
+            if (index < 0) continue;
+
+            schedule[index].reviews = sqlite3_column_int(reviews, 1);
+            schedule[index].failures = sqlite3_column_int(reviews, 2);
+        }
+        sqlite3_reset(reviews);
+    }
+    rc = 0;
+
+    COLLECTION_LOG(COLLECTION_LOG_INFO, "Loaded review data for %d cards (day %lld)", count, today);
+
+done:
+    sqlite3_finalize(created);
+    sqlite3_finalize(card_rows);
+    sqlite3_finalize(reviews);
+    free(ids);
+    return rc;
+}
+
+int schedule_reload_cards(sqlite3 *db, const CardData *cards, const int *indices, int count,
+                          CardSchedule *schedule) {
+    sqlite3_stmt *created = NULL, *card_row = NULL, *reviews = NULL;
+    long long now = (long long)time(NULL);
+    long long today;
+    int rc = -1;
+
+    if (prepare(db, col_created_sql, &created) < 0 ||
+        prepare(db, one_card_schedule_sql, &card_row) < 0 ||
+        prepare(db, one_card_reviews_sql, &reviews) < 0 ||
+        collection_day(created, now, &today) < 0) {
+        goto done;
+    }
+
+    for (int i = 0; i < count; i++) {
+        CardSchedule *entry = &schedule[indices[i]];
+        long long card_id = cards[indices[i]].card_id;
+
+        memset(entry, 0, sizeof(*entry));
+        sqlite3_bind_int64(card_row, 1, card_id);
+        if (sqlite3_step(card_row) == SQLITE_ROW) read_card_row(card_row, 0, entry, today, now);
+        sqlite3_reset(card_row);
+
+        sqlite3_bind_int64(reviews, 1, card_id);
+        if (sqlite3_step(reviews) == SQLITE_ROW) {
+            entry->reviews = sqlite3_column_int(reviews, 0);
+            entry->failures = sqlite3_column_int(reviews, 1);
+        }
+        sqlite3_reset(reviews);
+    }
+    rc = 0;
+
+done:
+    sqlite3_finalize(created);
+    sqlite3_finalize(card_row);
+    sqlite3_finalize(reviews);
+    return rc;
+}
+
+int collection_load_schedule(CardCollection *collection) {
+    TRACE_SCOPE("collection_load_schedule");
+    CardSchedule *schedule = calloc(collection->count ? collection->count : 1, sizeof(CardSchedule));
+    if (!schedule) return -1;
+
+    if (schedule_load_cards(collection->db, collection->deck_ids, collection->deck_count,
+                            collection->cards, NULL, collection->count, schedule) < 0) {
+        free(schedule);
+        return -1;
+    }
+
+    free(collection->schedule);
+    collection->schedule = schedule;
+    return 0;
+}
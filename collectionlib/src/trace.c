@@ -0,0 +1,111 @@
+#include "../include/trace.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#include "../include/log.h"
+
+uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#ifdef COLLECTION_TRACE
+
+// Writers claim a slot with one fetch-add, then publish it by storing the
+// slot's sequence (its claim index + 1). A reader keeps a slot only if the
+// sequence is the one it expects both before and after copying it, so a
+// half-written or since-overwritten event is skipped rather than torn.
+typedef struct {
+    uint64_t seq;
+    TraceEvent event;
+} TraceSlot;
+
+static TraceSlot ring[TRACE_RING_SIZE];
+static uint64_t ring_head;
+static uint32_t next_thread_id;
+static __thread uint32_t thread_id;
+
+void trace_record(const char *name, uint64_t start_ns, uint64_t end_ns) {
+    if (!thread_id) thread_id = __atomic_add_fetch(&next_thread_id, 1, __ATOMIC_RELAXED);
+
+    uint64_t index = __atomic_fetch_add(&ring_head, 1, __ATOMIC_RELAXED);
+    TraceSlot *slot = &ring[index & (TRACE_RING_SIZE - 1)];
+
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->event.name = name;
+    slot->event.start_ns = start_ns;
+    slot->event.duration_ns = end_ns - start_ns;
+    slot->event.thread = thread_id;
+    __atomic_store_n(&slot->seq, index + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t trace_event_count(void) {
+    return __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+}
+
+static int read_slot(uint64_t index, TraceEvent *out) {
+    const TraceSlot *slot = &ring[index & (TRACE_RING_SIZE - 1)];
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != index + 1) return 0;
+    *out = slot->event;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == index + 1;
+}
+
+int trace_export_chrome(const char *path) {
+    uint64_t head = trace_event_count();
+    uint64_t first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+    uint64_t origin = UINT64_MAX;
+    TraceEvent event;
+    int written = 0;
+
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Cannot write trace %s", path);
+        return -1;
+    }
+
+    // Timestamps start at the oldest surviving event
+    for (uint64_t i = first; i < head; i++) {
+        if (read_slot(i, &event) && event.start_ns < origin) origin = event.start_ns;
+    }
+
+    // Names are string literals from the instrumented code; none need escaping
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    for (uint64_t i = first; i < head; i++) {
+        if (!read_slot(i, &event)) continue;
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                written ? ",\n" : "", event.name, event.thread,
+                (event.start_ns - origin) / 1e3, event.duration_ns / 1e3);
+        written++;
+    }
+    fputs("\n]}\n", f);
+
+    if (fclose(f) != 0) return -1;
+    COLLECTION_LOG(COLLECTION_LOG_INFO, "Wrote %d trace events to %s", written, path);
+    return written;
+}
+
+#else
+
+// Built without tracing: keep the symbols so mixed builds still link
+void trace_record(const char *name, uint64_t start_ns, uint64_t end_ns) {
+    (void)name;
+    (void)start_ns;
+    (void)end_ns;
+}
+
+uint64_t trace_event_count(void) {
+    return 0;
+}
+
+int trace_export_chrome(const char *path) {
+    (void)path;
+    COLLECTION_LOG(COLLECTION_LOG_ERROR, "Tracing is not built in; rebuild with PROFILE=1");
+    return -1;
+}
+
+#endif
@@ -0,0 +1,244 @@
+#include "../include/unicase.h"
+
+#include <stdint.h>
+
+// Code points first..last, every stride-th one, fold to cp + delta
+typedef struct {
+    uint32_t first, last;
+    int32_t delta;
+    uint32_t stride;
+} FoldRun;
+
+// Code points that fold to more than one, zero-padded
+typedef struct {
+    uint32_t cp;
+    uint32_t fold[3];
+} FoldFull;
+
+// Unicode 14.0 CaseFolding.txt, statuses C (one code point) and F (full),
+// without the Turkic T rules: the folding the unicase crate does for Anki.
+// ASCII is folded inline and is not listed.
+static const FoldRun fold_runs[] = {
+    {0x00B5, 0x00B5, 775, 1}, {0x00C0, 0x00D6, 32, 1}, {0x00D8, 0x00DE, 32, 1},
+    {0x0100, 0x012E, 1, 2}, {0x0132, 0x0136, 1, 2}, {0x0139, 0x0147, 1, 2},
+    {0x014A, 0x0176, 1, 2}, {0x0178, 0x0178, -121, 1}, {0x0179, 0x017D, 1, 2},
+    {0x017F, 0x017F, -268, 1}, {0x0181, 0x0181, 210, 1}, {0x0182, 0x0184, 1, 2},
+    {0x0186, 0x0186, 206, 1}, {0x0187, 0x0187, 1, 1}, {0x0189, 0x018A, 205, 1},
+    {0x018B, 0x018B, 1, 1}, {0x018E, 0x018E, 79, 1}, {0x018F, 0x018F, 202, 1},
+    {0x0190, 0x0190, 203, 1}, {0x0191, 0x0191, 1, 1}, {0x0193, 0x0193, 205, 1},
+    {0x0194, 0x0194, 207, 1}, {0x0196, 0x0196, 211, 1}, {0x0197, 0x0197, 209, 1},
+    {0x0198, 0x0198, 1, 1}, {0x019C, 0x019C, 211, 1}, {0x019D, 0x019D, 213, 1},
+    {0x019F, 0x019F, 214, 1}, {0x01A0, 0x01A4, 1, 2}, {0x01A6, 0x01A6, 218, 1},
+    {0x01A7, 0x01A7, 1, 1}, {0x01A9, 0x01A9, 218, 1}, {0x01AC, 0x01AC, 1, 1},
+    {0x01AE, 0x01AE, 218, 1}, {0x01AF, 0x01AF, 1, 1}, {0x01B1, 0x01B2, 217, 1},
+    {0x01B3, 0x01B5, 1, 2}, {0x01B7, 0x01B7, 219, 1}, {0x01B8, 0x01B8, 1, 1},
+    {0x01BC, 0x01BC, 1, 1}, {0x01C4, 0x01C4, 2, 1}, {0x01C5, 0x01C5, 1, 1},
+    {0x01C7, 0x01C7, 2, 1}, {0x01C8, 0x01C8, 1, 1}, {0x01CA, 0x01CA, 2, 1},
+    {0x01CB, 0x01DB, 1, 2}, {0x01DE, 0x01EE, 1, 2}, {0x01F1, 0x01F1, 2, 1},
+    {0x01F2, 0x01F4, 1, 2}, {0x01F6, 0x01F6, -97, 1}, {0x01F7, 0x01F7, -56, 1},
+    {0x01F8, 0x021E, 1, 2}, {0x0220, 0x0220, -130, 1}, {0x0222, 0x0232, 1, 2},
+    {0x023A, 0x023A, 10795, 1}, {0x023B, 0x023B, 1, 1}, {0x023D, 0x023D, -163, 1},
+    {0x023E, 0x023E, 10792, 1}, {0x0241, 0x0241, 1, 1}, {0x0243, 0x0243, -195, 1},
+    {0x0244, 0x0244, 69, 1}, {0x0245, 0x0245, 71, 1}, {0x0246, 0x024E, 1, 2},
+    {0x0345, 0x0345, 116, 1}, {0x0370, 0x0372, 1, 2}, {0x0376, 0x0376, 1, 1},
+    {0x037F, 0x037F, 116, 1}, {0x0386, 0x0386, 38, 1}, {0x0388, 0x038A, 37, 1},
+    {0x038C, 0x038C, 64, 1}, {0x038E, 0x038F, 63, 1}, {0x0391, 0x03A1, 32, 1},
+    {0x03A3, 0x03AB, 32, 1}, {0x03C2, 0x03C2, 1, 1}, {0x03CF, 0x03CF, 8, 1},
+    {0x03D0, 0x03D0, -30, 1}, {0x03D1, 0x03D1, -25, 1}, {0x03D5, 0x03D5, -15, 1},
+    {0x03D6, 0x03D6, -22, 1}, {0x03D8, 0x03EE, 1, 2}, {0x03F0, 0x03F0, -54, 1},
+    {0x03F1, 0x03F1, -48, 1}, {0x03F4, 0x03F4, -60, 1}, {0x03F5, 0x03F5, -64, 1},
+    {0x03F7, 0x03F7, 1, 1}, {0x03F9, 0x03F9, -7, 1}, {0x03FA, 0x03FA, 1, 1},
+    {0x03FD, 0x03FF, -130, 1}, {0x0400, 0x040F, 80, 1}, {0x0410, 0x042F, 32, 1},
+    {0x0460, 0x0480, 1, 2}, {0x048A, 0x04BE, 1, 2}, {0x04C0, 0x04C0, 15, 1},
+    {0x04C1, 0x04CD, 1, 2}, {0x04D0, 0x052E, 1, 2}, {0x0531, 0x0556, 48, 1},
+    {0x10A0, 0x10C5, 7264, 1}, {0x10C7, 0x10C7, 7264, 1}, {0x10CD, 0x10CD, 7264, 1},
+    {0x13F8, 0x13FD, -8, 1}, {0x1C80, 0x1C80, -6222, 1}, {0x1C81, 0x1C81, -6221, 1},
+    {0x1C82, 0x1C82, -6212, 1}, {0x1C83, 0x1C84, -6210, 1}, {0x1C85, 0x1C85, -6211, 1},
+    {0x1C86, 0x1C86, -6204, 1}, {0x1C87, 0x1C87, -6180, 1}, {0x1C88, 0x1C88, 35267, 1},
+    {0x1C90, 0x1CBA, -3008, 1}, {0x1CBD, 0x1CBF, -3008, 1}, {0x1E00, 0x1E94, 1, 2},
+    {0x1E9B, 0x1E9B, -58, 1}, {0x1EA0, 0x1EFE, 1, 2}, {0x1F08, 0x1F0F, -8, 1},
+    {0x1F18, 0x1F1D, -8, 1}, {0x1F28, 0x1F2F, -8, 1}, {0x1F38, 0x1F3F, -8, 1},
+    {0x1F48, 0x1F4D, -8, 1}, {0x1F59, 0x1F5F, -8, 2}, {0x1F68, 0x1F6F, -8, 1},
+    {0x1FB8, 0x1FB9, -8, 1}, {0x1FBA, 0x1FBB, -74, 1}, {0x1FBE, 0x1FBE, -7173, 1},
+    {0x1FC8, 0x1FCB, -86, 1}, {0x1FD8, 0x1FD9, -8, 1}, {0x1FDA, 0x1FDB, -100, 1},
+    {0x1FE8, 0x1FE9, -8, 1}, {0x1FEA, 0x1FEB, -112, 1}, {0x1FEC, 0x1FEC, -7, 1},
+    {0x1FF8, 0x1FF9, -128, 1}, {0x1FFA, 0x1FFB, -126, 1}, {0x2126, 0x2126, -7517, 1},
+    {0x212A, 0x212A, -8383, 1}, {0x212B, 0x212B, -8262, 1}, {0x2132, 0x2132, 28, 1},
+    {0x2160, 0x216F, 16, 1}, {0x2183, 0x2183, 1, 1}, {0x24B6, 0x24CF, 26, 1},
+    {0x2C00, 0x2C2F, 48, 1}, {0x2C60, 0x2C60, 1, 1}, {0x2C62, 0x2C62, -10743, 1},
+    {0x2C63, 0x2C63, -3814, 1}, {0x2C64, 0x2C64, -10727, 1}, {0x2C67, 0x2C6B, 1, 2},
+    {0x2C6D, 0x2C6D, -10780, 1}, {0x2C6E, 0x2C6E, -10749, 1}, {0x2C6F, 0x2C6F, -10783, 1},
+    {0x2C70, 0x2C70, -10782, 1}, {0x2C72, 0x2C72, 1, 1}, {0x2C75, 0x2C75, 1, 1},
+    {0x2C7E, 0x2C7F, -10815, 1}, {0x2C80, 0x2CE2, 1, 2}, {0x2CEB, 0x2CED, 1, 2},
+    {0x2CF2, 0x2CF2, 1, 1}, {0xA640, 0xA66C, 1, 2}, {0xA680, 0xA69A, 1, 2},
+    {0xA722, 0xA72E, 1, 2}, {0xA732, 0xA76E, 1, 2}, {0xA779, 0xA77B, 1, 2},
+    {0xA77D, 0xA77D, -35332, 1}, {0xA77E, 0xA786, 1, 2}, {0xA78B, 0xA78B, 1, 1},
+    {0xA78D, 0xA78D, -42280, 1}, {0xA790, 0xA792, 1, 2}, {0xA796, 0xA7A8, 1, 2},
+    {0xA7AA, 0xA7AA, -42308, 1}, {0xA7AB, 0xA7AB, -42319, 1}, {0xA7AC, 0xA7AC, -42315, 1},
+    {0xA7AD, 0xA7AD, -42305, 1}, {0xA7AE, 0xA7AE, -42308, 1}, {0xA7B0, 0xA7B0, -42258, 1},
+    {0xA7B1, 0xA7B1, -42282, 1}, {0xA7B2, 0xA7B2, -42261, 1}, {0xA7B3, 0xA7B3, 928, 1},
+    {0xA7B4, 0xA7C2, 1, 2}, {0xA7C4, 0xA7C4, -48, 1}, {0xA7C5, 0xA7C5, -42307, 1},
+    {0xA7C6, 0xA7C6, -35384, 1}, {0xA7C7, 0xA7C9, 1, 2}, {0xA7D0, 0xA7D0, 1, 1},
+    {0xA7D6, 0xA7D8, 1, 2}, {0xA7F5, 0xA7F5, 1, 1}, {0xAB70, 0xABBF, -38864, 1},
+    {0xFF21, 0xFF3A, 32, 1}, {0x10400, 0x10427, 40, 1}, {0x104B0, 0x104D3, 40, 1},
+    {0x10570, 0x1057A, 39, 1}, {0x1057C, 0x1058A, 39, 1}, {0x1058C, 0x10592, 39, 1},
+    {0x10594, 0x10595, 39, 1}, {0x10C80, 0x10CB2, 64, 1}, {0x118A0, 0x118BF, 32, 1},
+    {0x16E40, 0x16E5F, 32, 1}, {0x1E900, 0x1E921, 34, 1},
+};
+
+static const FoldFull fold_full[] = {
+    {0x00DF, {0x0073, 0x0073, 0x0000}}, {0x0130, {0x0069, 0x0307, 0x0000}},
+    {0x0149, {0x02BC, 0x006E, 0x0000}}, {0x01F0, {0x006A, 0x030C, 0x0000}},
+    {0x0390, {0x03B9, 0x0308, 0x0301}}, {0x03B0, {0x03C5, 0x0308, 0x0301}},
+    {0x0587, {0x0565, 0x0582, 0x0000}}, {0x1E96, {0x0068, 0x0331, 0x0000}},
+    {0x1E97, {0x0074, 0x0308, 0x0000}}, {0x1E98, {0x0077, 0x030A, 0x0000}},
+    {0x1E99, {0x0079, 0x030A, 0x0000}}, {0x1E9A, {0x0061, 0x02BE, 0x0000}},
+    {0x1E9E, {0x0073, 0x0073, 0x0000}}, {0x1F50, {0x03C5, 0x0313, 0x0000}},
+    {0x1F52, {0x03C5, 0x0313, 0x0300}}, {0x1F54, {0x03C5, 0x0313, 0x0301}},
+    {0x1F56, {0x03C5, 0x0313, 0x0342}}, {0x1F80, {0x1F00, 0x03B9, 0x0000}},
+    {0x1F81, {0x1F01, 0x03B9, 0x0000}}, {0x1F82, {0x1F02, 0x03B9, 0x0000}},
+    {0x1F83, {0x1F03, 0x03B9, 0x0000}}, {0x1F84, {0x1F04, 0x03B9, 0x0000}},
+    {0x1F85, {0x1F05, 0x03B9, 0x0000}}, {0x1F86, {0x1F06, 0x03B9, 0x0000}},
+    {0x1F87, {0x1F07, 0x03B9, 0x0000}}, {0x1F88, {0x1F00, 0x03B9, 0x0000}},
+    {0x1F89, {0x1F01, 0x03B9, 0x0000}}, {0x1F8A, {0x1F02, 0x03B9, 0x0000}},
+    {0x1F8B, {0x1F03, 0x03B9, 0x0000}}, {0x1F8C, {0x1F04, 0x03B9, 0x0000}},
+    {0x1F8D, {0x1F05, 0x03B9, 0x0000}}, {0x1F8E, {0x1F06, 0x03B9, 0x0000}},
+    {0x1F8F, {0x1F07, 0x03B9, 0x0000}}, {0x1F90, {0x1F20, 0x03B9, 0x0000}},
+    {0x1F91, {0x1F21, 0x03B9, 0x0000}}, {0x1F92, {0x1F22, 0x03B9, 0x0000}},
+    {0x1F93, {0x1F23, 0x03B9, 0x0000}}, {0x1F94, {0x1F24, 0x03B9, 0x0000}},
+    {0x1F95, {0x1F25, 0x03B9, 0x0000}}, {0x1F96, {0x1F26, 0x03B9, 0x0000}},
+    {0x1F97, {0x1F27, 0x03B9, 0x0000}}, {0x1F98, {0x1F20, 0x03B9, 0x0000}},
+    {0x1F99, {0x1F21, 0x03B9, 0x0000}}, {0x1F9A, {0x1F22, 0x03B9, 0x0000}},
+    {0x1F9B, {0x1F23, 0x03B9, 0x0000}}, {0x1F9C, {0x1F24, 0x03B9, 0x0000}},
+    {0x1F9D, {0x1F25, 0x03B9, 0x0000}}, {0x1F9E, {0x1F26, 0x03B9, 0x0000}},
+    {0x1F9F, {0x1F27, 0x03B9, 0x0000}}, {0x1FA0, {0x1F60, 0x03B9, 0x0000}},
+    {0x1FA1, {0x1F61, 0x03B9, 0x0000}}, {0x1FA2, {0x1F62, 0x03B9, 0x0000}},
+    {0x1FA3, {0x1F63, 0x03B9, 0x0000}}, {0x1FA4, {0x1F64, 0x03B9, 0x0000}},
+    {0x1FA5, {0x1F65, 0x03B9, 0x0000}}, {0x1FA6, {0x1F66, 0x03B9, 0x0000}},
+    {0x1FA7, {0x1F67, 0x03B9, 0x0000}}, {0x1FA8, {0x1F60, 0x03B9, 0x0000}},
+    {0x1FA9, {0x1F61, 0x03B9, 0x0000}}, {0x1FAA, {0x1F62, 0x03B9, 0x0000}},
+    {0x1FAB, {0x1F63, 0x03B9, 0x0000}}, {0x1FAC, {0x1F64, 0x03B9, 0x0000}},
+    {0x1FAD, {0x1F65, 0x03B9, 0x0000}}, {0x1FAE, {0x1F66, 0x03B9, 0x0000}},
+    {0x1FAF, {0x1F67, 0x03B9, 0x0000}}, {0x1FB2, {0x1F70, 0x03B9, 0x0000}},
+    {0x1FB3, {0x03B1, 0x03B9, 0x0000}}, {0x1FB4, {0x03AC, 0x03B9, 0x0000}},
+    {0x1FB6, {0x03B1, 0x0342, 0x0000}}, {0x1FB7, {0x03B1, 0x0342, 0x03B9}},
+    {0x1FBC, {0x03B1, 0x03B9, 0x0000}}, {0x1FC2, {0x1F74, 0x03B9, 0x0000}},
+    {0x1FC3, {0x03B7, 0x03B9, 0x0000}}, {0x1FC4, {0x03AE, 0x03B9, 0x0000}},
+    {0x1FC6, {0x03B7, 0x0342, 0x0000}}, {0x1FC7, {0x03B7, 0x0342, 0x03B9}},
+    {0x1FCC, {0x03B7, 0x03B9, 0x0000}}, {0x1FD2, {0x03B9, 0x0308, 0x0300}},
+    {0x1FD3, {0x03B9, 0x0308, 0x0301}}, {0x1FD6, {0x03B9, 0x0342, 0x0000}},
+    {0x1FD7, {0x03B9, 0x0308, 0x0342}}, {0x1FE2, {0x03C5, 0x0308, 0x0300}},
+    {0x1FE3, {0x03C5, 0x0308, 0x0301}}, {0x1FE4, {0x03C1, 0x0313, 0x0000}},
+    {0x1FE6, {0x03C5, 0x0342, 0x0000}}, {0x1FE7, {0x03C5, 0x0308, 0x0342}},
+    {0x1FF2, {0x1F7C, 0x03B9, 0x0000}}, {0x1FF3, {0x03C9, 0x03B9, 0x0000}},
+    {0x1FF4, {0x03CE, 0x03B9, 0x0000}}, {0x1FF6, {0x03C9, 0x0342, 0x0000}},
+    {0x1FF7, {0x03C9, 0x0342, 0x03B9}}, {0x1FFC, {0x03C9, 0x03B9, 0x0000}},
+    {0xFB00, {0x0066, 0x0066, 0x0000}}, {0xFB01, {0x0066, 0x0069, 0x0000}},
+    {0xFB02, {0x0066, 0x006C, 0x0000}}, {0xFB03, {0x0066, 0x0066, 0x0069}},
+    {0xFB04, {0x0066, 0x0066, 0x006C}}, {0xFB05, {0x0073, 0x0074, 0x0000}},
+    {0xFB06, {0x0073, 0x0074, 0x0000}}, {0xFB13, {0x0574, 0x0576, 0x0000}},
+    {0xFB14, {0x0574, 0x0565, 0x0000}}, {0xFB15, {0x0574, 0x056B, 0x0000}},
+    {0xFB16, {0x057E, 0x0576, 0x0000}}, {0xFB17, {0x0574, 0x056D, 0x0000}},
+};
+
+#define FOLD_RUN_COUNT (int)(sizeof(fold_runs) / sizeof(fold_runs[0]))
+#define FOLD_FULL_COUNT (int)(sizeof(fold_full) / sizeof(fold_full[0]))
+
+// Folded code points of one string, produced as the comparison asks
+typedef struct {
+    const unsigned char *p;
+    const unsigned char *end;
+    uint32_t pending[3];
+    int pending_pos;
+    int pending_count;
+} FoldCursor;
+
+static uint32_t decode_utf8(FoldCursor *cursor) {
+    const unsigned char *p = cursor->p;
+    size_t left = cursor->end - p;
+    uint32_t cp;
+    size_t n;
+
+    if (p[0] < 0xC2 || p[0] > 0xF4) n = 0;
+    else if (p[0] < 0xE0) n = 2;
+    else if (p[0] < 0xF0) n = 3;
+    else n = 4;
+
+    if (n == 0 || n > left) {
+        cursor->p++;
+        return p[0];
+    }
+    cp = p[0] & (0x7F >> n);
+    for (size_t i = 1; i < n; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            cursor->p++;
+            return p[0];
+        }
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    cursor->p += n;
+    return cp;
+}
+
+// Queue the folding of cp; most code points fold to themselves
+static void fold(FoldCursor *cursor, uint32_t cp) {
+    int lo = 0, hi = FOLD_FULL_COUNT - 1;
+
+    cursor->pending_pos = 0;
+    cursor->pending_count = 1;
+    cursor->pending[0] = cp;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (fold_full[mid].cp == cp) {
+            cursor->pending_count = fold_full[mid].fold[2] ? 3 : 2;
+            for (int i = 0; i < cursor->pending_count; i++) {
+                cursor->pending[i] = fold_full[mid].fold[i];
+            }
+            return;
+        }
+        if (fold_full[mid].cp < cp) lo = mid + 1;
+        else hi = mid - 1;
+    }
+
+    // The last run starting at or before cp
+    lo = 0;
+    hi = FOLD_RUN_COUNT - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (fold_runs[mid].first <= cp) lo = mid;
+        else hi = mid - 1;
+    }
+    const FoldRun *run = &fold_runs[lo];
+    if (cp >= run->first && cp <= run->last && (cp - run->first) % run->stride == 0) {
+        cursor->pending[0] = cp + run->delta;
+    }
+}
+
+// The next folded code point, or -1 at the end
+static int32_t next_folded(FoldCursor *cursor) {
+    if (cursor->pending_pos < cursor->pending_count) {
+        return (int32_t)cursor->pending[cursor->pending_pos++];
+    }
+    if (cursor->p == cursor->end) return -1;
+
+    unsigned char c = *cursor->p;
+    if (c < 0x80) {
+        cursor->p++;
+        return c >= 'A' && c <= 'Z' ? c + 32 : c;
+    }
+    fold(cursor, decode_utf8(cursor));
+    return (int32_t)cursor->pending[cursor->pending_pos++];
+}
+
+int unicase_compare(const char *a, size_t len_a, const char *b, size_t len_b) {
+    FoldCursor ca = {(const unsigned char *)a, (const unsigned char *)a + len_a, {0}, 0, 0};
+    FoldCursor cb = {(const unsigned char *)b, (const unsigned char *)b + len_b, {0}, 0, 0};
+
+    for (;;) {
+        int32_t x = next_folded(&ca);
+        int32_t y = next_folded(&cb);
+        if (x != y) return x < y ? -1 : 1;
+        if (x < 0) return 0;
+    }
+}
@@ -0,0 +1,361 @@
+#include "../include/union.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/deck_cache.h"
+#include "../include/intern.h"
+#include "../include/loader.h"
+#include "../include/log.h"
+#include "../include/refresh.h"
+#include "../include/schedule.h"
+#include "../include/trace.h"
+
+// One collection file and the decks wanted from it
+typedef struct {
+    const char *db_path;
+    const char **deck_names;
+    int name_count;
+    int first_source;           // index of the first DeckSource naming this file
+    DeckInfo key;               // deck cache key of its decks
+    CollectionOptions options;
+    CardCollection *collection; // open from the start, cards only on a union cache miss
+    pthread_t thread;
+    int started;
+    int rc;
+} UnionFile;
+
+static void* load_file(void *arg) {
+    UnionFile *file = arg;
+    file->rc = collection_load_cards(file->collection, file->db_path, &file->key, &file->options);
+    return NULL;
+}
+
+// Sources grouped by file in first-seen order; a deck named twice is kept once
+static int group_sources(const DeckSource *sources, int source_count, UnionFile *files) {
+    int file_count = 0;
+
+    for (int i = 0; i < source_count; i++) {
+        UnionFile *file = NULL;
+        for (int f = 0; f < file_count && !file; f++) {
+            if (strcmp(files[f].db_path, sources[i].db_path) == 0) file = &files[f];
+        }
+
+        if (!file) {
+            file = &files[file_count++];
+            file->db_path = sources[i].db_path;
+            file->first_source = i;
+            file->deck_names = malloc(source_count * sizeof(const char *));
+            if (!file->deck_names) {
+                for (int f = 0; f < file_count; f++) free(files[f].deck_names);
+                return -1;
+            }
+        }
+
+        int named = 0;
+        for (int n = 0; n < file->name_count && !named; n++) {
+            named = strcmp(file->deck_names[n], sources[i].deck_name) == 0;
+        }
+        if (!named) file->deck_names[file->name_count++] = sources[i].deck_name;
+    }
+    return file_count;
+}
+
+// Interned strings are equal exactly when their pointers are
+static int pair_slot(const char *word, const char *reading, int mask) {
+    uint64_t h = (uint64_t)(uintptr_t)word * 0x9E3779B97F4A7C15ULL ^
+                 (uint64_t)(uintptr_t)reading * 0xC2B2AE3D27D4EB4FULL;
+    return (int)((h ^ h >> 29) & mask);
+}
+
+// Append one file's cards to the union. Interned strings make equal strings
+// equal pointers, so a duplicate note is found by hashing and comparing two
+// pointers. Cards parsed from the file were interned as they were parsed;
+// only cards from its deck cache are interned here.
+static int merge_file(CardCollection *merged, const UnionFile *file, InternTable *strings,
+                      int *slots, int mask, int *duplicates) {
+    const CardCollection *source = file->collection;
+    int interned = source->mapping == NULL;
+
+    for (int i = 0; i < source->count; i++) {
+        const CardData *card = &source->cards[i];
+        const char *word = card->word, *reading = card->word_reading;
+        if (!interned) {
+            word = intern_string(strings, word, NULL);
+            reading = intern_string(strings, reading, NULL);
+            if (!word || !reading) return -1;
+        }
+
+        int slot = pair_slot(word, reading, mask);
+        int duplicate = 0;
+        for (; slots[slot] >= 0 && !duplicate; slot = (slot + 1) & mask) {
+            const CardData *kept = &merged->cards[slots[slot]];
+            duplicate = kept->word == word && kept->word_reading == reading;
+        }
+        if (duplicate) {
+            (*duplicates)++;
+            continue;
+        }
+
+        const char *meaning = interned ? card->word_meaning
+                                       : intern_string(strings, card->word_meaning, NULL);
+        if (!meaning) return -1;
+
+        int index = merged->count++;
+        CardData *out = &merged->cards[index];
+        *out = *card;
+        out->word = (char *)word;
+        out->word_reading = (char *)reading;
+        out->word_meaning = (char *)meaning;
+        out->answers = NULL;
+        out->answer_count = 0;
+        merged->card_sources[index] = file->first_source;
+        if (merged->schedule && source->schedule) merged->schedule[index] = source->schedule[i];
+        slots[slot] = index;
+    }
+    return 0;
+}
+
+static int merge_files(CardCollection *merged, const UnionFile *files, int file_count,
+                       InternTable *strings) {
+    TRACE_SCOPE("merge_union");
+    int total = 0, duplicates = 0, rc = 0;
+
+    for (int f = 0; f < file_count; f++) total += files[f].collection->count;
+
+    int capacity = 64;
+    while (capacity < total * 2) capacity *= 2;
+
+    int *slots = malloc(capacity * sizeof(int));
+    merged->card_sources = malloc((total ? total : 1) * sizeof(int));
+    if (!slots || !merged->card_sources || collection_reserve(merged, total ? total : 1) < 0) {
+        free(slots);
+        return -1;
+    }
+    memset(slots, 0xFF, capacity * sizeof(int));
+
+    for (int f = 0; f < file_count && rc == 0; f++) {
+        rc = merge_file(merged, &files[f], strings, slots, capacity - 1, &duplicates);
+    }
+
+    COLLECTION_LOG(COLLECTION_LOG_INFO,
+                   "Union of %d file%s: %d cards, %d duplicates dropped, %d strings, %zu bytes shared",
+                   file_count, file_count == 1 ? "" : "s", merged->count, duplicates,
+                   strings->count, strings->bytes_saved);
+
+    free(slots);
+
+    // Duplicates leave the array oversized; give the tail back
+    if (rc == 0 && merged->count > 0 && merged->count < merged->capacity) {
+        CardData *cards = realloc(merged->cards, merged->count * sizeof(CardData));
+        if (cards) {
+            merged->cards = cards;
+            merged->capacity = merged->count;
+        }
+    }
+    return rc;
+}
+
+// The union cache is keyed by a string naming every file and deck, stored
+// where a deck cache keeps its collection path, and stamped with a hash of
+// each file's deck key and change stamp so a change to any of them rebuilds
+// it. Note edits leave the deck rows alone, and unlike a single deck's
+// cache the union's cannot catch up on them by refreshing.
+static char* union_cache_key(const UnionFile *files, int file_count, int include_subdecks,
+                             DeckInfo *key) {
+    uint64_t stamp = 0xcbf29ce484222325ULL;
+    for (int f = 0; f < file_count; f++) {
+        uint64_t changes;
+        if (collection_change_stamp(files[f].collection, &changes) < 0) return NULL;
+
+        const long long parts[4] = {files[f].key.id, files[f].key.mtime_secs, files[f].key.usn,
+                                    (long long)changes};
+        for (int i = 0; i < 4; i++) stamp = (stamp ^ (uint64_t)parts[i]) * 0x100000001b3ULL;
+    }
+
+    size_t len = 2;
+    for (int f = 0; f < file_count; f++) {
+        len += strlen(files[f].db_path) + 1;
+        for (int n = 0; n < files[f].name_count; n++) len += strlen(files[f].deck_names[n]) + 1;
+    }
+
+    char *name = malloc(len);
+    if (!name) return NULL;
+
+    char *p = name;
+    *p++ = include_subdecks ? '+' : '-';
+    for (int f = 0; f < file_count; f++) {
+        p += sprintf(p, "%s", files[f].db_path);
+        for (int n = 0; n < files[f].name_count; n++) p += sprintf(p, "\x1f%s", files[f].deck_names[n]);
+        *p++ = '\x1e';
+    }
+    *p = '\0';
+
+    uint64_t name_hash = 0xcbf29ce484222325ULL;
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++) {
+        name_hash = (name_hash ^ *c) * 0x100000001b3ULL;
+    }
+    key->id = (long long)(name_hash >> 1);
+    key->mtime_secs = (long long)(stamp >> 1);
+    key->usn = file_count;
+    return name;
+}
+
+// Load each file's cards on its own thread and merge them. The loaders
+// intern what they parse straight into the union's arena, so no file holds
+// a copy of its own strings.
+static int load_and_merge(CardCollection *merged, UnionFile *files, int file_count,
+                          const CollectionOptions *options) {
+    SharedInternTable strings;
+    int failed = 0;
+
+    if (intern_init(&strings.table, &merged->strings, 0) < 0) return -1;
+    pthread_mutex_init(&strings.lock, NULL);
+
+    // Files load side by side, sharing the parser threads between them
+    int threads = loader_thread_count(options->threads) / file_count;
+    if (threads < 1) threads = 1;
+
+    for (int f = 0; f < file_count; f++) {
+        UnionFile *file = &files[f];
+        file->options = *options;
+        file->options.threads = threads;
+        file->options.load_schedule = 0;
+        file->collection->shared_strings = &strings;
+        file->collection->defer_answers = 1;
+
+        file->started = pthread_create(&file->thread, NULL, load_file, file) == 0;
+        if (!file->started) {
+            COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to start loader for %s", file->db_path);
+            failed = 1;
+            break;
+        }
+    }
+
+    for (int f = 0; f < file_count; f++) {
+        if (!files[f].started) continue;
+        pthread_join(files[f].thread, NULL);
+        if (files[f].rc < 0) failed = 1;
+    }
+
+    if (!failed && merge_files(merged, files, file_count, &strings.table) < 0) failed = 1;
+
+    intern_free(&strings.table);
+    pthread_mutex_destroy(&strings.lock);
+    for (int f = 0; f < file_count; f++) files[f].collection->shared_strings = NULL;
+    return failed ? -1 : 0;
+}
+
+// Review data per file, for the cards of the union that came from it
+static int load_union_schedule(CardCollection *merged, const UnionFile *files, int file_count) {
+    int *indices = malloc((merged->count ? merged->count : 1) * sizeof(int));
+    merged->schedule = calloc(merged->count ? merged->count : 1, sizeof(CardSchedule));
+    if (!indices || !merged->schedule) {
+        free(indices);
+        return -1;
+    }
+
+    int rc = 0;
+    for (int f = 0; f < file_count; f++) {
+        const CardCollection *file = files[f].collection;
+        int count = 0;
+        for (int i = 0; i < merged->count; i++) {
+            if (merged->card_sources[i] == files[f].first_source) indices[count++] = i;
+        }
+        if (schedule_load_cards(file->db, file->deck_ids, file->deck_count, merged->cards,
+                                indices, count, merged->schedule) < 0) {
+            rc = -1;
+        }
+    }
+    free(indices);
+    return rc;
+}
+
+CardCollection* setup_collection_union(const DeckSource *sources, int source_count,
+                                       const CollectionOptions *options) {
+    TRACE_SCOPE("setup_collection_union");
+    CardCollection *merged = NULL;
+    char *cache_name = NULL;
+    char cache_path[1024];
+    DeckInfo cache_key;
+    int failed = 0, cached = 0;
+
+    if (source_count < 1) return NULL;
+
+    UnionFile *files = calloc(source_count, sizeof(UnionFile));
+    if (!files) return NULL;
+
+    int file_count = group_sources(sources, source_count, files);
+    if (file_count < 0) failed = 1;
+
+    // Opening the files and resolving their decks is cheap, and gives the
+    // keys that decide whether the union cache still holds
+    for (int f = 0; f < file_count && !failed; f++) {
+        UnionFile *file = &files[f];
+        file->collection = collection_create();
+        if (!file->collection ||
+            collection_open_decks(file->collection, file->db_path, file->deck_names,
+                                  file->name_count, options->include_subdecks, &file->key) < 0) {
+            failed = 1;
+        }
+    }
+
+    if (!failed) {
+        merged = collection_create();
+        if (!merged) failed = 1;
+    }
+
+    if (!failed && options->cache_dir) {
+        cache_name = union_cache_key(files, file_count, options->include_subdecks, &cache_key);
+        if (cache_name &&
+            deck_cache_path(options->cache_dir, cache_name, cache_key.id,
+                            cache_path, sizeof(cache_path)) == 0 &&
+            deck_cache_load(cache_path, cache_name, &cache_key, merged) == 0) {
+            cached = merged->source_count == source_count;
+        }
+        if (cached) {
+            COLLECTION_LOG(COLLECTION_LOG_INFO, "Loaded %d cards from union cache %s",
+                           merged->count, cache_path);
+        } else {
+            // A cache made for other sources leaves cards behind; start over
+            delete_collection(merged);
+            merged = collection_create();
+            if (!merged) failed = 1;
+        }
+    }
+
+    if (!failed && !cached) {
+        if (load_and_merge(merged, files, file_count, options) < 0) {
+            failed = 1;
+        } else {
+            merged->source_count = source_count;
+            // The cache keeps the answers, so they are made first
+            collection_publish(merged);
+            if (cache_name) deck_cache_save(cache_path, cache_name, &cache_key, merged);
+        }
+    }
+
+    // Review data changes with every Anki session, so it is never cached
+    if (!failed && options->load_schedule && load_union_schedule(merged, files, file_count) < 0) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "No review data; cards will be unscheduled");
+    }
+
+    if (failed) {
+        COLLECTION_LOG(COLLECTION_LOG_ERROR, "Failed to load a union of %d decks", source_count);
+        delete_collection(merged);
+        merged = NULL;
+    } else {
+        collection_publish(merged);
+    }
+
+    // The union holds its own copies of every string it kept
+    for (int f = 0; f < (file_count > 0 ? file_count : 0); f++) {
+        delete_collection(files[f].collection);
+        free(files[f].deck_names);
+    }
+    free(cache_name);
+    free(files);
+    return merged;
+}
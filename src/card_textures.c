@@ -0,0 +1,193 @@
+#include "card_textures.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void lru_unlink(CardTextureCache *cache, CardTexture *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->lru_head = entry->next;
+
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->lru_tail = entry->prev;
+
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+static void lru_push_front(CardTextureCache *cache, CardTexture *entry) {
+    entry->prev = NULL;
+    entry->next = cache->lru_head;
+    if (cache->lru_head) cache->lru_head->prev = entry;
+    cache->lru_head = entry;
+    if (!cache->lru_tail) cache->lru_tail = entry;
+}
+
+static void release_entry(CardTextureCache *cache, CardTexture *entry) {
+    lru_unlink(cache, entry);
+    SDL_DestroyTexture(entry->texture);
+    cache->textures_destroyed++;
+    cache->used_bytes -= entry->bytes;
+    entry->texture = NULL;
+    entry->bytes = 0;
+}
+
+static const char* card_text(const CardData *card, CardTextKind kind) {
+    return kind == CARD_TEXT_WORD ? card->word : card->word_meaning;
+}
+
+static int render_entry(CardTextureCache *cache, CardTexture *entry, int card_index, CardTextKind kind) {
+    SDL_Color white = {255, 255, 255, 255};
+    const char *text = card_text(&cache->collection->cards[card_index], kind);
+
+    if (!text || text[0] == '\0') return -1;
+
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(cache->fonts[kind], text, white);
+    if (!surface) return -1;
+
+    size_t bytes = (size_t)surface->w * surface->h * 4;
+
+    // Make room before creating the texture so VRAM never exceeds the budget
+    while (cache->lru_tail && cache->used_bytes + bytes > cache->budget_bytes) {
+        release_entry(cache, cache->lru_tail);
+        cache->evictions++;
+    }
+
+    entry->texture = SDL_CreateTextureFromSurface(cache->renderer, surface);
+    entry->w = surface->w;
+    entry->h = surface->h;
+    SDL_FreeSurface(surface);
+
+    if (!entry->texture) return -1;
+
+    cache->textures_created++;
+    entry->bytes = bytes;
+    cache->used_bytes += bytes;
+    lru_push_front(cache, entry);
+    return 0;
+}
+
+CardTextureCache* card_texture_cache_create(SDL_Renderer *renderer, CardCollection *collection,
+                                            TTF_Font *word_font, TTF_Font *meaning_font,
+                                            size_t budget_bytes) {
+    CardTextureCache *cache = calloc(1, sizeof(CardTextureCache));
+    if (!cache) {
+        fprintf(stderr, "Failed to allocate card texture cache\n");
+        return NULL;
+    }
+
+    cache->renderer = renderer;
+    cache->collection = collection;
+    cache->fonts[CARD_TEXT_WORD] = word_font;
+    cache->fonts[CARD_TEXT_MEANING] = meaning_font;
+    cache->budget_bytes = budget_bytes;
+
+    if (card_texture_cache_grow(cache, collection_published(collection)) < 0) {
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+int card_texture_cache_grow(CardTextureCache *cache, int card_count) {
+    int entry_count = card_count * CARD_TEXT_KINDS;
+    if (entry_count <= cache->entry_count) return 0;
+    if (entry_count <= cache->entry_capacity) {
+        cache->entry_count = entry_count;
+        return 0;
+    }
+
+    // Doubling, so a collection published a batch at a time is copied O(1)
+    // times per card
+    int capacity = cache->entry_capacity * 2;
+    if (capacity < entry_count) capacity = entry_count;
+
+    CardTexture *entries = calloc(capacity, sizeof(CardTexture));
+    if (!entries) {
+        fprintf(stderr, "Failed to allocate card texture entries\n");
+        return -1;
+    }
+
+    // The LRU list links entries by address, so relink it into the new array
+    CardTexture *old = cache->entries;
+    for (int i = 0; i < cache->entry_count; i++) {
+        entries[i] = old[i];
+        if (old[i].prev) entries[i].prev = entries + (old[i].prev - old);
+        if (old[i].next) entries[i].next = entries + (old[i].next - old);
+    }
+    if (cache->lru_head) cache->lru_head = entries + (cache->lru_head - old);
+    if (cache->lru_tail) cache->lru_tail = entries + (cache->lru_tail - old);
+
+    free(old);
+    cache->entries = entries;
+    cache->entry_count = entry_count;
+    cache->entry_capacity = capacity;
+    return 0;
+}
+
+void card_texture_cache_invalidate(CardTextureCache *cache, int card_index) {
+    if (card_index < 0 || (card_index + 1) * CARD_TEXT_KINDS > cache->entry_count) return;
+
+    for (int kind = 0; kind < CARD_TEXT_KINDS; kind++) {
+        CardTexture *entry = &cache->entries[card_index * CARD_TEXT_KINDS + kind];
+        if (entry->texture) release_entry(cache, entry);
+    }
+}
+
+void card_texture_cache_destroy(CardTextureCache *cache) {
+    if (!cache) return;
+
+    while (cache->lru_head) {
+        release_entry(cache, cache->lru_head);
+    }
+    free(cache->entries);
+    free(cache);
+}
+
+int card_texture_cache_preload(CardTextureCache *cache) {
+    int loaded = 0;
+
+    for (int i = 0; i < cache->entry_count / CARD_TEXT_KINDS; i++) {
+        for (int kind = 0; kind < CARD_TEXT_KINDS; kind++) {
+            CardTexture *entry = &cache->entries[i * CARD_TEXT_KINDS + kind];
+            if (entry->texture) continue;
+
+            // Eager loading must not evict what it just loaded
+            if (cache->used_bytes >= cache->budget_bytes) return loaded;
+
+            if (render_entry(cache, entry, i, (CardTextKind)kind) == 0) loaded++;
+        }
+    }
+
+    return loaded;
+}
+
+const CardTexture* card_texture_cache_get(CardTextureCache *cache, int card_index, CardTextKind kind) {
+    if (card_index < 0 || card_index * CARD_TEXT_KINDS + (int)kind >= cache->entry_count) return NULL;
+
+    CardTexture *entry = &cache->entries[card_index * CARD_TEXT_KINDS + kind];
+
+    if (entry->texture) {
+        cache->hits++;
+        if (cache->lru_head != entry) {
+            lru_unlink(cache, entry);
+            lru_push_front(cache, entry);
+        }
+        return entry;
+    }
+
+    cache->misses++;
+    if (render_entry(cache, entry, card_index, kind) < 0) return NULL;
+    return entry;
+}
+
+void card_texture_cache_draw(CardTextureCache *cache, int card_index, CardTextKind kind,
+                             int x, int y, SDL_Color color) {
+    const CardTexture *entry = card_texture_cache_get(cache, card_index, kind);
+    if (!entry) return;
+
+    SDL_SetTextureColorMod(entry->texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(entry->texture, color.a);
+
+    SDL_Rect dest = {x - entry->w / 2, y, entry->w, entry->h};
+    SDL_RenderCopy(cache->renderer, entry->texture, NULL, &dest);
+}
@@ -0,0 +1,69 @@
+#ifndef CARD_TEXTURES_H
+#define CARD_TEXTURES_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "../collectionlib/include/collection.h"
+
+typedef enum {
+    CARD_TEXT_WORD = 0,
+    CARD_TEXT_MEANING = 1,
+    CARD_TEXT_KINDS = 2
+} CardTextKind;
+
+// One pre-rendered card string, linked into the LRU list while resident
+typedef struct CardTexture {
+    SDL_Texture *texture;
+    int w, h;
+    size_t bytes;
+    struct CardTexture *prev;
+    struct CardTexture *next;
+} CardTexture;
+
+// Card text only changes when a refresh picks up an edit, so each card's
+// word and meaning are rasterized once (white, tinted at blit time) and kept
+// until the byte budget forces the least recently used texture out.
+typedef struct {
+    SDL_Renderer *renderer;
+    CardCollection *collection;
+    TTF_Font *fonts[CARD_TEXT_KINDS];
+
+    CardTexture *entries;   // CARD_TEXT_KINDS slots per known card
+    int entry_count;
+    int entry_capacity;
+    CardTexture *lru_head;  // most recently used
+    CardTexture *lru_tail;
+
+    size_t budget_bytes;
+    size_t used_bytes;
+
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    unsigned long textures_created;
+    unsigned long textures_destroyed;
+} CardTextureCache;
+
+CardTextureCache* card_texture_cache_create(SDL_Renderer *renderer, CardCollection *collection,
+                                            TTF_Font *word_font, TTF_Font *meaning_font,
+                                            size_t budget_bytes);
+void card_texture_cache_destroy(CardTextureCache *cache);
+
+// Make room for cards an async load published since; resident textures stay
+int card_texture_cache_grow(CardTextureCache *cache, int card_count);
+
+// Drop a card's textures after its text was edited; the next get renders it anew
+void card_texture_cache_invalidate(CardTextureCache *cache, int card_index);
+
+// Render every card up front, stopping once the budget is full
+int card_texture_cache_preload(CardTextureCache *cache);
+
+// Resident texture for a card string, rendering it on a miss
+const CardTexture* card_texture_cache_get(CardTextureCache *cache, int card_index, CardTextKind kind);
+
+// Blit a card string centred horizontally on x
+void card_texture_cache_draw(CardTextureCache *cache, int card_index, CardTextKind kind,
+                             int x, int y, SDL_Color color);
+
+#endif
@@ -0,0 +1,166 @@
+#include "enemies.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int padded(int count) {
+    return (count + ENEMY_LANES - 1) / ENEMY_LANES * ENEMY_LANES;
+}
+
+static void* alloc_lanes(int lanes, size_t size) {
+    // Block-aligned so each update block is one or two vector loads
+    return aligned_alloc(ENEMY_LANES * sizeof(float), lanes * size);
+}
+
+static void clear_lane(EnemyPool *pool, int slot) {
+    pool->x[slot] = 0;
+    pool->y[slot] = ENEMY_PAD_Y;
+    pool->prev_y[slot] = ENEMY_PAD_Y;
+    pool->vy[slot] = 0;
+}
+
+EnemyPool* enemy_pool_create(int capacity) {
+    EnemyPool *pool = calloc(1, sizeof(EnemyPool));
+    if (!pool) return NULL;
+
+    int lanes = padded(capacity > 0 ? capacity : 1);
+    pool->capacity = capacity;
+    pool->x = alloc_lanes(lanes, sizeof(float));
+    pool->y = alloc_lanes(lanes, sizeof(float));
+    pool->prev_y = alloc_lanes(lanes, sizeof(float));
+    pool->vy = alloc_lanes(lanes, sizeof(float));
+    pool->card_index = malloc(lanes * sizeof(int));
+    pool->id = malloc(lanes * sizeof(int));
+    pool->slot = malloc(lanes * sizeof(int));
+    pool->alive = calloc((capacity + 63) / 64 + 1, sizeof(uint64_t));
+    pool->free_ids = malloc(lanes * sizeof(int));
+    pool->fading = malloc(lanes * sizeof(FadingEnemy));
+    pool->fading_capacity = lanes;
+
+    if (!pool->x || !pool->y || !pool->prev_y || !pool->vy || !pool->card_index || !pool->id ||
+        !pool->slot || !pool->alive || !pool->free_ids || !pool->fading) {
+        enemy_pool_destroy(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < lanes; i++) clear_lane(pool, i);
+
+    // Hand out low ids first
+    for (int i = 0; i < capacity; i++) pool->free_ids[i] = capacity - 1 - i;
+    pool->free_count = capacity;
+    return pool;
+}
+
+void enemy_pool_destroy(EnemyPool *pool) {
+    if (!pool) return;
+    free(pool->x);
+    free(pool->y);
+    free(pool->prev_y);
+    free(pool->vy);
+    free(pool->card_index);
+    free(pool->id);
+    free(pool->slot);
+    free(pool->alive);
+    free(pool->free_ids);
+    free(pool->fading);
+    free(pool);
+}
+
+int enemy_pool_spawn(EnemyPool *pool, int card_index, float x, float y, float vy) {
+    if (pool->free_count == 0) return -1;
+
+    int id = pool->free_ids[--pool->free_count];
+    int slot = pool->count++;
+
+    pool->x[slot] = x;
+    pool->y[slot] = y;
+    pool->prev_y[slot] = y;
+    pool->vy[slot] = vy;
+    pool->card_index[slot] = card_index;
+    pool->id[slot] = id;
+    pool->slot[id] = slot;
+    pool->alive[id >> 6] |= 1ULL << (id & 63);
+    return id;
+}
+
+void enemy_pool_despawn(EnemyPool *pool, int id) {
+    if (!enemy_pool_is_alive(pool, id)) return;
+
+    // Move the last live enemy into the hole
+    int slot = pool->slot[id];
+    int last = --pool->count;
+    if (slot != last) {
+        pool->x[slot] = pool->x[last];
+        pool->y[slot] = pool->y[last];
+        pool->prev_y[slot] = pool->prev_y[last];
+        pool->vy[slot] = pool->vy[last];
+        pool->card_index[slot] = pool->card_index[last];
+        pool->id[slot] = pool->id[last];
+        pool->slot[pool->id[slot]] = slot;
+    }
+    clear_lane(pool, last);
+
+    pool->alive[id >> 6] &= ~(1ULL << (id & 63));
+    pool->free_ids[pool->free_count++] = id;
+}
+
+static FadingEnemy* fading_slot(EnemyPool *pool) {
+    if (pool->fading_count == pool->fading_capacity) {
+        int capacity = pool->fading_capacity * 2;
+        FadingEnemy *grown = realloc(pool->fading, capacity * sizeof(FadingEnemy));
+        if (grown) {
+            pool->fading = grown;
+            pool->fading_capacity = capacity;
+        }
+    }
+    if (pool->fading_count < pool->fading_capacity) return &pool->fading[pool->fading_count++];
+
+    // Out of memory: reuse the entry that has faded longest
+    int oldest = 0;
+    for (int i = 1; i < pool->fading_count; i++) {
+        if ((int32_t)(pool->fading[i].death_time - pool->fading[oldest].death_time) < 0) oldest = i;
+    }
+    return &pool->fading[oldest];
+}
+
+void enemy_pool_kill(EnemyPool *pool, int id, uint32_t now) {
+    if (!enemy_pool_is_alive(pool, id)) return;
+
+    int slot = pool->slot[id];
+    FadingEnemy *fading = fading_slot(pool);
+    fading->x = pool->x[slot];
+    fading->y = pool->y[slot];
+    fading->card_index = pool->card_index[slot];
+    fading->death_time = now;
+
+    enemy_pool_despawn(pool, id);
+}
+
+// Fixed-width inner loop: GCC vectorizes this at -O2, a plain loop over the
+// count it does not. Padding lanes have vy 0 and sit far above the line.
+static int advance_lanes(float *restrict y, float *restrict prev_y, const float *restrict vy,
+                         int lanes, float dt, float kill_line) {
+    int crossed = 0;
+    for (int base = 0; base < lanes; base += ENEMY_LANES) {
+        for (int j = 0; j < ENEMY_LANES; j++) {
+            prev_y[base + j] = y[base + j];
+            y[base + j] += vy[base + j] * dt;
+            crossed |= y[base + j] > kill_line;
+        }
+    }
+    return crossed;
+}
+
+int enemy_pool_update(EnemyPool *pool, float dt, float kill_line) {
+    return advance_lanes(pool->y, pool->prev_y, pool->vy, padded(pool->count), dt, kill_line);
+}
+
+void enemy_pool_expire(EnemyPool *pool, uint32_t now, uint32_t duration) {
+    for (int i = 0; i < pool->fading_count; ) {
+        if (now - pool->fading[i].death_time > duration) {
+            pool->fading[i] = pool->fading[--pool->fading_count];
+        } else {
+            i++;
+        }
+    }
+}
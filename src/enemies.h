@@ -0,0 +1,66 @@
+#ifndef ENEMIES_H
+#define ENEMIES_H
+
+#include <stdint.h>
+
+#define ENEMY_LANES 8           // update block width; dense arrays are padded to it
+#define ENEMY_PAD_Y (-1e30f)    // y of unused lanes, never past any kill line
+
+// A killed enemy showing its meaning; it no longer moves or matches input
+typedef struct {
+    float x, y;
+    int card_index;
+    uint32_t death_time;
+} FadingEnemy;
+
+// Falling enemies in structure-of-arrays form. Live enemies occupy the dense
+// range [0, count) and ids stay stable across the swap-removes that keep it
+// dense, so other tables (reading index, trie) can key on them. The update
+// pass runs in fixed-width blocks over padded arrays so it vectorizes.
+typedef struct {
+    int capacity;
+    int count;
+
+    // Dense, indexed by slot
+    float *x;
+    float *y;
+    float *prev_y;              // y before the last update, for interpolation
+    float *vy;
+    int *card_index;
+    int *id;
+
+    // Sparse, indexed by id
+    int *slot;
+    uint64_t *alive;            // bitset of ids in use
+    int *free_ids;              // stack of unused ids
+    int free_count;
+
+    // Kills stay here for the meaning duration, so they can outnumber the
+    // live capacity; the array grows on demand
+    FadingEnemy *fading;
+    int fading_count;
+    int fading_capacity;
+} EnemyPool;
+
+EnemyPool* enemy_pool_create(int capacity);
+void enemy_pool_destroy(EnemyPool *pool);
+
+// Returns the new enemy's id, or -1 when the pool is full
+int enemy_pool_spawn(EnemyPool *pool, int card_index, float x, float y, float vy);
+
+// Remove a live enemy; despawn drops it, kill leaves it fading. If the
+// fading array cannot grow, the oldest fading enemy makes way.
+void enemy_pool_despawn(EnemyPool *pool, int id);
+void enemy_pool_kill(EnemyPool *pool, int id, uint32_t now);
+
+// Advance every live enemy; non-zero if any is past kill_line
+int enemy_pool_update(EnemyPool *pool, float dt, float kill_line);
+
+// Drop fading enemies older than duration
+void enemy_pool_expire(EnemyPool *pool, uint32_t now, uint32_t duration);
+
+static inline int enemy_pool_is_alive(const EnemyPool *pool, int id) {
+    return id >= 0 && id < pool->capacity && ((pool->alive[id >> 6] >> (id & 63)) & 1);
+}
+
+#endif
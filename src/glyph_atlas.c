@@ -0,0 +1,340 @@
+#include "glyph_atlas.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLYPH_TABLE_INITIAL 256
+#define GLYPH_BATCH_INITIAL 64
+#define REPLACEMENT_CHAR 0xFFFD
+
+// Decode one UTF-8 sequence and advance the cursor; malformed input yields U+FFFD
+static Uint32 utf8_next(const char **cursor) {
+    const unsigned char *s = (const unsigned char *)*cursor;
+    Uint32 cp;
+    int extra;
+
+    if (s[0] < 0x80) {
+        *cursor += 1;
+        return s[0];
+    } else if ((s[0] & 0xE0) == 0xC0) {
+        cp = s[0] & 0x1F;
+        extra = 1;
+    } else if ((s[0] & 0xF0) == 0xE0) {
+        cp = s[0] & 0x0F;
+        extra = 2;
+    } else if ((s[0] & 0xF8) == 0xF0) {
+        cp = s[0] & 0x07;
+        extra = 3;
+    } else {
+        *cursor += 1;
+        return REPLACEMENT_CHAR;
+    }
+
+    for (int i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *cursor += i;
+            return REPLACEMENT_CHAR;
+        }
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+
+    *cursor += extra + 1;
+    return cp;
+}
+
+static Uint32 hash_codepoint(Uint32 cp) {
+    cp ^= cp >> 16;
+    cp *= 0x7feb352d;
+    cp ^= cp >> 15;
+    return cp;
+}
+
+static Glyph* find_slot(Glyph *table, int capacity, Uint32 cp) {
+    Uint32 mask = (Uint32)capacity - 1;
+    Uint32 i = hash_codepoint(cp) & mask;
+
+    while (table[i].codepoint != 0 && table[i].codepoint != cp) {
+        i = (i + 1) & mask;
+    }
+    return &table[i];
+}
+
+static int grow_table(GlyphAtlas *atlas) {
+    int new_capacity = atlas->glyph_capacity * 2;
+    Glyph *table = calloc(new_capacity, sizeof(Glyph));
+    if (!table) return -1;
+
+    for (int i = 0; i < atlas->glyph_capacity; i++) {
+        if (atlas->glyphs[i].codepoint == 0) continue;
+        *find_slot(table, new_capacity, atlas->glyphs[i].codepoint) = atlas->glyphs[i];
+    }
+
+    free(atlas->glyphs);
+    atlas->glyphs = table;
+    atlas->glyph_capacity = new_capacity;
+    return 0;
+}
+
+static int add_page(GlyphAtlas *atlas) {
+    if (atlas->page_count >= GLYPH_ATLAS_MAX_PAGES) return -1;
+
+    SDL_Texture *page = SDL_CreateTexture(atlas->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                          SDL_TEXTUREACCESS_STATIC,
+                                          GLYPH_ATLAS_PAGE_SIZE, GLYPH_ATLAS_PAGE_SIZE);
+    if (!page) {
+        fprintf(stderr, "Failed to create glyph atlas page: %s\n", SDL_GetError());
+        return -1;
+    }
+    SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+    atlas->pages[atlas->page_count++] = page;
+    atlas->shelf_x = 0;
+    atlas->shelf_y = 0;
+    atlas->shelf_h = 0;
+    return 0;
+}
+
+// Reserve a w x h rectangle using a simple shelf packer
+static int pack_rect(GlyphAtlas *atlas, int w, int h, SDL_Rect *out) {
+    int pw = w + GLYPH_ATLAS_PADDING;
+    int ph = h + GLYPH_ATLAS_PADDING;
+
+    if (pw > GLYPH_ATLAS_PAGE_SIZE || ph > GLYPH_ATLAS_PAGE_SIZE) return -1;
+
+    if (atlas->page_count == 0 && add_page(atlas) < 0) return -1;
+
+    if (atlas->shelf_x + pw > GLYPH_ATLAS_PAGE_SIZE) {
+        atlas->shelf_y += atlas->shelf_h;
+        atlas->shelf_x = 0;
+        atlas->shelf_h = 0;
+    }
+    if (atlas->shelf_y + ph > GLYPH_ATLAS_PAGE_SIZE) {
+        if (add_page(atlas) < 0) return -1;
+    }
+
+    out->x = atlas->shelf_x;
+    out->y = atlas->shelf_y;
+    out->w = w;
+    out->h = h;
+
+    atlas->shelf_x += pw;
+    if (ph > atlas->shelf_h) atlas->shelf_h = ph;
+    return atlas->page_count - 1;
+}
+
+static void rasterize_glyph(GlyphAtlas *atlas, Glyph *glyph) {
+    SDL_Color white = {255, 255, 255, 255};
+    int advance = 0;
+
+    glyph->page = -1;
+    glyph->src.w = 0;
+    glyph->src.h = 0;
+
+    if (TTF_GlyphMetrics32(atlas->font, glyph->codepoint, NULL, NULL, NULL, NULL, &advance) == 0) {
+        glyph->advance = advance;
+    }
+
+    SDL_Surface *surface = TTF_RenderGlyph32_Blended(atlas->font, glyph->codepoint, white);
+    if (!surface) return;
+
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        if (!converted) return;
+        surface = converted;
+    }
+
+    if (advance == 0) glyph->advance = surface->w;
+
+    int page = pack_rect(atlas, surface->w, surface->h, &glyph->src);
+    if (page >= 0) {
+        SDL_UpdateTexture(atlas->pages[page], &glyph->src, surface->pixels, surface->pitch);
+        glyph->page = page;
+    }
+
+    SDL_FreeSurface(surface);
+    atlas->rasterized++;
+}
+
+static const Glyph* lookup_glyph(GlyphAtlas *atlas, Uint32 cp) {
+    Glyph *slot = find_slot(atlas->glyphs, atlas->glyph_capacity, cp);
+    if (slot->codepoint == cp) return slot;
+
+    // Keep the load factor under 3/4 before inserting
+    if ((atlas->glyph_count + 1) * 4 > atlas->glyph_capacity * 3) {
+        if (grow_table(atlas) < 0) return NULL;
+        slot = find_slot(atlas->glyphs, atlas->glyph_capacity, cp);
+    }
+
+    memset(slot, 0, sizeof(Glyph));
+    slot->codepoint = cp;
+    atlas->glyph_count++;
+    rasterize_glyph(atlas, slot);
+    return slot;
+}
+
+static int reserve_quads(GlyphAtlas *atlas, int extra) {
+    if (atlas->quad_count + extra <= atlas->quad_capacity) return 0;
+
+    int capacity = atlas->quad_capacity ? atlas->quad_capacity : GLYPH_BATCH_INITIAL;
+    while (capacity < atlas->quad_count + extra) capacity *= 2;
+
+    SDL_Vertex *vertices = realloc(atlas->vertices, capacity * 4 * sizeof(SDL_Vertex));
+    if (!vertices) return -1;
+    atlas->vertices = vertices;
+
+    int *indices = realloc(atlas->indices, capacity * 6 * sizeof(int));
+    if (!indices) return -1;
+    atlas->indices = indices;
+
+    // Index pattern never changes, so fill it once per growth
+    for (int q = atlas->quad_capacity; q < capacity; q++) {
+        int *idx = &indices[q * 6];
+        int v = q * 4;
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 3; idx[5] = v;
+    }
+
+    atlas->quad_capacity = capacity;
+    return 0;
+}
+
+static void push_quad(GlyphAtlas *atlas, int page, const SDL_Rect *src, float x, float y,
+                      SDL_Color color) {
+    if (atlas->quad_count > 0 && atlas->batch_page != page) {
+        glyph_atlas_flush(atlas);
+    }
+    if (reserve_quads(atlas, 1) < 0) return;
+
+    atlas->batch_page = page;
+
+    const float inv = 1.0f / GLYPH_ATLAS_PAGE_SIZE;
+    float u0 = src->x * inv;
+    float v0 = src->y * inv;
+    float u1 = (src->x + src->w) * inv;
+    float v1 = (src->y + src->h) * inv;
+    float x1 = x + src->w;
+    float y1 = y + src->h;
+
+    SDL_Vertex *v = &atlas->vertices[atlas->quad_count * 4];
+    v[0] = (SDL_Vertex){{x,  y},  color, {u0, v0}};
+    v[1] = (SDL_Vertex){{x1, y},  color, {u1, v0}};
+    v[2] = (SDL_Vertex){{x1, y1}, color, {u1, v1}};
+    v[3] = (SDL_Vertex){{x,  y1}, color, {u0, v1}};
+
+    atlas->quad_count++;
+}
+
+GlyphAtlas* glyph_atlas_create(SDL_Renderer *renderer, TTF_Font *font) {
+    GlyphAtlas *atlas = calloc(1, sizeof(GlyphAtlas));
+    if (!atlas) {
+        fprintf(stderr, "Failed to allocate glyph atlas\n");
+        return NULL;
+    }
+
+    atlas->renderer = renderer;
+    atlas->font = font;
+    atlas->height = TTF_FontHeight(font);
+    atlas->glyph_capacity = GLYPH_TABLE_INITIAL;
+    atlas->glyphs = calloc(atlas->glyph_capacity, sizeof(Glyph));
+
+    if (!atlas->glyphs || add_page(atlas) < 0) {
+        glyph_atlas_destroy(atlas);
+        return NULL;
+    }
+
+    return atlas;
+}
+
+void glyph_atlas_destroy(GlyphAtlas *atlas) {
+    if (!atlas) return;
+
+    for (int i = 0; i < atlas->page_count; i++) {
+        SDL_DestroyTexture(atlas->pages[i]);
+    }
+    free(atlas->glyphs);
+    free(atlas->vertices);
+    free(atlas->indices);
+    free(atlas);
+}
+
+void glyph_atlas_measure(GlyphAtlas *atlas, const char *text, int *w, int *h) {
+    int width = 0;
+    Uint32 prev = 0;
+
+    while (text && *text) {
+        Uint32 cp = utf8_next(&text);
+        const Glyph *glyph = lookup_glyph(atlas, cp);
+        if (!glyph) continue;
+
+        if (prev) width += TTF_GetFontKerningSizeGlyphs32(atlas->font, prev, cp);
+        width += glyph->advance;
+        prev = cp;
+    }
+
+    if (w) *w = width;
+    if (h) *h = atlas->height;
+}
+
+void glyph_atlas_draw(GlyphAtlas *atlas, const char *text, int x, int y, SDL_Color color) {
+    float pen_x = (float)x;
+    Uint32 prev = 0;
+
+    while (text && *text) {
+        Uint32 cp = utf8_next(&text);
+        const Glyph *glyph = lookup_glyph(atlas, cp);
+        if (!glyph) continue;
+
+        if (prev) pen_x += TTF_GetFontKerningSizeGlyphs32(atlas->font, prev, cp);
+        if (glyph->page >= 0 && glyph->src.w > 0) {
+            push_quad(atlas, glyph->page, &glyph->src, pen_x, (float)y, color);
+        }
+        pen_x += glyph->advance;
+        prev = cp;
+    }
+}
+
+int glyph_atlas_layout(GlyphAtlas *atlas, const char *text, GlyphQuad *quads, int max_quads,
+                       int *w) {
+    float pen_x = 0.0f;
+    Uint32 prev = 0;
+    int count = 0;
+
+    while (text && *text) {
+        Uint32 cp = utf8_next(&text);
+        const Glyph *glyph = lookup_glyph(atlas, cp);
+        if (!glyph) continue;
+
+        if (prev) pen_x += TTF_GetFontKerningSizeGlyphs32(atlas->font, prev, cp);
+        if (glyph->page >= 0 && glyph->src.w > 0 && count < max_quads) {
+            quads[count].page = glyph->page;
+            quads[count].src = glyph->src;
+            quads[count].x = pen_x;
+            count++;
+        }
+        pen_x += glyph->advance;
+        prev = cp;
+    }
+
+    if (w) *w = (int)pen_x;
+    return count;
+}
+
+void glyph_atlas_draw_quads(GlyphAtlas *atlas, const GlyphQuad *quads, int count, int x, int y,
+                            SDL_Color color) {
+    for (int i = 0; i < count; i++) {
+        push_quad(atlas, quads[i].page, &quads[i].src, x + quads[i].x, (float)y, color);
+    }
+}
+
+void glyph_atlas_flush(GlyphAtlas *atlas) {
+    if (atlas->quad_count == 0) return;
+
+    SDL_RenderGeometry(atlas->renderer, atlas->pages[atlas->batch_page],
+                       atlas->vertices, atlas->quad_count * 4,
+                       atlas->indices, atlas->quad_count * 6);
+
+    atlas->quad_count = 0;
+    atlas->draw_calls++;
+}
@@ -0,0 +1,74 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#define GLYPH_ATLAS_PAGE_SIZE 1024
+#define GLYPH_ATLAS_MAX_PAGES 4
+#define GLYPH_ATLAS_PADDING 1
+
+// A glyph rasterized once into one of the atlas pages
+typedef struct {
+    Uint32 codepoint;   // 0 marks an empty hash slot
+    int page;           // -1 if the glyph could not be rasterized
+    SDL_Rect src;
+    int advance;
+} Glyph;
+
+// A glyph placed by glyph_atlas_layout, x relative to the start of the string.
+// Packed glyphs never move, so a layout stays valid for the atlas's lifetime.
+typedef struct {
+    int page;
+    SDL_Rect src;
+    float x;
+} GlyphQuad;
+
+// Per-font glyph cache: every (font, codepoint) pair is rasterized once into
+// a shared texture page, strings are laid out from the cached metrics and
+// drawn as batched quads with SDL_RenderGeometry.
+typedef struct {
+    SDL_Renderer *renderer;
+    TTF_Font *font;
+    int height;
+
+    SDL_Texture *pages[GLYPH_ATLAS_MAX_PAGES];
+    int page_count;
+    int shelf_x, shelf_y, shelf_h;
+
+    Glyph *glyphs;
+    int glyph_count;
+    int glyph_capacity;
+
+    SDL_Vertex *vertices;
+    int *indices;
+    int quad_count;
+    int quad_capacity;
+    int batch_page;
+
+    unsigned long rasterized;
+    unsigned long draw_calls;
+} GlyphAtlas;
+
+GlyphAtlas* glyph_atlas_create(SDL_Renderer *renderer, TTF_Font *font);
+void glyph_atlas_destroy(GlyphAtlas *atlas);
+
+// Size of the laid out string in pixels, rasterizing missing glyphs
+void glyph_atlas_measure(GlyphAtlas *atlas, const char *text, int *w, int *h);
+
+// Queue a string with its top-left corner at (x, y); drawn on the next flush
+void glyph_atlas_draw(GlyphAtlas *atlas, const char *text, int x, int y, SDL_Color color);
+
+// Lay out a string into at most max_quads quads, rasterizing missing glyphs.
+// Returns the quad count and stores the width in pixels in *w.
+int glyph_atlas_layout(GlyphAtlas *atlas, const char *text, GlyphQuad *quads, int max_quads,
+                       int *w);
+
+// Queue a layout with its top-left corner at (x, y); no lookups or kerning
+void glyph_atlas_draw_quads(GlyphAtlas *atlas, const GlyphQuad *quads, int count, int x, int y,
+                            SDL_Color color);
+
+// Submit all queued quads to the renderer
+void glyph_atlas_flush(GlyphAtlas *atlas);
+
+#endif
@@ -1,189 +1,175 @@
-
 #include "hiragana.h"
 
-typedef struct {
-    const char *romaji;
-    const char *hiragana;
-} RomajiPair;
-
-// Romaji to Hiragana conversion table
-static const RomajiPair romaji_table[] = {
-    // Combined characters first (longer matches)
-    {"kya", "きゃ"}, {"kyu", "きゅ"}, {"kyo", "きょ"},
-    {"sha", "しゃ"}, {"shu", "しゅ"}, {"sho", "しょ"},
-    {"cha", "ちゃ"}, {"chu", "ちゅ"}, {"cho", "ちょ"},
-    {"nya", "にゃ"}, {"nyu", "にゅ"}, {"nyo", "にょ"},
-    {"hya", "ひゃ"}, {"hyu", "ひゅ"}, {"hyo", "ひょ"},
-    {"mya", "みゃ"}, {"myu", "みゅ"}, {"myo", "みょ"},
-    {"rya", "りゃ"}, {"ryu", "りゅ"}, {"ryo", "りょ"},
-    {"gya", "ぎゃ"}, {"gyu", "ぎゅ"}, {"gyo", "ぎょ"},
-    {"ja", "じゃ"}, {"ju", "じゅ"}, {"jo", "じょ"},
-    {"bya", "びゃ"}, {"byu", "びゅ"}, {"byo", "びょ"},
-    {"pya", "ぴゃ"}, {"pyu", "ぴゅ"}, {"pyo", "ぴょ"},
-    
-    // Basic characters
-    {"ka", "か"}, {"ki", "き"}, {"ku", "く"}, {"ke", "け"}, {"ko", "こ"},
-    {"ga", "が"}, {"gi", "ぎ"}, {"gu", "ぐ"}, {"ge", "げ"}, {"go", "ご"},
-    {"sa", "さ"}, {"shi", "し"}, {"su", "す"}, {"se", "せ"}, {"so", "そ"},
-    {"za", "ざ"}, {"ji", "じ"}, {"zu", "ず"}, {"ze", "ぜ"}, {"zo", "ぞ"},
-    {"ta", "た"}, {"chi", "ち"}, {"tsu", "つ"}, {"te", "て"}, {"to", "と"},
-    {"da", "だ"}, {"dzi", "ぢ"}, {"dzu", "づ"}, {"de", "で"}, {"do", "ど"},
-    {"na", "な"}, {"ni", "に"}, {"nu", "ぬ"}, {"ne", "ね"}, {"no", "の"},
-    {"ha", "は"}, {"hi", "ひ"}, {"fu", "ふ"}, {"he", "へ"}, {"ho", "ほ"},
-    {"ba", "ば"}, {"bi", "び"}, {"bu", "ぶ"}, {"be", "べ"}, {"bo", "ぼ"},
-    {"pa", "ぱ"}, {"pi", "ぴ"}, {"pu", "ぷ"}, {"pe", "ぺ"}, {"po", "ぽ"},
-    {"ma", "ま"}, {"mi", "み"}, {"mu", "む"}, {"me", "め"}, {"mo", "も"},
-    {"ya", "や"}, {"yu", "ゆ"}, {"yo", "よ"},
-    {"ra", "ら"}, {"ri", "り"}, {"ru", "る"}, {"re", "れ"}, {"ro", "ろ"},
-    {"wa", "わ"}, {"wo", "を"}, {"n", "ん"},
-    
-    // Vowels
-    {"a", "あ"}, {"i", "い"}, {"u", "う"}, {"e", "え"}, {"o", "お"},
-    
-    // Small tsu for doubled consonants
-    {"kk", "っk"}, {"ss", "っs"}, {"tt", "っt"}, {"pp", "っp"},
-    {"gg", "っg"}, {"zz", "っz"}, {"dd", "っd"}, {"bb", "っb"},
-    
-    {NULL, NULL}
-};
-
-
-// void romaji_to_hiragana(const char *romaji, char *hiragana, size_t size) {
-//     if (!romaji || size == 0) return;
-
-//     hiragana[0] = '\0';
-//     char temp[INPUT_BUFFER_SIZE];
-//     strcpy(temp, romaji);
-    
-//     char result[INPUT_BUFFER_SIZE] = "";
-//     char pending[MAX_ROMAJI_LENGTH] = "";
-//     int pending_len = 0;
-    
-//     for (size_t i = 0; i < strlen(temp); i++) {
-//         // Add character to pending
-//         pending[pending_len++] = temp[i];
-//         pending[pending_len] = '\0';
-        
-//         int found = 0;
-//         int partial_match = 0;
-        
-//         // Check if pending matches any romaji
-//         for (int j = 0; romaji_table[j].romaji != NULL; j++) {
-//             if (strcmp(pending, romaji_table[j].romaji) == 0) {
-//                 // Exact match found
-//                 strcat(result, romaji_table[j].hiragana);
-//                 pending[0] = '\0';
-//                 pending_len = 0;
-//                 found = 1;
-//                 break;
-//             } else if (strncmp(pending, romaji_table[j].romaji, pending_len) == 0) {
-//                 // Partial match - keep building
-//                 partial_match = 1;
-//             }
-//         }
-        
-//         // If no match and no partial match, output first char and retry rest
-//         if (!found && !partial_match && pending_len > 0) {
-//             // Output first character as-is
-//             char single[2] = {pending[0], '\0'};
-//             strcat(result, single);
-            
-//             // Shift pending buffer
-//             for (int k = 0; k < pending_len - 1; k++) {
-//                 pending[k] = pending[k + 1];
-//             }
-//             pending_len--;
-//             pending[pending_len] = '\0';
-            
-//             // Retry remaining
-//             i--;
-//         }
-//     }
-    
-//     // Append any remaining pending characters
-//     strcat(result, pending);
-    
-//     strncpy(hiragana, result, size - 1);
-//     hiragana[size - 1] = '\0';
-// }
+#include "../collectionlib/include/trace.h"
 
+// Generated from src/romaji_table.h by tools/romaji_gen
+#include "romaji_dfa.h"
 
+void romaji_converter_init(RomajiConverter *converter, KanaMode mode) {
+    converter->mode = mode;
+    romaji_converter_reset(converter);
+}
 
-void romaji_to_hiragana(const char *romaji, char *hiragana, size_t size) {
-    hiragana[0] = '\0';
-    if (!romaji || size == 0) return;
-    
-    char result[INPUT_BUFFER_SIZE] = "";
-    char pending[MAX_ROMAJI_LENGTH] = "";
-    int pending_len = 0;
-    
-    int i = 0;
-    while (i < strlen(romaji)) {
-        // Add character to pending
-        if (pending_len < MAX_ROMAJI_LENGTH - 1) {
-            pending[pending_len++] = romaji[i];
-            pending[pending_len] = '\0';
-        } else {
-            // Pending buffer full - output first char and continue
-            char single[2] = {pending[0], '\0'};
-            strcat(result, single);
-            
-            // Shift pending buffer
-            for (int k = 0; k < pending_len - 1; k++) {
-                pending[k] = pending[k + 1];
+void romaji_converter_reset(RomajiConverter *converter) {
+    converter->text[0] = '\0';
+    converter->length = 0;
+    converter->pending = 0;
+    converter->state = 0;
+    converter->romaji[0] = '\0';
+    converter->romaji_length = 0;
+}
+
+int romaji_is_key(char ch) {
+    return romaji_column[(unsigned char)ch] != 0;
+}
+
+static void feed(RomajiConverter *converter, char ch) {
+    for (;;) {
+        int next = romaji_next[converter->state][romaji_column[(unsigned char)ch]];
+
+        if (next && romaji_kana_len[next]) {
+            // Exact match: the pending romaji becomes kana, except for the
+            // last letters of a split entry, which start the next one
+            char rest[MAX_ROMAJI_LENGTH];
+            int count = romaji_rest[next];
+            int len = romaji_kana_len[next];
+
+            if (count) {
+                memcpy(rest, converter->text + converter->length - (count - 1), count - 1);
+                rest[count - 1] = ch;
             }
-            pending_len--;
-            pending[pending_len] = '\0';
-            continue;
+            converter->length -= converter->pending;
+            memcpy(converter->text + converter->length, romaji_kana[converter->mode][next], len);
+            converter->length += len;
+            converter->pending = 0;
+            converter->state = 0;
+            for (int i = 0; i < count; i++) feed(converter, rest[i]);
+            return;
         }
-        
-        int found = 0;
-        int partial_match = 0;
-        
-        // Check if pending matches any romaji
-        for (int j = 0; romaji_table[j].romaji != NULL; j++) {
-            if (strcmp(pending, romaji_table[j].romaji) == 0) {
-                // Exact match found
-                strcat(result, romaji_table[j].hiragana);
-                pending[0] = '\0';
-                pending_len = 0;
-                found = 1;
-                break;
-            } else if (strncmp(pending, romaji_table[j].romaji, pending_len) == 0 &&
-                       strlen(romaji_table[j].romaji) > pending_len) {
-                // Partial match - keep building
-                partial_match = 1;
+
+        if (next || converter->pending == 0) {
+            // Still a prefix of some entry, or a letter no entry starts with
+            converter->text[converter->length++] = ch;
+            if (next) {
+                converter->pending++;
+                converter->state = next;
             }
+            return;
         }
-        
-        // If we found a match or have potential for a match, continue
-        if (found || partial_match) {
-            i++;
-            continue;
-        }
-        
-        // No match and no partial match
-        if (pending_len > 0) {
-            // Check if we should try without the last character
-            if (pending_len > 1) {
-                // Remove last character and try again
-                pending_len--;
-                pending[pending_len] = '\0';
-                continue;  // Don't increment i, retry with shorter pending
-            } else {
-                // Single character with no match - output as-is
-                strcat(result, pending);
-                pending[0] = '\0';
-                pending_len = 0;
-                i++;
-            }
+
+        // Dead end: keep the first pending letter as typed, or as the kana
+        // it ends on ("nyz" is んyz), and feed the rest again
+        char rest[MAX_ROMAJI_LENGTH];
+        int count = converter->pending - 1;
+        char *first = converter->text + converter->length - converter->pending;
+        const char *final =
+            romaji_final_kana[converter->mode][romaji_next[0][romaji_column[(unsigned char)*first]]];
+
+        memcpy(rest, first + 1, count);
+        converter->length -= count;
+        if (final) {
+            size_t len = strlen(final);
+            memcpy(first, final, len);
+            converter->length += (int)len - 1;
         }
+        converter->pending = 0;
+        converter->state = 0;
+        for (int i = 0; i < count; i++) feed(converter, rest[i]);
+    }
+}
+
+int romaji_converter_push(RomajiConverter *converter, char ch) {
+    if (!romaji_is_key(ch) || converter->romaji_length >= INPUT_BUFFER_SIZE - 1) return -1;
+
+    int n = converter->romaji_length;
+    converter->history[n].length = converter->length;
+    converter->history[n].pending = converter->pending;
+    converter->history[n].state = converter->state;
+    converter->romaji[n] = ch;
+    converter->romaji[n + 1] = '\0';
+    converter->romaji_length = n + 1;
+
+    // Most keystrokes extend the pending romaji or complete a plain entry;
+    // feed handles the rest
+    int next = romaji_next[converter->state][romaji_column[(unsigned char)ch]];
+    int len = romaji_kana_len[next];
+    if (next && !len) {
+        converter->text[converter->length++] = ch;
+        converter->pending++;
+        converter->state = next;
+    } else if (next && !romaji_rest[next]) {
+        converter->length -= converter->pending;
+        memcpy(converter->text + converter->length, romaji_kana[converter->mode][next], len);
+        converter->length += len;
+        converter->pending = 0;
+        converter->state = 0;
+    } else {
+        feed(converter, ch);
     }
-    
-    // Append any remaining pending characters
-    strcat(result, pending);
-    
-    // Copy result to output buffer
-    strncpy(hiragana, result, size - 1);
-    hiragana[size - 1] = '\0';
-}
\ No newline at end of file
+    converter->text[converter->length] = '\0';
+    return 0;
+}
+
+int romaji_converter_backspace(RomajiConverter *converter) {
+    if (converter->romaji_length == 0) return -1;
+
+    int n = --converter->romaji_length;
+    converter->length = converter->history[n].length;
+    converter->pending = converter->history[n].pending;
+    converter->state = converter->history[n].state;
+
+    // The pending tail is always the last letters typed; restore it verbatim
+    memcpy(converter->text + converter->length - converter->pending,
+           converter->romaji + n - converter->pending, converter->pending);
+    converter->text[converter->length] = '\0';
+    converter->romaji[n] = '\0';
+    return 0;
+}
+
+void romaji_converter_set_mode(RomajiConverter *converter, KanaMode mode) {
+    char romaji[INPUT_BUFFER_SIZE];
+    int count = converter->romaji_length;
+
+    if (converter->mode == mode) return;
+    memcpy(romaji, converter->romaji, count);
+    converter->mode = mode;
+    romaji_converter_reset(converter);
+    for (int i = 0; i < count; i++) romaji_converter_push(converter, romaji[i]);
+}
+
+int romaji_converter_finish(const RomajiConverter *converter, char *out, size_t size) {
+    const char *final = romaji_final_kana[converter->mode][converter->state];
+    int kept = final ? converter->length - converter->pending : converter->length;
+    int len = kept + (final ? (int)strlen(final) : 0);
+
+    if ((size_t)len >= size) return -1;
+    memcpy(out, converter->text, kept);
+    if (final) memcpy(out + kept, final, len - kept);
+    out[len] = '\0';
+    return len;
+}
+
+void romaji_to_kana(const char *romaji, KanaMode mode, char *out, size_t size) {
+    TRACE_SCOPE("romaji_to_kana");
+    RomajiConverter converter;
+
+    if (size == 0) return;
+    out[0] = '\0';
+    if (!romaji) return;
+
+    romaji_converter_init(&converter, mode);
+    for (const char *p = romaji; *p; p++) {
+        if (romaji_converter_push(&converter, *p) < 0) break;
+    }
+
+    // Cut short rather than fail, like the conversion itself
+    char finished[ROMAJI_TEXT_SIZE + MAX_ROMAJI_LENGTH];
+    int len = romaji_converter_finish(&converter, finished, sizeof(finished));
+    if ((size_t)len > size - 1) len = (int)size - 1;
+    memcpy(out, finished, len);
+    out[len] = '\0';
+}
+
+void romaji_to_hiragana(const char *romaji, char *hiragana, size_t size) {
+    romaji_to_kana(romaji, KANA_HIRAGANA, hiragana, size);
+}
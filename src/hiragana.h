@@ -7,6 +7,58 @@
 #define INPUT_BUFFER_SIZE 256
 #define MAX_ROMAJI_LENGTH 10
 
+// Every table entry expands to at most 3 bytes of kana per romaji letter
+#define ROMAJI_TEXT_SIZE (INPUT_BUFFER_SIZE * 3)
+
+typedef enum {
+    KANA_HIRAGANA,
+    KANA_KATAKANA
+} KanaMode;
+
+// Converts romaji one keystroke at a time. text holds the converted kana
+// followed by the romaji still waiting for a match; both push and backspace
+// are O(1) because only that pending tail is ever rewritten. Nothing is
+// emitted before it is certain: "n" waits for the next letter, and a doubled
+// consonant gives っ with the second one still pending.
+typedef struct {
+    char text[ROMAJI_TEXT_SIZE];
+    int length;
+    int pending;                    // unconverted romaji bytes at the end of text
+    int state;                      // DFA state reached by those bytes
+    KanaMode mode;                  // script the kana are written in
+    char romaji[INPUT_BUFFER_SIZE]; // keystrokes as typed
+    int romaji_length;
+    struct {
+        short length;
+        unsigned char pending;
+        unsigned short state;
+    } history[INPUT_BUFFER_SIZE];   // converter state before each keystroke
+} RomajiConverter;
+
+void romaji_converter_init(RomajiConverter *converter, KanaMode mode);
+
+// Clear the input, keeping the mode
+void romaji_converter_reset(RomajiConverter *converter);
+
+// Switch scripts; what was typed so far is converted again
+void romaji_converter_set_mode(RomajiConverter *converter, KanaMode mode);
+
+// Returns -1 when the input is full or ch is not a romaji key
+int romaji_converter_push(RomajiConverter *converter, char ch);
+
+// Undo the last keystroke; returns -1 when there is nothing to undo
+int romaji_converter_backspace(RomajiConverter *converter);
+
+// The text as it stands if the input ended here, e.g. with a trailing "n"
+// as ん. Returns its length, or -1 if it does not fit in size.
+int romaji_converter_finish(const RomajiConverter *converter, char *out, size_t size);
+
+// Letters and marks the converter takes: a-z, '-' and '\''
+int romaji_is_key(char ch);
+
+// Whole-string conversion, same result as pushing every character and
+// finishing
+void romaji_to_kana(const char *romaji, KanaMode mode, char *out, size_t size);
 void romaji_to_hiragana(const char *romaji, char *hiragana, size_t size);
 
 #endif
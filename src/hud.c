@@ -0,0 +1,69 @@
+#include "hud.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../collectionlib/include/trace.h"
+
+static void text_init(HudText *text, GlyphAtlas *atlas) {
+    memset(text, 0, sizeof(HudText));
+    text->atlas = atlas;
+}
+
+void hud_init(Hud *hud, GlyphAtlas *small, GlyphAtlas *medium, GlyphAtlas *large) {
+    memset(hud, 0, sizeof(Hud));
+    text_init(&hud->score, small);
+    text_init(&hud->kana, medium);
+    text_init(&hud->romaji, small);
+    text_init(&hud->game_over, large);
+    text_init(&hud->loading, medium);
+}
+
+void hud_begin_frame(Hud *hud) {
+    if (hud->frames > 0) {
+        hud->last_frame_laid_out = hud->frame_laid_out;
+        if (hud->frame_laid_out == 0) hud->idle_frames++;
+    }
+    hud->frame_laid_out = 0;
+    hud->frames++;
+}
+
+void hud_text_set(HudText *text, const char *value, size_t length) {
+    if (length >= HUD_TEXT_SIZE) length = HUD_TEXT_SIZE - 1;
+    text->format = NULL;
+    if (length == text->length && memcmp(text->value, value, length) == 0) return;
+
+    memcpy(text->value, value, length);
+    text->value[length] = '\0';
+    text->length = length;
+    text->dirty = 1;
+}
+
+void hud_text_set_number(HudText *text, const char *format, long number) {
+    char value[64];
+
+    if (text->format == format && text->number == number) return;
+
+    int length = snprintf(value, sizeof(value), format, number);
+    if (length < 0) return;
+    hud_text_set(text, value, (size_t)length < sizeof(value) ? (size_t)length : sizeof(value) - 1);
+    text->format = format;
+    text->number = number;
+}
+
+static void layout(Hud *hud, HudText *text) {
+    TRACE_SCOPE("hud_layout");
+
+    text->quad_count = glyph_atlas_layout(text->atlas, text->value, text->quads,
+                                          HUD_TEXT_SIZE, &text->w);
+    text->dirty = 0;
+
+    hud->laid_out++;
+    hud->frame_laid_out++;
+}
+
+void hud_text_draw(Hud *hud, HudText *text, int x, int y, SDL_Color color) {
+    if (text->dirty) layout(hud, text);
+    glyph_atlas_draw_quads(text->atlas, text->quads, text->quad_count, x - text->w / 2, y,
+                           color);
+}
@@ -0,0 +1,58 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <SDL2/SDL.h>
+
+#include "glyph_atlas.h"
+#include "hiragana.h"
+
+#define HUD_TEXT_SIZE ROMAJI_TEXT_SIZE
+
+// One line of HUD text and its glyph atlas layout. Setting the same value
+// again is a compare; a new value marks the element dirty, and only then
+// does the next draw lay it out again. Drawing replays the cached quads
+// with the colour of the call, so a colour change costs nothing either.
+typedef struct {
+    GlyphAtlas *atlas;
+    char value[HUD_TEXT_SIZE];
+    size_t length;
+    const char *format;     // of the last hud_text_set_number, NULL otherwise
+    long number;
+    GlyphQuad quads[HUD_TEXT_SIZE];     // at most one per byte of value
+    int quad_count;
+    int w;
+    int dirty;
+} HudText;
+
+// The text drawn over the playfield. Each frame starts with hud_begin_frame,
+// which closes the counts of the one before: an idle frame, with nothing
+// typed and the score unchanged, lays out nothing.
+typedef struct {
+    HudText score;
+    HudText kana;           // converted input, with the pending romaji
+    HudText romaji;         // keystrokes as typed
+    HudText game_over;
+    HudText loading;
+
+    unsigned long laid_out;             // every element, since hud_init
+    unsigned long frame_laid_out;       // in the frame being drawn
+    unsigned long last_frame_laid_out;
+    unsigned long frames;
+    unsigned long idle_frames;          // frames that laid out nothing
+} Hud;
+
+// The atlases are borrowed; quads are queued on them and drawn on their flush
+void hud_init(Hud *hud, GlyphAtlas *small, GlyphAtlas *medium, GlyphAtlas *large);
+
+void hud_begin_frame(Hud *hud);
+
+void hud_text_set(HudText *text, const char *value, size_t length);
+
+// format takes one long, e.g. "Score: %ld"; an unchanged number and format
+// skip the formatting as well as the layout
+void hud_text_set_number(HudText *text, const char *format, long number);
+
+// Queue centred horizontally on x, laying out first if the value changed
+void hud_text_draw(Hud *hud, HudText *text, int x, int y, SDL_Color color);
+
+#endif
@@ -5,25 +5,39 @@
 #include <string.h>
 #include <time.h>
 #include <sqlite3.h>
+#include <limits.h>
 #include <locale.h>
+#include <sys/stat.h>
 
+#include "../collectionlib/include/async_load.h"
 #include "../collectionlib/include/collection.h"
+#include "../collectionlib/include/refresh.h"
+#include "../collectionlib/include/review_writer.h"
+#include "../collectionlib/include/trace.h"
 #include "hiragana.h"
+#include "glyph_atlas.h"
+#include "card_textures.h"
+#include "sim.h"
+#include "replay.h"
+#include "overlay.h"
+#include "hud.h"
 
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 600
-#define MAX_ENEMIES 10
+#ifndef MAX_ENEMIES
+#define MAX_ENEMIES 10      // raise with -DMAX_ENEMIES=... for swarm play
+#endif
 #define ENEMY_SPEED 30.0f
 #define SPAWN_DELAY 6000
 #define SHOW_MEANING_DURATION 2000
-
-typedef struct {
-    float x, y;
-    int card_index;
-    int alive;
-    int showing_meaning;
-    Uint32 death_time;
-} Enemy;
+#define CARD_TEXTURE_BUDGET (16 * 1024 * 1024)
+#define PRELOAD_CARD_TEXTURES 0
+#define DECK_CACHE_DIR "cache"
+#define AUTO_FIRE 0         // submit as soon as the input spells a whole reading
+#define MAX_CATCHUP_TICKS 8 // after a stall, drop time rather than spiral
+#define MAX_REPLAY_SPEED 1000.0
+#define START_CARDS 64      // published cards needed before spawning begins
+#define REFRESH_INTERVAL 2000 // ms between looks for cards edited in Anki
 
 typedef struct {
     SDL_Window *window;
@@ -31,154 +45,200 @@ typedef struct {
     TTF_Font *font_large;
     TTF_Font *font_medium;
     TTF_Font *font_small;
+    GlyphAtlas *atlas_large;
+    GlyphAtlas *atlas_medium;
+    GlyphAtlas *atlas_small;
+    Hud hud;
     
-    Enemy enemies[MAX_ENEMIES];
-    char input_buffer[INPUT_BUFFER_SIZE];
-    char romaji_buffer[INPUT_BUFFER_SIZE];
-    char display_buffer[INPUT_BUFFER_SIZE];
-    int input_length;
+    CollectionLoad *load;       // NULL once the collection is complete
+    CardCollection *collection; // only published cards while loading
+    GameSim *sim;               // NULL until enough cards are in
+    CardTextureCache *card_textures;
+    ReviewWriter *reviews;      // NULL with --no-writeback and in replays
     
-    int game_over;
-    int score;
-    Uint32 last_spawn_time;
+    ReplayWriter recorder;      // file is NULL unless --record
+    Replay *replay;             // keyboard is ignored while replaying
     
-    CardCollection *collection;
+    FrameOverlay overlay;       // PROFILE=1 builds only
 } GameState;
 
+// Render the card text on first spawn so drawing is a plain blit
+static void warm_card_textures(void *user_data, int card_index) {
+    GameState *game = user_data;
+    card_texture_cache_get(game->card_textures, card_index, CARD_TEXT_WORD);
+    card_texture_cache_get(game->card_textures, card_index, CARD_TEXT_MEANING);
+}
 
-void init_enemy(Enemy *enemy, int card_index, float x) {
-    enemy->x = x;
-    enemy->y = -50;
-    enemy->card_index = card_index;
-    enemy->alive = 1;
-    enemy->showing_meaning = 0;
-    enemy->death_time = 0;
+// Hand each answer to the background writer; this never waits on SQLite
+static void record_result(void *user_data, int card_index, int hit, uint32_t answer_ms) {
+    GameState *game = user_data;
+    struct timespec now;
+    ReviewResult result;
+    
+    if (!game->reviews) return;
+    
+    clock_gettime(CLOCK_REALTIME, &now);
+    result.card_id = game->collection->cards[card_index].card_id;
+    result.time_ms = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    result.answer_ms = (int)answer_ms;
+    result.outcome = hit ? REVIEW_HIT : REVIEW_MISS;
+    review_writer_submit(game->reviews, &result);
 }
 
-void spawn_enemy(GameState *game) {
-    if (game->collection->count == 0) return;
-    
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!game->enemies[i].alive && !game->enemies[i].showing_meaning) {
-            int card_index = rand() % game->collection->count;
-            float x = 50 + (rand() % (WINDOW_WIDTH - 100));
-            init_enemy(&game->enemies[i], card_index, x);
-            break;
-        }
+// Every key goes through here so a recording sees exactly what the sim saw
+static void apply_key(GameState *game, char key) {
+    uint64_t tick = game->sim->tick;
+    
+    sim_key(game->sim, key);
+    if (game->recorder.file && replay_write_key(&game->recorder, tick, key) < 0) {
+        printf("Recording failed, stopping\n");
+        replay_writer_close(&game->recorder, tick, game->sim->score);
     }
 }
 
-void render_text(SDL_Renderer *renderer, TTF_Font *font, const char *text, 
-                 int x, int y, SDL_Color color) {
-    if (!text || strlen(text) == 0) return;
-    
-    SDL_Surface *surface = TTF_RenderUTF8_Blended(font, text, color);
-    if (!surface) return;
-    
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        SDL_FreeSurface(surface);
-        return;
+// Take in what the loader published since the last frame; -1 if it failed
+static int poll_collection(GameState *game) {
+    if (game->load && collection_load_state(game->load) != ASYNC_LOAD_RUNNING) {
+        game->collection = collection_load_finish(game->load);
+        game->load = NULL;
+        if (!game->collection) return -1;
     }
     
-    SDL_Rect dest = {x - surface->w / 2, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, NULL, &dest);
-    
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+    if (card_texture_cache_grow(game->card_textures, collection_published(game->collection)) < 0) {
+        return -1;
+    }
+    if (game->sim) sim_sync_collection(game->sim);
+    return 0;
 }
 
-void update_enemies(GameState *game, float delta_time) {
-    Uint32 current_time = SDL_GetTicks();
-    
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        Enemy *enemy = &game->enemies[i];
-        
-        if (enemy->showing_meaning) {
-            if (current_time - enemy->death_time > SHOW_MEANING_DURATION) {
-                enemy->showing_meaning = 0;
-            }
-        } else if (enemy->alive) {
-            enemy->y += ENEMY_SPEED * delta_time;
-            
-            if (enemy->y > WINDOW_HEIGHT - 50) {
-                game->game_over = 1;
-            }
+// Pick up notes edited in Anki since the last look. A busy collection is
+// simply tried again next time.
+static int refresh_collection(GameState *game) {
+    CollectionChanges changes;
+    
+    if (collection_refresh(game->collection, &changes) > 0) {
+        if (card_texture_cache_grow(game->card_textures, game->collection->count) < 0) {
+            collection_changes_free(&changes);
+            return -1;
+        }
+        for (int i = 0; i < changes.edited.count; i++) {
+            card_texture_cache_invalidate(game->card_textures, changes.edited.items[i]);
         }
+        sim_apply_changes(game->sim, &changes);
     }
+    collection_changes_free(&changes);
+    return 0;
 }
 
-void check_input(GameState *game) {
-    if (strlen(game->input_buffer) == 0) return;
+// A recording or replay only starts on the complete collection; see
+// sim_sync_collection
+static int start_game(GameState *game, const SimConfig *config, Replay *replay,
+                      const char *record_path, const char *db_path, const char *deck_name) {
+    CardCollection *collection = game->collection;
+    
+    if (replay && collection->count != replay->card_count) {
+        printf("Replay was recorded with %d cards, deck has %d\n",
+               replay->card_count, collection->count);
+        return -1;
+    }
     
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        Enemy *enemy = &game->enemies[i];
-        if (!enemy->alive || enemy->showing_meaning) continue;
-        
-        CardData *card = &game->collection->cards[enemy->card_index];
-        
-        if (strcmp(game->input_buffer, card->word_reading) == 0) {
-            enemy->alive = 0;
-            enemy->showing_meaning = 1;
-            enemy->death_time = SDL_GetTicks();
-            game->score += 100;
-            
-            // Clear input buffers
-            game->input_buffer[0] = '\0';
-            game->romaji_buffer[0] = '\0';
-            game->display_buffer[0] = '\0';
-            game->input_length = 0;
-            break;
-        }
+    game->sim = sim_create(config, collection);
+    if (!game->sim) {
+        printf("Failed to create the game\n");
+        return -1;
+    }
+    game->sim->on_spawn = warm_card_textures;
+    game->sim->on_result = record_result;
+    game->sim->user_data = game;
+    
+    if (record_path && replay_writer_open(&game->recorder, record_path, config,
+                                          collection->count, db_path, deck_name) < 0) {
+        printf("Not recording this session\n");
     }
+    game->replay = replay;
+    
+    if (PRELOAD_CARD_TEXTURES) {
+        card_texture_cache_preload(game->card_textures);
+    }
+    return 0;
 }
 
-void render_game(GameState *game) {
+void render_loading(GameState *game) {
+    SDL_Color white = {255, 255, 255, 255};
+    Hud *hud = &game->hud;
+    
+    hud_begin_frame(hud);
     SDL_SetRenderDrawColor(game->renderer, 0, 0, 0, 255);
     SDL_RenderClear(game->renderer);
     
-    // Render enemies
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        Enemy *enemy = &game->enemies[i];
-        if (!enemy->alive && !enemy->showing_meaning) continue;
-        
-        CardData *card = &game->collection->cards[enemy->card_index];
-        
-        if (enemy->showing_meaning) {
-            // Show meaning in green
-            SDL_Color green = {0, 255, 0, 255};
-            render_text(game->renderer, game->font_medium, 
-                       card->word_meaning, (int)enemy->x, (int)enemy->y, green);
-        } else {
-            // Show kanji in white
-            SDL_Color white = {255, 255, 255, 255};
-            render_text(game->renderer, game->font_large, 
-                       card->word, (int)enemy->x, (int)enemy->y, white);
-        }
-    }
+    hud_text_set_number(&hud->loading, "Loading... %ld cards",
+                        collection_published(game->collection));
+    hud_text_draw(hud, &hud->loading, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, white);
     
-    // Render converted hiragana
-    SDL_Color yellow = {255, 255, 0, 255};
-    render_text(game->renderer, game->font_medium, game->display_buffer, 
-               WINDOW_WIDTH / 2, WINDOW_HEIGHT - 120, yellow);
+    glyph_atlas_flush(game->atlas_medium);
+    SDL_RenderPresent(game->renderer);
+}
+
+// alpha is how far the wall clock is between the last tick and the next
+void render_game(GameState *game, float alpha) {
+    TRACE_SCOPE("render_game");
     
-    // Render romaji input
-    SDL_Color cyan = {0, 255, 255, 255};
-    render_text(game->renderer, game->font_small, game->romaji_buffer, 
-               WINDOW_WIDTH / 2, WINDOW_HEIGHT - 80, cyan);
+    hud_begin_frame(&game->hud);
+    SDL_SetRenderDrawColor(game->renderer, 0, 0, 0, 255);
+    SDL_RenderClear(game->renderer);
     
-    // Render score
-    char score_text[64];
-    snprintf(score_text, sizeof(score_text), "Score: %d", game->score);
+    GameSim *sim = game->sim;
+    EnemyPool *enemies = sim->enemies;
+    
+    // Show meanings of killed enemies in green
+    SDL_Color green = {0, 255, 0, 255};
+    for (int i = 0; i < enemies->fading_count; i++) {
+        FadingEnemy *fading = &enemies->fading[i];
+        card_texture_cache_draw(game->card_textures, fading->card_index, CARD_TEXT_MEANING,
+                                (int)fading->x, (int)fading->y, green);
+    }
+    
+    // Show kanji in white, or orange while the input is a prefix of its reading
     SDL_Color white = {255, 255, 255, 255};
-    render_text(game->renderer, game->font_small, score_text, 100, 30, white);
+    SDL_Color orange = {255, 165, 0, 255};
+    for (int i = 0; i < enemies->count; i++) {
+        int matched = sim_enemy_matches(sim, enemies->id[i]);
+        float y = enemies->prev_y[i] + (enemies->y[i] - enemies->prev_y[i]) * alpha;
+        card_texture_cache_draw(game->card_textures, enemies->card_index[i], CARD_TEXT_WORD,
+                                (int)enemies->x[i], (int)y, matched ? orange : white);
+    }
     
-    // Render game over
-    if (game->game_over) {
+    // HUD text is laid out again only when it changed since the last frame
+    Hud *hud = &game->hud;
+    SDL_Color yellow = {255, 255, 0, 255};
+    SDL_Color cyan = {0, 255, 255, 255};
+    hud_text_set(&hud->kana, sim->input.text, sim->input.length);
+    hud_text_draw(hud, &hud->kana, WINDOW_WIDTH / 2, WINDOW_HEIGHT - 120, yellow);
+    hud_text_set(&hud->romaji, sim->input.romaji, sim->input.romaji_length);
+    hud_text_draw(hud, &hud->romaji, WINDOW_WIDTH / 2, WINDOW_HEIGHT - 80, cyan);
+    hud_text_set_number(&hud->score, "Score: %ld", sim->score);
+    hud_text_draw(hud, &hud->score, 100, 30, white);
+    
+    if (sim->game_over) {
         SDL_Color red = {255, 0, 0, 255};
-        render_text(game->renderer, game->font_large, "GAME OVER", 
-                   WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, red);
+        hud_text_set(&hud->game_over, "GAME OVER", strlen("GAME OVER"));
+        hud_text_draw(hud, &hud->game_over, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, red);
+    }
+    
+#if TRACE_ENABLED
+    if (game->overlay.visible) {
+        CardTextureCache *textures = game->card_textures;
+        int atlas_pages = game->atlas_large->page_count + game->atlas_medium->page_count +
+                          game->atlas_small->page_count;
+        frame_overlay_draw(&game->overlay, game->renderer, game->atlas_small,
+                           textures->textures_created + atlas_pages, textures->textures_destroyed,
+                           hud->last_frame_laid_out);
     }
+#endif
+    
+    glyph_atlas_flush(game->atlas_large);
+    glyph_atlas_flush(game->atlas_medium);
+    glyph_atlas_flush(game->atlas_small);
     
     SDL_RenderPresent(game->renderer);
 }
@@ -186,33 +246,111 @@ void render_game(GameState *game) {
 int main(int argc, char *argv[]) {
     // Set locale for UTF-8 support
     setlocale(LC_ALL, "");
-    const char *db_path;
-    const char *search_term;
-    CardCollection *collection;
+    const char *db_path = NULL;
+    const char *search_term = NULL;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    const char *trace_path = NULL;
+    int writeback = 1;
+    int status = 0;
+    double replay_speed = 1.0;
+    CollectionLoad *load;
+    Replay replay;
+    int tick_rate = SIM_DEFAULT_TICK_RATE;
+    int scheduler = SCHEDULER_UNIFORM;
     
     // Parse command line arguments
-    if (argc < 3) {
-        printf("Usage: %s <path_to_collection.anki2> <deck_name>\n", argv[0]);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tick_rate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scheduler") == 0 && i + 1 < argc) {
+            scheduler = scheduler_strategy_find(argv[++i]);
+            if (scheduler < 0) {
+                printf("Unknown scheduler: %s (uniform, due, weakest)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc) {
+            replay_speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-writeback") == 0) {
+            writeback = 0;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        } else if (!db_path) {
+            db_path = argv[i];
+        } else if (!search_term) {
+            search_term = argv[i];
+        } else {
+            printf("Unexpected argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (tick_rate <= 0) tick_rate = SIM_DEFAULT_TICK_RATE;
+    if (tick_rate > REPLAY_MAX_TICK_RATE) tick_rate = REPLAY_MAX_TICK_RATE;
+    if (trace_path && !TRACE_ENABLED) {
+        printf("--trace needs a PROFILE=1 build\n");
         return 1;
     }
+    if (replay_speed <= 0.0) replay_speed = 1.0;
+    if (replay_speed > MAX_REPLAY_SPEED) replay_speed = MAX_REPLAY_SPEED;
+    
+    // A replay names its own collection and deck unless they are overridden
+    if (replay_path) {
+        if (record_path) {
+            printf("--record and --replay are exclusive\n");
+            return 1;
+        }
+        if (replay_load(replay_path, &replay) < 0) return 1;
+        if (!db_path) db_path = replay.db_path;
+        if (!search_term) search_term = replay.deck_name;
+    }
     
-    db_path = argv[1];
-    search_term = argv[2];
+    if (!db_path || !search_term) {
+        printf("Usage: %s <path_to_collection.anki2> <deck_name> [--tick-rate N]\n"
+               "           [--scheduler uniform|due|weakest] [--record FILE] [--trace FILE]\n"
+               "           [--no-writeback]\n"
+               "       %s [<path_to_collection.anki2> <deck_name>] --replay FILE [--replay-speed X]\n",
+               argv[0], argv[0]);
+        return 1;
+    }
     
-    collection = setup_collection(db_path, search_term);
+    // Precompiled deck caches skip SQLite parsing on later launches
+    CollectionOptions options;
+    collection_default_options(&options);
+    mkdir(DECK_CACHE_DIR, 0755);
+    options.cache_dir = DECK_CACHE_DIR;
+    options.include_subdecks = 1;
+    options.load_schedule = 1;
+    
+    // The deck loads on its own thread while the window and fonts come up
+    load = collection_load_start(db_path, search_term, &options);
+    if (!load) {
+        if (replay_path) replay_free(&replay);
+        return 1;
+    }
     
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         printf("SDL initialization failed: %s\n", SDL_GetError());
+        collection_load_cancel(load);
         return 1;
     }
     
     if (TTF_Init() < 0) {
         printf("TTF initialization failed: %s\n", TTF_GetError());
+        collection_load_cancel(load);
         SDL_Quit();
         return 1;
     }
     
     GameState game = {0};
+    game.load = load;
+    game.collection = load->collection;
     
     // Create window and renderer
     game.window = SDL_CreateWindow("Japanese Typing Game",
@@ -222,6 +360,7 @@ int main(int argc, char *argv[]) {
                                    SDL_WINDOW_SHOWN);
     if (!game.window) {
         printf("Window creation failed: %s\n", SDL_GetError());
+        collection_load_cancel(load);
         TTF_Quit();
         SDL_Quit();
         return 1;
@@ -232,6 +371,7 @@ int main(int argc, char *argv[]) {
                                       SDL_RENDERER_PRESENTVSYNC);
     if (!game.renderer) {
         printf("Renderer creation failed: %s\n", SDL_GetError());
+        collection_load_cancel(load);
         SDL_DestroyWindow(game.window);
         TTF_Quit();
         SDL_Quit();
@@ -245,6 +385,7 @@ int main(int argc, char *argv[]) {
     
     if (!game.font_large || !game.font_medium || !game.font_small) {
         printf("Font loading failed: %s\n", TTF_GetError());
+        collection_load_cancel(load);
         SDL_DestroyRenderer(game.renderer);
         SDL_DestroyWindow(game.window);
         TTF_Quit();
@@ -252,49 +393,132 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    game.atlas_large = glyph_atlas_create(game.renderer, game.font_large);
+    game.atlas_medium = glyph_atlas_create(game.renderer, game.font_medium);
+    game.atlas_small = glyph_atlas_create(game.renderer, game.font_small);
+    
+    if (!game.atlas_large || !game.atlas_medium || !game.atlas_small) {
+        printf("Glyph atlas creation failed\n");
+        collection_load_cancel(load);
+        glyph_atlas_destroy(game.atlas_large);
+        glyph_atlas_destroy(game.atlas_medium);
+        glyph_atlas_destroy(game.atlas_small);
+        TTF_CloseFont(game.font_large);
+        TTF_CloseFont(game.font_medium);
+        TTF_CloseFont(game.font_small);
+        SDL_DestroyRenderer(game.renderer);
+        SDL_DestroyWindow(game.window);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    
+    hud_init(&game.hud, game.atlas_small, game.atlas_medium, game.atlas_large);
+    
     // Initialize game state
-    srand(time(NULL));
-    game.input_buffer[0] = '\0';
-    game.romaji_buffer[0] = '\0';
-    game.display_buffer[0] = '\0';
-    game.input_length = 0;
-    game.game_over = 0;
-    game.score = 0;
-    game.last_spawn_time = 0;
-    game.collection = collection;
-    
-    // Initialize enemies
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        game.enemies[i].alive = 0;
-        game.enemies[i].showing_meaning = 0;
+    SimConfig config;
+    sim_default_config(&config);
+    config.tick_rate = tick_rate;
+    config.width = WINDOW_WIDTH;
+    config.height = WINDOW_HEIGHT;
+    config.max_enemies = MAX_ENEMIES;
+    config.enemy_speed = ENEMY_SPEED;
+    config.spawn_delay = SPAWN_DELAY;
+    config.meaning_duration = SHOW_MEANING_DURATION;
+    config.auto_fire = AUTO_FIRE;
+    config.scheduler = scheduler;
+    config.seed = (uint64_t)time(NULL);
+    if (replay_path) config = replay.config;
+    
+    game.card_textures = card_texture_cache_create(game.renderer, game.collection,
+                                                   game.font_large, game.font_medium,
+                                                   CARD_TEXTURE_BUDGET);
+    if (!game.card_textures) {
+        collection_load_cancel(load);
+        glyph_atlas_destroy(game.atlas_large);
+        glyph_atlas_destroy(game.atlas_medium);
+        glyph_atlas_destroy(game.atlas_small);
+        TTF_CloseFont(game.font_large);
+        TTF_CloseFont(game.font_medium);
+        TTF_CloseFont(game.font_small);
+        SDL_DestroyRenderer(game.renderer);
+        SDL_DestroyWindow(game.window);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    // Results go to the collection as the game runs; a replay's already did
+    if (writeback && !replay_path) {
+        game.reviews = review_writer_open(db_path);
+        if (!game.reviews) printf("Results will not be saved\n");
     }
     
-    // Game loop
+    // Spawning starts with the first published cards, or with all of them
+    // when the session is recorded or replayed
+    int start_cards = (record_path || replay_path) ? INT_MAX : START_CARDS;
+    
+    // Edits show up mid-game, except in sessions that must replay exactly
+    int refresh = !record_path && !replay_path;
+    Uint32 last_refresh = SDL_GetTicks();
+    
+    // Game loop: the simulation runs in fixed ticks, rendering runs at the
+    // display rate and interpolates between the last two ticks
     SDL_Event event;
     int running = 1;
-    Uint32 last_time = SDL_GetTicks();
+    Uint64 tick_length = SDL_GetPerformanceFrequency() / config.tick_rate;
+    int max_steps = MAX_CATCHUP_TICKS;
+    int replay_done = 0;
+    
+    // A faster replay runs more ticks per frame; drawing stays once a frame
+    if (replay_path) max_steps = (int)(MAX_CATCHUP_TICKS * replay_speed) + 1;
+    Uint64 last_counter = SDL_GetPerformanceCounter();
+    Uint64 accumulator = 0;
     
     while (running) {
-        Uint32 current_time = SDL_GetTicks();
-        float delta_time = (current_time - last_time) / 1000.0f;
-        last_time = current_time;
+        TRACE_SCOPE("frame");
+        Uint64 counter = SDL_GetPerformanceCounter();
+#if TRACE_ENABLED
+        frame_overlay_record(&game.overlay,
+                             (counter - last_counter) * 1000.0f / SDL_GetPerformanceFrequency());
+#endif
+        if (game.replay) accumulator += (Uint64)((counter - last_counter) * replay_speed);
+        else if (game.sim) accumulator += counter - last_counter;
+        last_counter = counter;
+        
+        if (game.load && poll_collection(&game) < 0) {
+            printf("Failed to load deck %s from %s\n", search_term, db_path);
+            status = 1;
+            break;
+        }
+        if (!game.sim && (!game.load || collection_published(game.collection) >= start_cards)) {
+            if (start_game(&game, &config, replay_path ? &replay : NULL, record_path,
+                           db_path, search_term) < 0) {
+                status = 1;
+                break;
+            }
+        }
+        if (refresh && game.sim && !game.load && SDL_GetTicks() - last_refresh >= REFRESH_INTERVAL) {
+            last_refresh = SDL_GetTicks();
+            if (refresh_collection(&game) < 0) {
+                printf("Failed to take in edited cards\n");
+                status = 1;
+                break;
+            }
+        }
         
         // Handle events
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 running = 0;
-            } else if (event.type == SDL_KEYDOWN && !game.game_over) {
-                if (event.key.keysym.sym == SDLK_BACKSPACE && strlen(game.romaji_buffer) > 0) {
-                    // Remove last character from romaji buffer
-                    game.romaji_buffer[strlen(game.romaji_buffer) - 1] = '\0';
-                    
-                    // Reconvert entire buffer
-                    romaji_to_hiragana(game.romaji_buffer, game.input_buffer, INPUT_BUFFER_SIZE);
-                    strcpy(game.display_buffer, game.input_buffer);
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) {
+                running = 0;
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) {
+                game.overlay.visible = TRACE_ENABLED && !game.overlay.visible;
+            } else if (event.type == SDL_KEYDOWN && game.sim && !game.sim->game_over && !game.replay) {
+                if (event.key.keysym.sym == SDLK_BACKSPACE) {
+                    apply_key(&game, SIM_KEY_BACKSPACE);
                 } else if (event.key.keysym.sym == SDLK_RETURN) {
-                    check_input(&game);
-                } else if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    running = 0;
+                    apply_key(&game, SIM_KEY_SUBMIT);
                 } else {
                     // Handle character input
                     char ch = 0;
@@ -303,38 +527,64 @@ int main(int argc, char *argv[]) {
                     // Convert keycode to character
                     if (key >= SDLK_a && key <= SDLK_z) {
                         ch = 'a' + (key - SDLK_a);
+                    } else if (key == SDLK_MINUS) {
+                        ch = '-';   // ー
+                    } else if (key == SDLK_QUOTE) {
+                        ch = '\'';  // n' for ん
                     }
                     
-                    if (ch && strlen(game.romaji_buffer) < INPUT_BUFFER_SIZE - 2) {
-                        // Add character to romaji buffer
-                        int len = strlen(game.romaji_buffer);
-                        game.romaji_buffer[len] = ch;
-                        game.romaji_buffer[len + 1] = '\0';
-                        
-                        // Convert to hiragana
-                        romaji_to_hiragana(game.romaji_buffer, game.input_buffer, INPUT_BUFFER_SIZE);
-                        strcpy(game.display_buffer, game.input_buffer);
+                    if (ch) {
+                        apply_key(&game, ch);
                     }
                 }
             }
         }
         
-        if (!game.game_over) {
-            // Spawn enemies
-            if (current_time - game.last_spawn_time > SPAWN_DELAY) {
-                spawn_enemy(&game);
-                game.last_spawn_time = current_time;
+        int steps = 0;
+        while (game.sim && accumulator >= tick_length && steps < max_steps && !replay_done) {
+            if (game.replay) {
+                replay_feed(game.replay, game.sim);
+                if (game.sim->tick >= game.replay->end_tick) {
+                    printf("Replay finished at tick %llu: score %d (recorded %d)\n",
+                           (unsigned long long)game.sim->tick, game.sim->score,
+                           game.replay->final_score);
+                    replay_done = 1;
+                    break;
+                }
             }
-            
-            // Update game state
-            update_enemies(&game, delta_time);
+            sim_step(game.sim);
+            accumulator -= tick_length;
+            steps++;
+        }
+        if (accumulator >= tick_length) {
+            accumulator %= tick_length;
         }
         
         // Render
-        render_game(&game);
+        if (game.sim) render_game(&game, (float)accumulator / tick_length);
+        else render_loading(&game);
     }
     
     // Cleanup
+    if (trace_path) trace_export_chrome(trace_path);
+    if (game.recorder.file) {
+        replay_writer_close(&game.recorder, game.sim->tick, game.sim->score);
+        printf("Recorded %llu ticks to %s\n", (unsigned long long)game.sim->tick, record_path);
+    }
+    if (replay_path) replay_free(&replay);
+    review_writer_close(game.reviews);
+    printf("Card textures: %lu hits, %lu misses, %lu evictions, %zu bytes resident\n",
+           game.card_textures->hits, game.card_textures->misses,
+           game.card_textures->evictions, game.card_textures->used_bytes);
+    printf("HUD: %lu layouts over %lu frames, %lu frames with none\n",
+           game.hud.laid_out, game.hud.frames, game.hud.idle_frames);
+    card_texture_cache_destroy(game.card_textures);
+    sim_destroy(game.sim);
+    if (game.load) collection_load_cancel(game.load);
+    else delete_collection(game.collection);
+    glyph_atlas_destroy(game.atlas_large);
+    glyph_atlas_destroy(game.atlas_medium);
+    glyph_atlas_destroy(game.atlas_small);
     TTF_CloseFont(game.font_large);
     TTF_CloseFont(game.font_medium);
     TTF_CloseFont(game.font_small);
@@ -343,5 +593,5 @@ int main(int argc, char *argv[]) {
     TTF_Quit();
     SDL_Quit();
     
-    return 0;
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "overlay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PANEL_WIDTH 260
+#define PANEL_MARGIN 10
+#define HISTOGRAM_HEIGHT 60
+#define BUDGET_60HZ_MS 16.7f
+#define BUDGET_30HZ_MS 33.3f
+
+void frame_overlay_record(FrameOverlay *overlay, float frame_ms) {
+    overlay->frame_ms[overlay->next] = frame_ms;
+    overlay->next = (overlay->next + 1) % OVERLAY_FRAMES;
+    if (overlay->count < OVERLAY_FRAMES) overlay->count++;
+}
+
+static int compare_float(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+void frame_overlay_draw(const FrameOverlay *overlay, SDL_Renderer *renderer, GlyphAtlas *atlas,
+                        unsigned long textures_created, unsigned long textures_destroyed,
+                        unsigned long hud_laid_out) {
+    float sorted[OVERLAY_FRAMES];
+    int buckets[OVERLAY_BUCKETS] = {0};
+    int peak = 1;
+    float total = 0.0f;
+    int output_w, output_h;
+    char line[128];
+
+    if (overlay->count == 0) return;
+
+    memcpy(sorted, overlay->frame_ms, overlay->count * sizeof(float));
+    qsort(sorted, overlay->count, sizeof(float), compare_float);
+    for (int i = 0; i < overlay->count; i++) {
+        int bucket = (int)(sorted[i] / OVERLAY_BUCKET_MS);
+        if (bucket >= OVERLAY_BUCKETS) bucket = OVERLAY_BUCKETS - 1;
+        if (++buckets[bucket] > peak) peak = buckets[bucket];
+        total += sorted[i];
+    }
+    float p99 = sorted[overlay->count * 99 / 100];
+    float mean = total / overlay->count;
+
+    SDL_GetRendererOutputSize(renderer, &output_w, &output_h);
+    int left = output_w - PANEL_WIDTH - PANEL_MARGIN;
+    int line_height = atlas->height;
+    SDL_Rect panel = {left - 5, PANEL_MARGIN - 5, PANEL_WIDTH + 10,
+                      line_height * 2 + HISTOGRAM_HEIGHT + 15};
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 192);
+    SDL_RenderFillRect(renderer, &panel);
+
+    // Bars are coloured by the refresh rate a frame that long would miss
+    int bar_width = PANEL_WIDTH / OVERLAY_BUCKETS;
+    int base_y = PANEL_MARGIN + line_height * 2 + 5 + HISTOGRAM_HEIGHT;
+    for (int i = 0; i < OVERLAY_BUCKETS; i++) {
+        float bucket_ms = i * OVERLAY_BUCKET_MS;
+        int height = buckets[i] * HISTOGRAM_HEIGHT / peak;
+        SDL_Rect bar = {left + i * bar_width, base_y - height, bar_width - 1, height};
+
+        if (bucket_ms < BUDGET_60HZ_MS) SDL_SetRenderDrawColor(renderer, 0, 200, 0, 255);
+        else if (bucket_ms < BUDGET_30HZ_MS) SDL_SetRenderDrawColor(renderer, 230, 200, 0, 255);
+        else SDL_SetRenderDrawColor(renderer, 230, 0, 0, 255);
+        SDL_RenderFillRect(renderer, &bar);
+    }
+
+    float p99_bucket = p99 / OVERLAY_BUCKET_MS;
+    if (p99_bucket > OVERLAY_BUCKETS) p99_bucket = OVERLAY_BUCKETS;
+    int p99_x = left + (int)(p99_bucket * bar_width);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawLine(renderer, p99_x, base_y - HISTOGRAM_HEIGHT, p99_x, base_y);
+
+    SDL_Color white = {255, 255, 255, 255};
+    snprintf(line, sizeof(line), "%.0f FPS  %.1f ms  p99 %.1f ms",
+             mean > 0.0f ? 1000.0f / mean : 0.0f, mean, p99);
+    glyph_atlas_draw(atlas, line, left, PANEL_MARGIN, white);
+    snprintf(line, sizeof(line), "textures +%lu -%lu  hud %lu/frame", textures_created,
+             textures_destroyed, hud_laid_out);
+    glyph_atlas_draw(atlas, line, left, PANEL_MARGIN + line_height, white);
+}
@@ -0,0 +1,29 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <SDL2/SDL.h>
+
+#include "glyph_atlas.h"
+
+#define OVERLAY_FRAMES 240          // frame times kept for the statistics
+#define OVERLAY_BUCKETS 25
+#define OVERLAY_BUCKET_MS 2.0f      // the last bucket takes every slower frame
+
+// Profiling overlay (F3 in PROFILE=1 builds): FPS, a histogram of recent
+// frame times with the p99 marked, texture churn and the HUD text laid
+// out in the last frame, which should be 0 unless something changed.
+typedef struct {
+    float frame_ms[OVERLAY_FRAMES];
+    int next;
+    int count;
+    int visible;
+} FrameOverlay;
+
+void frame_overlay_record(FrameOverlay *overlay, float frame_ms);
+
+// Draws immediately; text goes through the atlas and appears on its next flush
+void frame_overlay_draw(const FrameOverlay *overlay, SDL_Renderer *renderer, GlyphAtlas *atlas,
+                        unsigned long textures_created, unsigned long textures_destroyed,
+                        unsigned long hud_laid_out);
+
+#endif
@@ -0,0 +1,127 @@
+#include "reading_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+ReadingIndex* reading_index_create(int max_ids) {
+    ReadingIndex *index = calloc(1, sizeof(ReadingIndex));
+    if (!index) return NULL;
+
+    index->key_capacity = 16;
+    while (index->key_capacity < max_ids * 2) index->key_capacity *= 2;
+
+    index->max_ids = max_ids;
+    index->keys = calloc(index->key_capacity, sizeof(ReadingKey));
+    index->readings = calloc(max_ids, sizeof(const char *));
+    index->lengths = calloc(max_ids, sizeof(uint32_t));
+    index->hashes = calloc(max_ids, sizeof(uint32_t));
+    index->next = calloc(max_ids, sizeof(int));
+    index->prev = calloc(max_ids, sizeof(int));
+
+    if (!index->keys || !index->readings || !index->lengths || !index->hashes ||
+        !index->next || !index->prev) {
+        reading_index_destroy(index);
+        return NULL;
+    }
+    return index;
+}
+
+void reading_index_destroy(ReadingIndex *index) {
+    if (!index) return;
+    free(index->keys);
+    free(index->readings);
+    free(index->lengths);
+    free(index->hashes);
+    free(index->next);
+    free(index->prev);
+    free(index);
+}
+
+// Slot holding reading, or the empty slot where it would go
+static int find_slot(const ReadingIndex *index, const char *reading, uint32_t length,
+                     uint32_t hash) {
+    int mask = index->key_capacity - 1;
+    int slot = hash & mask;
+
+    while (index->keys[slot].reading) {
+        const ReadingKey *key = &index->keys[slot];
+        if (key->hash == hash && key->length == length &&
+            memcmp(key->reading, reading, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+int reading_index_insert(ReadingIndex *index, int id, const char *reading, uint32_t length,
+                         uint32_t hash) {
+    if (id < 0 || id >= index->max_ids || !reading) return -1;
+    if (index->readings[id]) reading_index_remove(index, id);
+
+    ReadingKey *key = &index->keys[find_slot(index, reading, length, hash)];
+
+    if (!key->reading) {
+        key->reading = reading;
+        key->length = length;
+        key->hash = hash;
+        key->head = -1;
+        key->tail = -1;
+        index->key_count++;
+    }
+
+    index->readings[id] = reading;
+    index->lengths[id] = length;
+    index->hashes[id] = hash;
+    index->next[id] = -1;
+    index->prev[id] = key->tail;
+    if (key->tail >= 0) index->next[key->tail] = id;
+    else key->head = id;
+    key->tail = id;
+    return 0;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void delete_slot(ReadingIndex *index, int slot) {
+    int mask = index->key_capacity - 1;
+    int hole = slot;
+
+    for (int i = (slot + 1) & mask; index->keys[i].reading; i = (i + 1) & mask) {
+        int home = index->keys[i].hash & mask;
+        // Move the entry back unless its home lies cyclically in (hole, i]
+        int stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            index->keys[hole] = index->keys[i];
+            hole = i;
+        }
+    }
+    index->keys[hole].reading = NULL;
+    index->key_count--;
+}
+
+void reading_index_remove(ReadingIndex *index, int id) {
+    if (id < 0 || id >= index->max_ids || !index->readings[id]) return;
+
+    const char *reading = index->readings[id];
+    int slot = find_slot(index, reading, index->lengths[id], index->hashes[id]);
+    ReadingKey *key = &index->keys[slot];
+
+    if (index->prev[id] >= 0) index->next[index->prev[id]] = index->next[id];
+    else key->head = index->next[id];
+    if (index->next[id] >= 0) index->prev[index->next[id]] = index->prev[id];
+    else key->tail = index->prev[id];
+
+    index->readings[id] = NULL;
+
+    // The key may be borrowing this id's string; hand it to a remaining id
+    if (key->head < 0) delete_slot(index, slot);
+    else if (key->reading == reading) key->reading = index->readings[key->head];
+}
+
+int reading_index_find(const ReadingIndex *index, const char *reading, uint32_t length,
+                       uint32_t hash) {
+    if (!reading || length == 0) return -1;
+
+    const ReadingKey *key = &index->keys[find_slot(index, reading, length, hash)];
+    return key->reading ? key->head : -1;
+}
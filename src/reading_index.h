@@ -0,0 +1,48 @@
+#ifndef READING_INDEX_H
+#define READING_INDEX_H
+
+#include <stdint.h>
+
+// One distinct reading; its ids form a FIFO list through the per-id links
+typedef struct {
+    const char *reading;    // NULL marks an empty slot
+    uint32_t length;
+    uint32_t hash;
+    int head;               // oldest id with this reading
+    int tail;
+} ReadingKey;
+
+// Maps a reading to the live ids (enemy slots) showing it, so a submission
+// costs one hash probe instead of a strcmp per enemy. Readings come with
+// their length and hash precomputed (see collectionlib's reading.h), so a
+// probe compares integers and only touches the text of a likely match.
+// Ids sharing a reading are kept in insertion order; enemies all fall at
+// the same speed, so the oldest is the lowest on screen.
+typedef struct {
+    ReadingKey *keys;       // open addressing, linear probing
+    int key_capacity;       // power of two, at least twice max_ids
+    int key_count;
+
+    // Per-id state, indexed by id
+    int max_ids;
+    const char **readings;  // NULL while the id is not indexed
+    uint32_t *lengths;
+    uint32_t *hashes;
+    int *next;
+    int *prev;
+} ReadingIndex;
+
+ReadingIndex* reading_index_create(int max_ids);
+void reading_index_destroy(ReadingIndex *index);
+
+// The reading must stay valid while the id is indexed. hash may be any
+// hash of the reading's bytes, as long as every call uses the same one.
+int reading_index_insert(ReadingIndex *index, int id, const char *reading, uint32_t length,
+                         uint32_t hash);
+void reading_index_remove(ReadingIndex *index, int id);
+
+// Oldest id indexed under reading, or -1
+int reading_index_find(const ReadingIndex *index, const char *reading, uint32_t length,
+                       uint32_t hash);
+
+#endif
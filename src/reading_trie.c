@@ -0,0 +1,185 @@
+#include "reading_trie.h"
+
+#include <stdlib.h>
+
+#define INITIAL_NODES 256
+#define INITIAL_EDGES 512
+
+static uint64_t edge_key(int parent, unsigned char byte) {
+    return (((uint64_t)parent << 8) | byte) + 1;
+}
+
+static int edge_slot(const ReadingTrie *trie, uint64_t key) {
+    int mask = trie->edge_capacity - 1;
+    return (int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+// Slot holding key, or the empty slot where it would go
+static int find_edge(const ReadingTrie *trie, uint64_t key) {
+    int mask = trie->edge_capacity - 1;
+    int slot = edge_slot(trie, key);
+
+    while (trie->edges[slot].key && trie->edges[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int grow_edges(ReadingTrie *trie) {
+    ReadingTrieEdge *old = trie->edges;
+    int old_capacity = trie->edge_capacity;
+
+    trie->edges = calloc(old_capacity * 2, sizeof(ReadingTrieEdge));
+    if (!trie->edges) {
+        trie->edges = old;
+        return -1;
+    }
+    trie->edge_capacity = old_capacity * 2;
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].key) trie->edges[find_edge(trie, old[i].key)] = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+// Backward-shift deletion, as in the reading index
+static void delete_edge(ReadingTrie *trie, uint64_t key) {
+    int mask = trie->edge_capacity - 1;
+    int hole = find_edge(trie, key);
+
+    if (!trie->edges[hole].key) return;
+
+    for (int i = (hole + 1) & mask; trie->edges[i].key; i = (i + 1) & mask) {
+        int home = edge_slot(trie, trie->edges[i].key);
+        int stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            trie->edges[hole] = trie->edges[i];
+            hole = i;
+        }
+    }
+    trie->edges[hole].key = 0;
+    trie->edge_count--;
+}
+
+static int new_node(ReadingTrie *trie, int parent, unsigned char byte) {
+    int node = trie->free_nodes;
+
+    if (node >= 0) {
+        trie->free_nodes = trie->nodes[node].parent;
+    } else {
+        if (trie->node_count == trie->node_capacity) {
+            int capacity = trie->node_capacity * 2;
+            ReadingTrieNode *nodes = realloc(trie->nodes, capacity * sizeof(ReadingTrieNode));
+            if (!nodes) return -1;
+            trie->nodes = nodes;
+            trie->node_capacity = capacity;
+        }
+        node = trie->node_count++;
+    }
+
+    trie->nodes[node].parent = parent;
+    trie->nodes[node].depth = trie->nodes[parent].depth + 1;
+    trie->nodes[node].count = 0;
+    trie->nodes[node].ends = 0;
+    trie->nodes[node].byte = byte;
+    return node;
+}
+
+ReadingTrie* reading_trie_create(int max_ids) {
+    ReadingTrie *trie = calloc(1, sizeof(ReadingTrie));
+    if (!trie) return NULL;
+
+    trie->node_capacity = INITIAL_NODES;
+    trie->nodes = calloc(trie->node_capacity, sizeof(ReadingTrieNode));
+    trie->edge_capacity = INITIAL_EDGES;
+    trie->edges = calloc(trie->edge_capacity, sizeof(ReadingTrieEdge));
+    trie->max_ids = max_ids;
+    trie->terminal = malloc(max_ids * sizeof(int));
+
+    if (!trie->nodes || !trie->edges || !trie->terminal) {
+        reading_trie_destroy(trie);
+        return NULL;
+    }
+
+    for (int i = 0; i < max_ids; i++) trie->terminal[i] = -1;
+    trie->node_count = 1;   // the root
+    trie->nodes[READING_TRIE_ROOT].parent = -1;
+    trie->free_nodes = -1;
+    return trie;
+}
+
+void reading_trie_destroy(ReadingTrie *trie) {
+    if (!trie) return;
+    free(trie->nodes);
+    free(trie->edges);
+    free(trie->terminal);
+    free(trie);
+}
+
+int reading_trie_insert(ReadingTrie *trie, int id, const char *reading) {
+    if (id < 0 || id >= trie->max_ids || !reading) return -1;
+    if (trie->terminal[id] >= 0) reading_trie_remove(trie, id);
+
+    int node = READING_TRIE_ROOT;
+    for (const unsigned char *p = (const unsigned char *)reading; *p; p++) {
+        if ((trie->edge_count + 1) * 2 > trie->edge_capacity && grow_edges(trie) < 0) return -1;
+
+        uint64_t key = edge_key(node, *p);
+        int slot = find_edge(trie, key);
+        if (!trie->edges[slot].key) {
+            int child = new_node(trie, node, *p);
+            if (child < 0) return -1;
+            trie->edges[slot].key = key;
+            trie->edges[slot].child = child;
+            trie->edge_count++;
+        }
+        node = trie->edges[slot].child;
+    }
+
+    trie->terminal[id] = node;
+    trie->nodes[node].ends++;
+    for (int n = node; n >= 0; n = trie->nodes[n].parent) trie->nodes[n].count++;
+    return 0;
+}
+
+void reading_trie_remove(ReadingTrie *trie, int id) {
+    if (id < 0 || id >= trie->max_ids || trie->terminal[id] < 0) return;
+
+    int node = trie->terminal[id];
+    trie->terminal[id] = -1;
+    trie->nodes[node].ends--;
+
+    // Nodes no other reading passes through go back on the free list
+    while (node >= 0) {
+        ReadingTrieNode *n = &trie->nodes[node];
+        int parent = n->parent;
+
+        if (--n->count == 0 && node != READING_TRIE_ROOT) {
+            delete_edge(trie, edge_key(parent, n->byte));
+            n->parent = trie->free_nodes;
+            trie->free_nodes = node;
+        }
+        node = parent;
+    }
+}
+
+int reading_trie_walk(const ReadingTrie *trie, const char *prefix, size_t len) {
+    int node = READING_TRIE_ROOT;
+
+    for (size_t i = 0; i < len; i++) {
+        int slot = find_edge(trie, edge_key(node, (unsigned char)prefix[i]));
+        if (!trie->edges[slot].key) return -1;
+        node = trie->edges[slot].child;
+    }
+    return node;
+}
+
+int reading_trie_has_prefix(const ReadingTrie *trie, int id, int node) {
+    if (node < 0 || id < 0 || id >= trie->max_ids || trie->terminal[id] < 0) return 0;
+
+    int n = trie->terminal[id];
+    int depth = trie->nodes[node].depth;
+    while (trie->nodes[n].depth > depth) n = trie->nodes[n].parent;
+    return n == node;
+}
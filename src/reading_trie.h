@@ -0,0 +1,51 @@
+#ifndef READING_TRIE_H
+#define READING_TRIE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define READING_TRIE_ROOT 0
+
+typedef struct {
+    int parent;             // next free node while on the free list
+    int depth;              // bytes from the root
+    int count;              // ids whose reading passes through or ends here
+    int ends;               // ids whose reading ends exactly here
+    unsigned char byte;     // label of the edge from the parent
+} ReadingTrieNode;
+
+typedef struct {
+    uint64_t key;           // (parent << 8 | byte) + 1, 0 marks an empty slot
+    int child;
+} ReadingTrieEdge;
+
+// Byte-wise trie over the readings of live ids (enemy slots). Edges live in
+// one hash table, so walking the typed prefix costs O(prefix) whatever the
+// number of ids, and a node's count is the number of ids it prefixes.
+typedef struct {
+    ReadingTrieNode *nodes;
+    int node_count;
+    int node_capacity;
+    int free_nodes;         // head of the free list, -1 when empty
+
+    ReadingTrieEdge *edges; // open addressing, linear probing
+    int edge_capacity;      // power of two
+    int edge_count;
+
+    int max_ids;
+    int *terminal;          // node where each id's reading ends, -1 if absent
+} ReadingTrie;
+
+ReadingTrie* reading_trie_create(int max_ids);
+void reading_trie_destroy(ReadingTrie *trie);
+
+int reading_trie_insert(ReadingTrie *trie, int id, const char *reading);
+void reading_trie_remove(ReadingTrie *trie, int id);
+
+// Node reached by a prefix, READING_TRIE_ROOT for "", -1 if no reading has it
+int reading_trie_walk(const ReadingTrie *trie, const char *prefix, size_t len);
+
+// Whether id's reading starts with the prefix that led to node
+int reading_trie_has_prefix(const ReadingTrie *trie, int id, int node);
+
+#endif
@@ -0,0 +1,197 @@
+#include "replay.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int write_varint(FILE *f, uint64_t value) {
+    while (value >= 0x80) {
+        if (fputc((int)(value & 0x7F) | 0x80, f) == EOF) return -1;
+        value >>= 7;
+    }
+    return fputc((int)value, f) == EOF ? -1 : 0;
+}
+
+static int read_varint(FILE *f, uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = fgetc(f);
+        if (byte == EOF) return -1;
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return 0;
+    }
+    return -1;
+}
+
+int replay_writer_open(ReplayWriter *writer, const char *path, const SimConfig *config,
+                       int card_count, const char *db_path, const char *deck_name) {
+    ReplayHeader header;
+    size_t db_path_len = strlen(db_path);
+    size_t deck_name_len = strlen(deck_name);
+
+    if (db_path_len > UINT16_MAX || deck_name_len > UINT16_MAX) return -1;
+
+    writer->file = fopen(path, "wb");
+    writer->last_tick = 0;
+    if (!writer->file) {
+        fprintf(stderr, "Cannot write replay %s\n", path);
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.tick_rate = config->tick_rate;
+    header.seed = config->seed;
+    header.width = config->width;
+    header.height = config->height;
+    header.max_enemies = config->max_enemies;
+    header.auto_fire = config->auto_fire;
+    header.enemy_speed = config->enemy_speed;
+    header.spawn_delay = config->spawn_delay;
+    header.meaning_duration = config->meaning_duration;
+    header.scheduler = config->scheduler;
+    header.card_count = card_count;
+    header.db_path_len = (uint16_t)db_path_len;
+    header.deck_name_len = (uint16_t)deck_name_len;
+
+    if (fwrite(&header, sizeof(header), 1, writer->file) != 1 ||
+        fwrite(db_path, 1, db_path_len, writer->file) != db_path_len ||
+        fwrite(deck_name, 1, deck_name_len, writer->file) != deck_name_len) {
+        fclose(writer->file);
+        writer->file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int replay_write_key(ReplayWriter *writer, uint64_t tick, char key) {
+    if (!writer->file || key == '\0') return -1;
+
+    // Keys arrive in tick order, so deltas are small: two bytes per key
+    if (write_varint(writer->file, tick - writer->last_tick) < 0 ||
+        fputc((unsigned char)key, writer->file) == EOF) {
+        return -1;
+    }
+    writer->last_tick = tick;
+    return 0;
+}
+
+int replay_writer_close(ReplayWriter *writer, uint64_t end_tick, int32_t final_score) {
+    int rc = 0;
+
+    if (!writer->file) return -1;
+    if (write_varint(writer->file, end_tick - writer->last_tick) < 0 ||
+        fputc(0, writer->file) == EOF ||
+        fwrite(&final_score, sizeof(final_score), 1, writer->file) != 1) {
+        rc = -1;
+    }
+    if (fclose(writer->file) != 0) rc = -1;
+    writer->file = NULL;
+    return rc;
+}
+
+static char* read_string(FILE *f, size_t len) {
+    char *str = malloc(len + 1);
+    if (!str) return NULL;
+    if (fread(str, 1, len, f) != len) {
+        free(str);
+        return NULL;
+    }
+    str[len] = '\0';
+    return str;
+}
+
+static int header_valid(const ReplayHeader *header) {
+    return header->tick_rate > 0 && header->tick_rate <= REPLAY_MAX_TICK_RATE &&
+           header->width >= REPLAY_MIN_SIZE && header->width <= REPLAY_MAX_SIZE &&
+           header->height >= REPLAY_MIN_SIZE && header->height <= REPLAY_MAX_SIZE &&
+           header->max_enemies > 0 && header->max_enemies <= REPLAY_MAX_ENEMIES;
+}
+
+int replay_load(const char *path, Replay *replay) {
+    ReplayHeader header;
+    int capacity = 0;
+    uint64_t tick = 0;
+
+    memset(replay, 0, sizeof(*replay));
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot open replay %s\n", path);
+        return -1;
+    }
+
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != REPLAY_VERSION) {
+        fprintf(stderr, "Not a replay file: %s\n", path);
+        fclose(f);
+        return -1;
+    }
+    if (!header_valid(&header)) {
+        fprintf(stderr, "Replay %s has an out-of-range header\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    sim_default_config(&replay->config);
+    replay->config.tick_rate = header.tick_rate;
+    replay->config.seed = header.seed;
+    replay->config.width = header.width;
+    replay->config.height = header.height;
+    replay->config.max_enemies = header.max_enemies;
+    replay->config.auto_fire = header.auto_fire;
+    replay->config.enemy_speed = header.enemy_speed;
+    replay->config.spawn_delay = header.spawn_delay;
+    replay->config.meaning_duration = header.meaning_duration;
+    replay->config.scheduler = header.scheduler;
+    replay->card_count = header.card_count;
+    replay->db_path = read_string(f, header.db_path_len);
+    replay->deck_name = read_string(f, header.deck_name_len);
+    if (!replay->db_path || !replay->deck_name) goto fail;
+
+    for (;;) {
+        uint64_t delta;
+        int key;
+
+        if (read_varint(f, &delta) < 0 || (key = fgetc(f)) == EOF) goto fail;
+        tick += delta;
+        if (key == 0) break;
+
+        if (replay->event_count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            ReplayEvent *events = realloc(replay->events, capacity * sizeof(ReplayEvent));
+            if (!events) goto fail;
+            replay->events = events;
+        }
+        replay->events[replay->event_count].tick = tick;
+        replay->events[replay->event_count].key = (char)key;
+        replay->event_count++;
+    }
+
+    replay->end_tick = tick;
+    if (fread(&replay->final_score, sizeof(replay->final_score), 1, f) != 1) goto fail;
+
+    fclose(f);
+    return 0;
+
+fail:
+    fprintf(stderr, "Truncated replay: %s\n", path);
+    fclose(f);
+    replay_free(replay);
+    return -1;
+}
+
+void replay_free(Replay *replay) {
+    free(replay->db_path);
+    free(replay->deck_name);
+    free(replay->events);
+    memset(replay, 0, sizeof(*replay));
+}
+
+void replay_feed(Replay *replay, GameSim *sim) {
+    while (replay->next_event < replay->event_count &&
+           replay->events[replay->next_event].tick <= sim->tick) {
+        sim_key(sim, replay->events[replay->next_event].key);
+        replay->next_event++;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "sim.h"
+
+#define REPLAY_MAGIC "TYPREPL1"
+#define REPLAY_VERSION 2
+#define REPLAY_EXTENSION ".replay"
+
+// Header values outside these bounds are rejected on load. Enemies spawn at
+// least 50 px from either side, so the playfield must be wider than 100.
+#define REPLAY_MAX_TICK_RATE 10000
+#define REPLAY_MIN_SIZE 101
+#define REPLAY_MAX_SIZE 16384
+#define REPLAY_MAX_ENEMIES 100000
+
+// Fixed part of a replay file. It is followed by the collection path and
+// deck name, then the key events: a varint tick delta and one key byte
+// each. A zero key byte ends the stream at the session's last tick, and the
+// final score follows it as a check.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t tick_rate;
+    uint64_t seed;
+    int32_t width;
+    int32_t height;
+    int32_t max_enemies;
+    int32_t auto_fire;
+    float enemy_speed;
+    uint32_t spawn_delay;
+    uint32_t meaning_duration;
+    int32_t scheduler;
+    int32_t card_count;     // the deck must load to the same cards to replay
+    uint16_t db_path_len;
+    uint16_t deck_name_len;
+} ReplayHeader;
+
+typedef struct {
+    uint64_t tick;          // sim->tick when the key was applied
+    char key;               // as passed to sim_key
+} ReplayEvent;
+
+typedef struct {
+    FILE *file;
+    uint64_t last_tick;
+} ReplayWriter;
+
+typedef struct {
+    SimConfig config;
+    int card_count;
+    char *db_path;
+    char *deck_name;
+    ReplayEvent *events;
+    int event_count;
+    uint64_t end_tick;
+    int32_t final_score;
+    int next_event;         // playback cursor
+} Replay;
+
+int replay_writer_open(ReplayWriter *writer, const char *path, const SimConfig *config,
+                       int card_count, const char *db_path, const char *deck_name);
+int replay_write_key(ReplayWriter *writer, uint64_t tick, char key);
+int replay_writer_close(ReplayWriter *writer, uint64_t end_tick, int32_t final_score);
+
+int replay_load(const char *path, Replay *replay);
+void replay_free(Replay *replay);
+
+// Apply the events recorded for the current tick; call before each sim_step
+void replay_feed(Replay *replay, GameSim *sim);
+
+#endif
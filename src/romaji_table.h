@@ -0,0 +1,122 @@
+#ifndef ROMAJI_TABLE_H
+#define ROMAJI_TABLE_H
+
+// Source table for the romaji DFA: tools/romaji_gen turns it into
+// build/gen/romaji_dfa.h at build time, so edits here need no other changes.
+// It follows the romaji of the common Japanese IMEs. Katakana is derived
+// from the hiragana, and no entry may be a prefix of another: the converter
+// emits as soon as an entry is complete.
+
+typedef struct {
+    const char *romaji;
+    const char *hiragana;
+} RomajiPair;
+
+// An entry whose last letters are not spent: they begin the next kana
+typedef struct {
+    const char *romaji;
+    const char *hiragana;
+    int rest;               // trailing letters fed again after the kana
+} RomajiSplit;
+
+// Romaji to Hiragana conversion table
+static const RomajiPair romaji_table[] = {
+    // Vowels
+    {"a", "あ"}, {"i", "い"}, {"u", "う"}, {"e", "え"}, {"o", "お"},
+
+    // Basic characters, with the Kunrei and Nihon-shiki spellings IMEs accept
+    {"ka", "か"}, {"ki", "き"}, {"ku", "く"}, {"ke", "け"}, {"ko", "こ"},
+    {"ca", "か"}, {"cu", "く"}, {"co", "こ"},
+    {"ga", "が"}, {"gi", "ぎ"}, {"gu", "ぐ"}, {"ge", "げ"}, {"go", "ご"},
+    {"sa", "さ"}, {"si", "し"}, {"shi", "し"}, {"su", "す"}, {"se", "せ"}, {"so", "そ"},
+    {"ci", "し"}, {"ce", "せ"},
+    {"za", "ざ"}, {"zi", "じ"}, {"ji", "じ"}, {"zu", "ず"}, {"ze", "ぜ"}, {"zo", "ぞ"},
+    {"ta", "た"}, {"ti", "ち"}, {"chi", "ち"}, {"tu", "つ"}, {"tsu", "つ"},
+    {"te", "て"}, {"to", "と"},
+    {"da", "だ"}, {"di", "ぢ"}, {"du", "づ"}, {"de", "で"}, {"do", "ど"},
+    {"dzi", "ぢ"}, {"dzu", "づ"},
+    {"na", "な"}, {"ni", "に"}, {"nu", "ぬ"}, {"ne", "ね"}, {"no", "の"},
+    {"ha", "は"}, {"hi", "ひ"}, {"hu", "ふ"}, {"fu", "ふ"}, {"he", "へ"}, {"ho", "ほ"},
+    {"ba", "ば"}, {"bi", "び"}, {"bu", "ぶ"}, {"be", "べ"}, {"bo", "ぼ"},
+    {"pa", "ぱ"}, {"pi", "ぴ"}, {"pu", "ぷ"}, {"pe", "ぺ"}, {"po", "ぽ"},
+    {"ma", "ま"}, {"mi", "み"}, {"mu", "む"}, {"me", "め"}, {"mo", "も"},
+    {"ya", "や"}, {"yi", "い"}, {"yu", "ゆ"}, {"ye", "いぇ"}, {"yo", "よ"},
+    {"ra", "ら"}, {"ri", "り"}, {"ru", "る"}, {"re", "れ"}, {"ro", "ろ"},
+    {"wa", "わ"}, {"wi", "うぃ"}, {"wu", "う"}, {"we", "うぇ"}, {"wo", "を"},
+
+    // Combined characters
+    {"kya", "きゃ"}, {"kyi", "きぃ"}, {"kyu", "きゅ"}, {"kye", "きぇ"}, {"kyo", "きょ"},
+    {"gya", "ぎゃ"}, {"gyi", "ぎぃ"}, {"gyu", "ぎゅ"}, {"gye", "ぎぇ"}, {"gyo", "ぎょ"},
+    {"sha", "しゃ"}, {"shu", "しゅ"}, {"she", "しぇ"}, {"sho", "しょ"},
+    {"sya", "しゃ"}, {"syi", "しぃ"}, {"syu", "しゅ"}, {"sye", "しぇ"}, {"syo", "しょ"},
+    {"ja", "じゃ"}, {"ju", "じゅ"}, {"je", "じぇ"}, {"jo", "じょ"},
+    {"jya", "じゃ"}, {"jyi", "じぃ"}, {"jyu", "じゅ"}, {"jye", "じぇ"}, {"jyo", "じょ"},
+    {"zya", "じゃ"}, {"zyi", "じぃ"}, {"zyu", "じゅ"}, {"zye", "じぇ"}, {"zyo", "じょ"},
+    {"cha", "ちゃ"}, {"chu", "ちゅ"}, {"che", "ちぇ"}, {"cho", "ちょ"},
+    {"tya", "ちゃ"}, {"tyi", "ちぃ"}, {"tyu", "ちゅ"}, {"tye", "ちぇ"}, {"tyo", "ちょ"},
+    {"cya", "ちゃ"}, {"cyi", "ちぃ"}, {"cyu", "ちゅ"}, {"cye", "ちぇ"}, {"cyo", "ちょ"},
+    {"dya", "ぢゃ"}, {"dyi", "ぢぃ"}, {"dyu", "ぢゅ"}, {"dye", "ぢぇ"}, {"dyo", "ぢょ"},
+    {"nya", "にゃ"}, {"nyi", "にぃ"}, {"nyu", "にゅ"}, {"nye", "にぇ"}, {"nyo", "にょ"},
+    {"hya", "ひゃ"}, {"hyi", "ひぃ"}, {"hyu", "ひゅ"}, {"hye", "ひぇ"}, {"hyo", "ひょ"},
+    {"bya", "びゃ"}, {"byi", "びぃ"}, {"byu", "びゅ"}, {"bye", "びぇ"}, {"byo", "びょ"},
+    {"pya", "ぴゃ"}, {"pyi", "ぴぃ"}, {"pyu", "ぴゅ"}, {"pye", "ぴぇ"}, {"pyo", "ぴょ"},
+    {"mya", "みゃ"}, {"myi", "みぃ"}, {"myu", "みゅ"}, {"mye", "みぇ"}, {"myo", "みょ"},
+    {"rya", "りゃ"}, {"ryi", "りぃ"}, {"ryu", "りゅ"}, {"rye", "りぇ"}, {"ryo", "りょ"},
+
+    // Extended characters for loanwords
+    {"fa", "ふぁ"}, {"fi", "ふぃ"}, {"fe", "ふぇ"}, {"fo", "ふぉ"},
+    {"fya", "ふゃ"}, {"fyu", "ふゅ"}, {"fyo", "ふょ"},
+    {"va", "ゔぁ"}, {"vi", "ゔぃ"}, {"vu", "ゔ"}, {"ve", "ゔぇ"}, {"vo", "ゔぉ"},
+    {"vya", "ゔゃ"}, {"vyu", "ゔゅ"}, {"vyo", "ゔょ"},
+    {"qa", "くぁ"}, {"qi", "くぃ"}, {"qu", "く"}, {"qe", "くぇ"}, {"qo", "くぉ"},
+    {"kwa", "くぁ"}, {"gwa", "ぐぁ"},
+    {"tsa", "つぁ"}, {"tsi", "つぃ"}, {"tse", "つぇ"}, {"tso", "つぉ"},
+    {"tha", "てゃ"}, {"thi", "てぃ"}, {"thu", "てゅ"}, {"the", "てぇ"}, {"tho", "てょ"},
+    {"twa", "とぁ"}, {"twi", "とぃ"}, {"twu", "とぅ"}, {"twe", "とぇ"}, {"two", "とぉ"},
+    {"dha", "でゃ"}, {"dhi", "でぃ"}, {"dhu", "でゅ"}, {"dhe", "でぇ"}, {"dho", "でょ"},
+    {"dwa", "どぁ"}, {"dwi", "どぃ"}, {"dwu", "どぅ"}, {"dwe", "どぇ"}, {"dwo", "どぉ"},
+    {"wha", "うぁ"}, {"whi", "うぃ"}, {"whu", "う"}, {"whe", "うぇ"}, {"who", "うぉ"},
+
+    // Small kana on their own
+    {"xa", "ぁ"}, {"xi", "ぃ"}, {"xu", "ぅ"}, {"xe", "ぇ"}, {"xo", "ぉ"},
+    {"la", "ぁ"}, {"li", "ぃ"}, {"lu", "ぅ"}, {"le", "ぇ"}, {"lo", "ぉ"},
+    {"xya", "ゃ"}, {"xyu", "ゅ"}, {"xyo", "ょ"}, {"lya", "ゃ"}, {"lyu", "ゅ"}, {"lyo", "ょ"},
+    {"xtu", "っ"}, {"xtsu", "っ"}, {"ltu", "っ"}, {"ltsu", "っ"},
+    {"xwa", "ゎ"}, {"lwa", "ゎ"}, {"xka", "ゕ"}, {"lka", "ゕ"}, {"xke", "ゖ"}, {"lke", "ゖ"},
+
+    // Long vowel mark
+    {"-", "ー"},
+
+    // N, spelled outright; see romaji_split_table for the rest
+    {"nn", "ん"}, {"n'", "ん"}, {"xn", "ん"},
+
+    {NULL, NULL}
+};
+
+// Entries that spell a kana and leave their last letters pending
+static const RomajiSplit romaji_split_table[] = {
+    // N before any letter but a vowel, y or n is ん, and the letter starts
+    // the next kana. A lone trailing n is converted by romaji_final_table.
+    {"nb", "ん", 1}, {"nc", "ん", 1}, {"nd", "ん", 1}, {"nf", "ん", 1}, {"ng", "ん", 1},
+    {"nh", "ん", 1}, {"nj", "ん", 1}, {"nk", "ん", 1}, {"nl", "ん", 1}, {"nm", "ん", 1},
+    {"np", "ん", 1}, {"nq", "ん", 1}, {"nr", "ん", 1}, {"ns", "ん", 1}, {"nt", "ん", 1},
+    {"nv", "ん", 1}, {"nw", "ん", 1}, {"nx", "ん", 1}, {"nz", "ん", 1}, {"n-", "ん", 1},
+
+    // Small tsu for doubled consonants; the second one starts the next kana
+    {"bb", "っ", 1}, {"cc", "っ", 1}, {"dd", "っ", 1}, {"ff", "っ", 1}, {"gg", "っ", 1},
+    {"hh", "っ", 1}, {"jj", "っ", 1}, {"kk", "っ", 1}, {"ll", "っ", 1}, {"mm", "っ", 1},
+    {"pp", "っ", 1}, {"qq", "っ", 1}, {"rr", "っ", 1}, {"ss", "っ", 1}, {"tt", "っ", 1},
+    {"vv", "っ", 1}, {"ww", "っ", 1}, {"xx", "っ", 1}, {"yy", "っ", 1}, {"zz", "っ", 1},
+    {"tch", "っ", 2},
+
+    {NULL, NULL, 0}
+};
+
+// Pending romaji that still spells a kana when the input ends on it
+static const RomajiPair romaji_final_table[] = {
+    {"n", "ん"},
+
+    {NULL, NULL}
+};
+
+#endif
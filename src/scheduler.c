@@ -0,0 +1,240 @@
+#include "scheduler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SUSPENDED_KEY -1e6f
+#define MAX_OVERDUE_DAYS 3650.0f
+#define SHOWN_PENALTY_DAYS 30.0f    // a card played this session waits like one a month less due
+#define EASE_WEIGHT 0.5f
+#define DEFAULT_FACTOR 2500
+
+static float uniform_priority(const CardSchedule *schedule, int shown, float jitter) {
+    (void)schedule;
+    (void)shown;
+    return jitter;
+}
+
+// Most overdue first, then new cards, then cards not yet due
+static float due_first_priority(const CardSchedule *schedule, int shown, float jitter) {
+    if (!schedule) return jitter - shown * SHOWN_PENALTY_DAYS;
+    if (schedule->queue < 0) return SUSPENDED_KEY + jitter;
+
+    float overdue = schedule->overdue_days;
+    if (overdue > MAX_OVERDUE_DAYS) overdue = MAX_OVERDUE_DAYS;
+    if (overdue < -MAX_OVERDUE_DAYS) overdue = -MAX_OVERDUE_DAYS;
+    return overdue - shown * SHOWN_PENALTY_DAYS + jitter;
+}
+
+// Highest share of failed answers first, nudged up for lowered ease. Each
+// play this session halves a card's claim so the same few cards don't loop.
+static float weakest_first_priority(const CardSchedule *schedule, int shown, float jitter) {
+    float weakness = 0.5f;
+
+    if (schedule) {
+        if (schedule->queue < 0) return SUSPENDED_KEY + jitter;
+
+        // Smoothed so an unreviewed card counts as a coin flip
+        weakness = (schedule->lapses + schedule->failures + 1.0f) /
+                   (schedule->reps + schedule->reviews + 2.0f);
+        if (schedule->factor > 0 && schedule->factor < DEFAULT_FACTOR) {
+            weakness += EASE_WEIGHT * (DEFAULT_FACTOR - schedule->factor) / DEFAULT_FACTOR;
+        }
+    }
+
+    for (int i = 0; i < shown && weakness > 1e-6f; i++) weakness *= 0.5f;
+    return weakness + jitter * 0.01f;
+}
+
+const SchedulerStrategy scheduler_strategies[SCHEDULER_STRATEGY_COUNT] = {
+    [SCHEDULER_UNIFORM] = {"uniform", uniform_priority},
+    [SCHEDULER_DUE_FIRST] = {"due", due_first_priority},
+    [SCHEDULER_WEAKEST_FIRST] = {"weakest", weakest_first_priority},
+};
+
+int scheduler_strategy_find(const char *name) {
+    for (int i = 0; i < SCHEDULER_STRATEGY_COUNT; i++) {
+        if (strcmp(scheduler_strategies[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// splitmix64, as in the simulation, so picks replay from the seed
+static float next_jitter(CardScheduler *scheduler) {
+    uint64_t z = (scheduler->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (float)(z >> 40) / (float)(1 << 24);
+}
+
+static float card_key(CardScheduler *scheduler, int card) {
+    const CardSchedule *schedule = scheduler->schedule ? &scheduler->schedule[card] : NULL;
+    return scheduler->strategy->priority(schedule, scheduler->shown[card], next_jitter(scheduler));
+}
+
+// Entries move through place() so every card knows its heap slot
+static void place(CardScheduler *scheduler, int pos, SchedulerEntry entry) {
+    scheduler->heap[pos] = entry;
+    scheduler->position[entry.card] = pos;
+}
+
+static void sift_up(CardScheduler *scheduler, int pos) {
+    SchedulerEntry *heap = scheduler->heap;
+    SchedulerEntry entry = heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap[parent].key >= entry.key) break;
+        place(scheduler, pos, heap[parent]);
+        pos = parent;
+    }
+    place(scheduler, pos, entry);
+}
+
+static void sift_down(CardScheduler *scheduler, int pos) {
+    SchedulerEntry *heap = scheduler->heap;
+    SchedulerEntry entry = heap[pos];
+    int size = scheduler->size;
+    for (;;) {
+        int child = pos * 2 + 1;
+        if (child >= size) break;
+        if (child + 1 < size && heap[child + 1].key > heap[child].key) child++;
+        if (heap[child].key <= entry.key) break;
+        place(scheduler, pos, heap[child]);
+        pos = child;
+    }
+    place(scheduler, pos, entry);
+}
+
+static void push(CardScheduler *scheduler, int card) {
+    int pos = scheduler->size++;
+    scheduler->heap[pos].key = card_key(scheduler, card);
+    scheduler->heap[pos].card = card;
+    sift_up(scheduler, pos);
+}
+
+// Take the entry at pos out, filling the hole with the last one
+static void remove_at(CardScheduler *scheduler, int pos) {
+    scheduler->position[scheduler->heap[pos].card] = -1;
+    if (--scheduler->size == pos) return;
+
+    int moved = scheduler->heap[scheduler->size].card;
+    place(scheduler, pos, scheduler->heap[scheduler->size]);
+    sift_down(scheduler, pos);
+    sift_up(scheduler, scheduler->position[moved]);
+}
+
+CardScheduler* scheduler_create(const SchedulerStrategy *strategy, const CardSchedule *schedule,
+                                int card_count, uint64_t seed) {
+    CardScheduler *scheduler = calloc(1, sizeof(CardScheduler));
+    if (!scheduler) {
+        fprintf(stderr, "Failed to allocate card scheduler\n");
+        return NULL;
+    }
+
+    scheduler->strategy = strategy;
+    scheduler->schedule = schedule;
+    scheduler->card_count = card_count;
+    scheduler->capacity = card_count ? card_count : 1;
+    scheduler->rng = seed;
+    scheduler->heap = malloc((card_count ? card_count : 1) * sizeof(SchedulerEntry));
+    scheduler->shown = calloc(card_count ? card_count : 1, sizeof(int));
+    scheduler->position = malloc((card_count ? card_count : 1) * sizeof(int));
+    if (!scheduler->heap || !scheduler->shown || !scheduler->position) {
+        fprintf(stderr, "Failed to allocate card scheduler\n");
+        scheduler_destroy(scheduler);
+        return NULL;
+    }
+
+    // Bottom-up heapify: O(n) rather than n pushes
+    for (int i = 0; i < card_count; i++) {
+        scheduler->heap[i].key = card_key(scheduler, i);
+        scheduler->heap[i].card = i;
+        scheduler->position[i] = i;
+    }
+    scheduler->size = card_count;
+    for (int i = card_count / 2 - 1; i >= 0; i--) {
+        sift_down(scheduler, i);
+    }
+
+    return scheduler;
+}
+
+void scheduler_destroy(CardScheduler *scheduler) {
+    if (!scheduler) return;
+    free(scheduler->heap);
+    free(scheduler->shown);
+    free(scheduler->position);
+    free(scheduler);
+}
+
+int scheduler_next(CardScheduler *scheduler) {
+    if (scheduler->size == 0) return -1;
+
+    int card = scheduler->heap[0].card;
+    remove_at(scheduler, 0);
+
+    scheduler->shown[card]++;
+    return card;
+}
+
+void scheduler_release(CardScheduler *scheduler, int card) {
+    if (card < 0 || card >= scheduler->card_count || scheduler->position[card] >= 0) return;
+    push(scheduler, card);
+}
+
+void scheduler_withdraw(CardScheduler *scheduler, int card) {
+    if (card < 0 || card >= scheduler->card_count || scheduler->position[card] < 0) return;
+    remove_at(scheduler, scheduler->position[card]);
+}
+
+void scheduler_update(CardScheduler *scheduler, int card) {
+    if (card < 0 || card >= scheduler->card_count || scheduler->position[card] < 0) return;
+
+    int pos = scheduler->position[card];
+    scheduler->heap[pos].key = card_key(scheduler, card);
+    sift_down(scheduler, pos);
+    sift_up(scheduler, scheduler->position[card]);
+}
+
+int scheduler_add_cards(CardScheduler *scheduler, int new_count) {
+    if (new_count <= scheduler->card_count) return 0;
+
+    if (new_count > scheduler->capacity) {
+        int capacity = scheduler->capacity * 2;
+        if (capacity < new_count) capacity = new_count;
+
+        SchedulerEntry *heap = realloc(scheduler->heap, capacity * sizeof(SchedulerEntry));
+        if (heap) scheduler->heap = heap;
+        int *shown = heap ? realloc(scheduler->shown, capacity * sizeof(int)) : NULL;
+        if (shown) scheduler->shown = shown;
+        int *position = shown ? realloc(scheduler->position, capacity * sizeof(int)) : NULL;
+        if (!position) {
+            fprintf(stderr, "Failed to grow card scheduler to %d cards\n", new_count);
+            return -1;
+        }
+        scheduler->position = position;
+        scheduler->capacity = capacity;
+    }
+
+    int first = scheduler->card_count;
+    scheduler->card_count = new_count;
+    for (int card = first; card < new_count; card++) {
+        scheduler->shown[card] = 0;
+        scheduler->position[card] = -1;
+        push(scheduler, card);
+    }
+    return 0;
+}
+
+void scheduler_set_schedule(CardScheduler *scheduler, const CardSchedule *schedule) {
+    scheduler->schedule = schedule;
+
+    for (int i = 0; i < scheduler->size; i++) {
+        scheduler->heap[i].key = card_key(scheduler, scheduler->heap[i].card);
+    }
+    for (int i = scheduler->size / 2 - 1; i >= 0; i--) {
+        sift_down(scheduler, i);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#include "../collectionlib/include/card.h"
+
+// Built-in strategies, by SimConfig.scheduler
+#define SCHEDULER_UNIFORM 0
+#define SCHEDULER_DUE_FIRST 1
+#define SCHEDULER_WEAKEST_FIRST 2
+#define SCHEDULER_STRATEGY_COUNT 3
+
+// A strategy is one priority function: larger keys spawn sooner. schedule is
+// NULL when the collection has no review data; shown counts how often the
+// card was picked this session; jitter is uniform in [0, 1) and breaks ties.
+typedef struct {
+    const char *name;
+    float (*priority)(const CardSchedule *schedule, int shown, float jitter);
+} SchedulerStrategy;
+
+extern const SchedulerStrategy scheduler_strategies[SCHEDULER_STRATEGY_COUNT];
+
+// Strategy id for a name, or -1
+int scheduler_strategy_find(const char *name);
+
+typedef struct {
+    float key;
+    int card;
+} SchedulerEntry;
+
+// Picks which card spawns next. Cards waiting to spawn sit in a binary
+// max-heap on their strategy key, so a pick or a requeue is O(log n) and
+// the key is computed once per requeue, not per pick. A card is out of the
+// heap while it is in play, so the same card never shows twice at once.
+typedef struct {
+    const SchedulerStrategy *strategy;
+    const CardSchedule *schedule;   // one per card, or NULL
+    int card_count;
+    int capacity;                   // heap and shown slots allocated
+
+    SchedulerEntry *heap;
+    int size;
+    int *position;                  // heap slot per card, -1 while out of the heap
+    int *shown;                     // picks per card this session
+    uint64_t rng;
+} CardScheduler;
+
+CardScheduler* scheduler_create(const SchedulerStrategy *strategy, const CardSchedule *schedule,
+                                int card_count, uint64_t seed);
+void scheduler_destroy(CardScheduler *scheduler);
+
+// Remove and return the highest-priority card, or -1 if all are in play
+int scheduler_next(CardScheduler *scheduler);
+
+// A picked card left play; it is requeued under its updated priority.
+// Releasing a card that is already waiting does nothing.
+void scheduler_release(CardScheduler *scheduler, int card);
+
+// Take a waiting card out for good, e.g. one deleted from the deck; a card
+// in play is simply not released again
+void scheduler_withdraw(CardScheduler *scheduler, int card);
+
+// A waiting card's review data changed: recompute its key in place
+void scheduler_update(CardScheduler *scheduler, int card);
+
+// Cards card_count..new_count-1 arrived (an async load published them);
+// they join the heap under the current strategy
+int scheduler_add_cards(CardScheduler *scheduler, int new_count);
+
+// Review data became available: rekey every waiting card and reheapify
+void scheduler_set_schedule(CardScheduler *scheduler, const CardSchedule *schedule);
+
+#endif
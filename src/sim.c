@@ -0,0 +1,243 @@
+#include "sim.h"
+
+#include <stdlib.h>
+
+#include "../collectionlib/include/reading.h"
+#include "../collectionlib/include/trace.h"
+
+// splitmix64: tiny, seedable and identical on every platform, unlike rand()
+static uint64_t sim_random(GameSim *sim) {
+    uint64_t z = (sim->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void sim_default_config(SimConfig *config) {
+    config->tick_rate = SIM_DEFAULT_TICK_RATE;
+    config->width = 800;
+    config->height = 600;
+    config->max_enemies = 10;
+    config->enemy_speed = 30.0f;
+    config->spawn_delay = 6000;
+    config->meaning_duration = 2000;
+    config->auto_fire = 0;
+    config->scheduler = SCHEDULER_UNIFORM;
+    config->seed = 1;
+}
+
+GameSim* sim_create(const SimConfig *config, CardCollection *collection) {
+    GameSim *sim = calloc(1, sizeof(GameSim));
+    if (!sim) return NULL;
+
+    sim->config = *config;
+    if (sim->config.tick_rate <= 0) sim->config.tick_rate = SIM_DEFAULT_TICK_RATE;
+    if (sim->config.scheduler < 0 || sim->config.scheduler >= SCHEDULER_STRATEGY_COUNT) {
+        sim->config.scheduler = SCHEDULER_UNIFORM;
+    }
+    sim->collection = collection;
+    sim->rng = config->seed;
+    sim->match_node = -1;
+    romaji_converter_init(&sim->input, KANA_HIRAGANA);
+
+    sim->enemies = enemy_pool_create(config->max_enemies);
+    sim->readings = reading_index_create(config->max_enemies * CARD_MAX_ANSWERS);
+    sim->prefixes = reading_trie_create(config->max_enemies * CARD_MAX_ANSWERS);
+    sim->spawn_time = calloc(config->max_enemies > 0 ? config->max_enemies : 1, sizeof(uint32_t));
+    // While an async load runs only the published cards are there, and the
+    // review data comes last; sim_sync_collection picks both up later
+    sim->scheduler = scheduler_create(&scheduler_strategies[sim->config.scheduler],
+                                      collection->loading ? NULL : collection->schedule,
+                                      collection_published(collection), sim_random(sim));
+    if (!sim->enemies || !sim->readings || !sim->prefixes || !sim->scheduler || !sim->spawn_time) {
+        sim_destroy(sim);
+        return NULL;
+    }
+    return sim;
+}
+
+void sim_sync_collection(GameSim *sim) {
+    CardCollection *collection = sim->collection;
+
+    scheduler_add_cards(sim->scheduler, collection_published(collection));
+    if (!collection->loading && collection->schedule &&
+        sim->scheduler->schedule != collection->schedule) {
+        scheduler_set_schedule(sim->scheduler, collection->schedule);
+    }
+}
+
+static int card_in_play(const GameSim *sim, int card_index) {
+    const EnemyPool *enemies = sim->enemies;
+    for (int i = 0; i < enemies->count; i++) {
+        if (enemies->card_index[i] == card_index) return 1;
+    }
+    return 0;
+}
+
+void sim_apply_changes(GameSim *sim, const CollectionChanges *changes) {
+    CardScheduler *scheduler = sim->scheduler;
+
+    // Review data grows with the cards and may have moved; what it held for
+    // the old cards is unchanged
+    if (scheduler->schedule) scheduler->schedule = sim->collection->schedule;
+    sim_sync_collection(sim);
+
+    for (int i = 0; i < changes->retired.count; i++) {
+        scheduler_withdraw(scheduler, changes->retired.items[i]);
+    }
+    for (int i = 0; i < changes->restored.count; i++) {
+        int card = changes->restored.items[i];
+        if (!card_in_play(sim, card)) scheduler_release(scheduler, card);
+    }
+    if (scheduler->schedule) {
+        for (int i = 0; i < changes->rescheduled.count; i++) {
+            scheduler_update(scheduler, changes->rescheduled.items[i]);
+        }
+    }
+}
+
+void sim_destroy(GameSim *sim) {
+    if (!sim) return;
+    enemy_pool_destroy(sim->enemies);
+    reading_index_destroy(sim->readings);
+    reading_trie_destroy(sim->prefixes);
+    scheduler_destroy(sim->scheduler);
+    free(sim->spawn_time);
+    free(sim);
+}
+
+void spawn_enemy(GameSim *sim) {
+    if (sim->enemies->free_count == 0) return;
+
+    int card_index = scheduler_next(sim->scheduler);
+    if (card_index < 0) return;
+    float x = 50 + (sim_random(sim) % (sim->config.width - 100));
+    int id = enemy_pool_spawn(sim->enemies, card_index, x, -50, sim->config.enemy_speed);
+    sim->spawn_time[id] = sim->time_ms;
+
+    // Every answer the collection worked out for the card is indexed
+    const CardData *card = &sim->collection->cards[card_index];
+    for (int k = 0; k < card->answer_count; k++) {
+        const CardAnswer *answer = &card->answers[k];
+        int entry = id * CARD_MAX_ANSWERS + k;
+        reading_index_insert(sim->readings, entry, answer->text, answer->length, answer->hash);
+        reading_trie_insert(sim->prefixes, entry, answer->text);
+    }
+    update_prefix_match(sim);
+
+    if (sim->on_spawn) sim->on_spawn(sim->user_data, card_index);
+}
+
+void update_enemies(GameSim *sim, float delta_time) {
+    TRACE_SCOPE("update_enemies");
+    enemy_pool_expire(sim->enemies, sim->time_ms, sim->config.meaning_duration);
+
+    float kill_line = sim->config.height - 50;
+    if (!enemy_pool_update(sim->enemies, delta_time, kill_line)) return;
+
+    sim->game_over = 1;
+    if (!sim->on_result) return;
+
+    EnemyPool *enemies = sim->enemies;
+    for (int i = 0; i < enemies->count; i++) {
+        if (enemies->y[i] > kill_line) {
+            sim->on_result(sim->user_data, enemies->card_index[i], 0,
+                           sim->time_ms - sim->spawn_time[enemies->id[i]]);
+        }
+    }
+}
+
+void sim_step(GameSim *sim) {
+    if (sim->game_over) return;
+    TRACE_SCOPE("sim_step");
+
+    sim->tick++;
+    sim->time_ms = (uint32_t)(sim->tick * 1000 / sim->config.tick_rate);
+
+    if (sim->time_ms - sim->last_spawn_time > sim->config.spawn_delay) {
+        spawn_enemy(sim);
+        sim->last_spawn_time = sim->time_ms;
+    }
+
+    update_enemies(sim, 1.0f / sim->config.tick_rate);
+}
+
+// Re-walk the trie with the converted part of the input. Pending romaji is
+// left out so enemies stay highlighted while a kana is half typed.
+void update_prefix_match(GameSim *sim) {
+    int converted = sim->input.length - sim->input.pending;
+
+    sim->match_node = converted > 0
+        ? reading_trie_walk(sim->prefixes, sim->input.text, converted)
+        : -1;
+
+    if (sim->config.auto_fire && sim->match_node >= 0 && sim->input.pending == 0 &&
+        sim->prefixes->nodes[sim->match_node].ends > 0) {
+        check_input(sim);
+    }
+}
+
+int sim_enemy_matches(const GameSim *sim, int id) {
+    for (int k = 0; k < CARD_MAX_ANSWERS; k++) {
+        if (reading_trie_has_prefix(sim->prefixes, id * CARD_MAX_ANSWERS + k, sim->match_node)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void check_input(GameSim *sim) {
+    TRACE_SCOPE("check_input");
+    if (sim->game_over || sim->input.length == 0) return;
+
+    // A trailing "n" counts as ん once the answer is submitted
+    char answer[ROMAJI_TEXT_SIZE + MAX_ROMAJI_LENGTH];
+    int length = romaji_converter_finish(&sim->input, answer, sizeof(answer));
+    if (length < 0) return;
+    kana_fold(answer, length);
+
+    // Oldest live enemy with this reading, i.e. the lowest on screen
+    int entry = reading_index_find(sim->readings, answer, length,
+                                   reading_text_hash(answer, length));
+    if (entry < 0) return;
+    int id = entry / CARD_MAX_ANSWERS;
+
+    int card_index = sim->enemies->card_index[sim->enemies->slot[id]];
+    if (!collection_card_retired(sim->collection, card_index)) {
+        scheduler_release(sim->scheduler, card_index);
+    }
+    enemy_pool_kill(sim->enemies, id, sim->time_ms);
+    for (int k = 0; k < CARD_MAX_ANSWERS; k++) {
+        reading_index_remove(sim->readings, id * CARD_MAX_ANSWERS + k);
+        reading_trie_remove(sim->prefixes, id * CARD_MAX_ANSWERS + k);
+    }
+    sim->score += 100;
+
+    if (sim->on_result) {
+        sim->on_result(sim->user_data, card_index, 1, sim->time_ms - sim->spawn_time[id]);
+    }
+
+    romaji_converter_reset(&sim->input);
+    update_prefix_match(sim);
+}
+
+void sim_type(GameSim *sim, char ch) {
+    if (sim->game_over) return;
+
+    // Only the unconverted tail of the input is touched
+    romaji_converter_push(&sim->input, ch);
+    update_prefix_match(sim);
+}
+
+void sim_backspace(GameSim *sim) {
+    if (sim->game_over) return;
+
+    romaji_converter_backspace(&sim->input);
+    update_prefix_match(sim);
+}
+
+void sim_key(GameSim *sim, char key) {
+    if (key == SIM_KEY_BACKSPACE) sim_backspace(sim);
+    else if (key == SIM_KEY_SUBMIT) check_input(sim);
+    else if (romaji_is_key(key)) sim_type(sim, key);
+}
@@ -0,0 +1,97 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+#include "../collectionlib/include/collection.h"
+#include "../collectionlib/include/refresh.h"
+#include "hiragana.h"
+#include "enemies.h"
+#include "reading_index.h"
+#include "reading_trie.h"
+#include "scheduler.h"
+
+#define SIM_DEFAULT_TICK_RATE 120
+
+// Non-letter keys as seen by sim_key
+#define SIM_KEY_BACKSPACE '\b'
+#define SIM_KEY_SUBMIT '\n'
+
+typedef struct {
+    int tick_rate;              // simulation ticks per second
+    int width, height;          // playfield in pixels
+    int max_enemies;
+    float enemy_speed;          // pixels per second
+    uint32_t spawn_delay;       // ms between spawns
+    uint32_t meaning_duration;  // ms a killed enemy shows its meaning
+    int auto_fire;              // submit as soon as the input spells a whole reading
+    int scheduler;              // SCHEDULER_ strategy picking the cards to spawn
+    uint64_t seed;
+} SimConfig;
+
+// Everything the game does except drawing. It advances in fixed ticks from
+// its own seeded RNG and never reads the clock, so a seed plus the input
+// applied at each tick reproduces a session exactly, with or without SDL.
+typedef struct {
+    SimConfig config;
+    CardCollection *collection;
+
+    EnemyPool *enemies;
+    ReadingIndex *readings;     // live enemies' answers, keyed by id * CARD_MAX_ANSWERS + answer
+    ReadingTrie *prefixes;      // the same answers, for as-you-type matching
+    CardScheduler *scheduler;   // cards waiting to spawn, by review priority
+    uint32_t *spawn_time;       // per enemy id, for answer times
+    RomajiConverter input;
+    int match_node;             // trie node of the converted input, -1 if none
+
+    uint64_t rng;
+    uint64_t tick;
+    uint32_t time_ms;           // simulated time at the current tick
+    uint32_t last_spawn_time;
+    int score;
+    int game_over;
+
+    // Called for each spawned card, e.g. to warm its textures
+    void (*on_spawn)(void *user_data, int card_index);
+    // Called when a card is answered (hit) or reaches the bottom (miss);
+    // answer_ms is simulated time since it spawned
+    void (*on_result)(void *user_data, int card_index, int hit, uint32_t answer_ms);
+    void *user_data;
+} GameSim;
+
+void sim_default_config(SimConfig *config);
+
+GameSim* sim_create(const SimConfig *config, CardCollection *collection);
+void sim_destroy(GameSim *sim);
+
+// Let cards an async load published since sim_create (or the last call)
+// spawn, and switch to the review data once the load has finished. Cards
+// arriving mid-game make a session depend on load timing, so recorded and
+// replayed sessions start from a fully loaded collection instead.
+void sim_sync_collection(GameSim *sim);
+
+// Follow a collection_refresh: appended cards join the scheduler, retired
+// ones leave it, and rescheduled ones are rekeyed. Live enemies keep the
+// text they spawned with. Like cards arriving from a load, this makes a
+// session depend on what was edited, so it is not done while recording.
+void sim_apply_changes(GameSim *sim, const CollectionChanges *changes);
+
+// Advance one fixed tick: spawn, move, expire; nothing once the game is over
+void sim_step(GameSim *sim);
+
+// Input, applied between ticks. sim_key takes a romaji key (romaji_is_key)
+// or one of the SIM_KEY_ codes, so scripted and recorded input go through
+// one entry point.
+void sim_key(GameSim *sim, char key);
+void sim_type(GameSim *sim, char ch);
+void sim_backspace(GameSim *sim);
+void check_input(GameSim *sim);
+
+void spawn_enemy(GameSim *sim);
+void update_enemies(GameSim *sim, float delta_time);
+void update_prefix_match(GameSim *sim);
+
+// Whether one of enemy id's answers starts with the converted input
+int sim_enemy_matches(const GameSim *sim, int id);
+
+#endif
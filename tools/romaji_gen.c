@@ -0,0 +1,229 @@
+// Build-time generator for the romaji DFA used by src/hiragana.c
+//
+// Usage: romaji_gen > romaji_dfa.h
+// Builds a trie over the tables in src/romaji_table.h and prints it as
+// transition tables, with the kana for both hiragana and katakana output.
+// State 0 is the start state, so a 0 transition means "no match". Column 0
+// is for characters outside the alphabet and never leads anywhere. The
+// table is checked as it is built: an entry that shadows another, or kana
+// with no katakana form, fails the build.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/hiragana.h"
+#include "../src/romaji_table.h"
+
+#define ALPHABET "abcdefghijklmnopqrstuvwxyz-'"
+#define COLUMNS (int)sizeof(ALPHABET)   // the alphabet plus column 0
+#define MAX_STATES 1024
+#define MAX_KANA_PER_LETTER 3   // keeps the converter's text buffer bound valid
+#define MAX_KANA_BYTES 16
+
+static unsigned short next[MAX_STATES][COLUMNS];
+static const char *kana[MAX_STATES];
+static int rest[MAX_STATES];
+static const char *final_kana[MAX_STATES];
+static int state_count = 1;
+static int prefix_count;
+static int renumbered[MAX_STATES];  // prefixes first, entries after them
+static int original[MAX_STATES];
+
+static int column(char ch) {
+    const char *p = ch ? strchr(ALPHABET, ch) : NULL;
+    return p ? (int)(p - ALPHABET) + 1 : 0;
+}
+
+// Walk romaji from the start state, adding states if create is set.
+// Returns the state reached, or -1.
+static int walk(const char *romaji, int create) {
+    int state = 0;
+
+    for (const char *p = romaji; *p; p++) {
+        int c = column(*p);
+        if (!c) {
+            fprintf(stderr, "romaji_gen: \"%s\" is not in \"%s\"\n", romaji, ALPHABET);
+            return -1;
+        }
+        if (!next[state][c]) {
+            if (!create) return -1;
+            if (state_count == MAX_STATES) {
+                fprintf(stderr, "romaji_gen: more than %d states\n", MAX_STATES);
+                return -1;
+            }
+            next[state][c] = state_count++;
+        }
+        state = next[state][c];
+    }
+    return state;
+}
+
+// Hiragana U+3041-U+3096 sit 0x60 below their katakana, and with both in
+// the 3-byte UTF-8 range only the last two bytes change. Anything else
+// (the long vowel mark) is the same in both scripts.
+static int to_katakana(const char *hiragana, char *out) {
+    const unsigned char *p = (const unsigned char *)hiragana;
+    unsigned char *o = (unsigned char *)out;
+
+    while (*p) {
+        if (p[0] < 0xE0 || p[0] >= 0xF0 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+            fprintf(stderr, "romaji_gen: \"%s\" is not all 3-byte UTF-8\n", hiragana);
+            return -1;
+        }
+        unsigned code = ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        if (code >= 0x3041 && code <= 0x3096) code += 0x60;
+        o[0] = 0xE0 | (code >> 12);
+        o[1] = 0x80 | ((code >> 6) & 0x3F);
+        o[2] = 0x80 | (code & 0x3F);
+        p += 3;
+        o += 3;
+    }
+    *o = '\0';
+    return 0;
+}
+
+static int add_entry(const char *romaji, const char *hiragana, int rest_letters) {
+    size_t len = strlen(romaji);
+
+    // Kana plus the letters left pending must fit the bound per letter typed
+    if (len == 0 || len >= MAX_ROMAJI_LENGTH || rest_letters < 0 || (size_t)rest_letters >= len ||
+        strlen(hiragana) + rest_letters > len * MAX_KANA_PER_LETTER ||
+        strlen(hiragana) >= MAX_KANA_BYTES) {
+        fprintf(stderr, "romaji_gen: bad entry \"%s\"\n", romaji);
+        return -1;
+    }
+
+    char katakana[MAX_KANA_BYTES];
+    int state = walk(romaji, 1);
+    if (state < 0 || to_katakana(hiragana, katakana) < 0) return -1;
+    if (kana[state]) {
+        fprintf(stderr, "romaji_gen: duplicate entry \"%s\"\n", romaji);
+        return -1;
+    }
+    kana[state] = hiragana;
+    rest[state] = rest_letters;
+    return 0;
+}
+
+// The converter emits on reaching an entry, so an entry must end the walk
+static int check_prefixes(void) {
+    for (int s = 1; s < state_count; s++) {
+        if (!kana[s]) continue;
+        for (int c = 1; c < COLUMNS; c++) {
+            if (next[s][c]) {
+                fprintf(stderr, "romaji_gen: an entry for \"%s\" is a prefix of another\n",
+                        kana[s]);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Only prefixes have transitions, so numbering them first lets the
+// transition table stop at the last prefix
+static void renumber(void) {
+    for (int s = 0; s < state_count; s++) {
+        if (!kana[s]) renumbered[s] = prefix_count++;
+    }
+    int entry = prefix_count;
+    for (int s = 0; s < state_count; s++) {
+        if (kana[s]) renumbered[s] = entry++;
+    }
+    for (int s = 0; s < state_count; s++) original[renumbered[s]] = s;
+}
+
+// Every kana converted cleanly when its entry was added
+static void print_kana(const char *name, const char *const *table, int count,
+                       const char *size, int katakana) {
+    printf("static const char *const %s[%s] = {\n", name, size);
+    for (int s = 0; s < count; s++) {
+        char converted[MAX_KANA_BYTES];
+        const char *text = table[original[s]];
+        if (text && katakana) {
+            to_katakana(text, converted);
+            text = converted;
+        }
+        if (text) printf("    \"%s\",\n", text);
+        else printf("    NULL,\n");
+    }
+    printf("};\n\n");
+}
+
+int main(void) {
+    for (int i = 0; romaji_table[i].romaji != NULL; i++) {
+        if (add_entry(romaji_table[i].romaji, romaji_table[i].hiragana, 0) < 0) return 1;
+    }
+    for (int i = 0; romaji_split_table[i].romaji != NULL; i++) {
+        const RomajiSplit *split = &romaji_split_table[i];
+        if (add_entry(split->romaji, split->hiragana, split->rest) < 0) return 1;
+    }
+    if (check_prefixes() < 0) return 1;
+
+    // Final kana belong to prefixes, never to entries
+    for (int i = 0; romaji_final_table[i].romaji != NULL; i++) {
+        char katakana[MAX_KANA_BYTES];
+        int state = walk(romaji_final_table[i].romaji, 0);
+        if (state <= 0 || kana[state] ||
+            to_katakana(romaji_final_table[i].hiragana, katakana) < 0) {
+            fprintf(stderr, "romaji_gen: final \"%s\" is not a prefix of an entry\n",
+                    romaji_final_table[i].romaji);
+            return 1;
+        }
+        final_kana[state] = romaji_final_table[i].hiragana;
+    }
+    renumber();
+
+    printf("// Generated by tools/romaji_gen from src/romaji_table.h. Do not edit.\n\n");
+    printf("#ifndef ROMAJI_DFA_H\n#define ROMAJI_DFA_H\n\n");
+    printf("#define ROMAJI_ALPHABET \"%s\"\n", ALPHABET);
+    printf("#define ROMAJI_COLUMNS %d\n", COLUMNS);
+    printf("#define ROMAJI_STATE_COUNT %d\n", state_count);
+    printf("#define ROMAJI_PREFIX_COUNT %d\n\n", prefix_count);
+
+    // Column of every byte; 0 for those outside the alphabet
+    printf("static const unsigned char romaji_column[256] = {");
+    for (int ch = 0; ch < 256; ch++) {
+        printf("%s%d", ch % 32 ? "," : ch ? ",\n    " : "\n    ", ch < 128 ? column((char)ch) : 0);
+    }
+    printf("\n};\n\n");
+
+    // Transitions of the prefixes; entries have none
+    printf("static const unsigned short romaji_next[ROMAJI_PREFIX_COUNT][ROMAJI_COLUMNS] = {\n");
+    for (int s = 0; s < prefix_count; s++) {
+        printf("    {");
+        for (int c = 0; c < COLUMNS; c++) {
+            int to = next[original[s]][c];
+            printf("%s%d", c ? "," : "", to ? renumbered[to] : 0);
+        }
+        printf("},\n");
+    }
+    printf("};\n\n");
+
+    // Kana emitted on entering a state, per KanaMode; NULL while the romaji
+    // is still a prefix
+    print_kana("romaji_hiragana", kana, state_count, "ROMAJI_STATE_COUNT", 0);
+    print_kana("romaji_katakana", kana, state_count, "ROMAJI_STATE_COUNT", 1);
+    printf("static const char *const *const romaji_kana[2] = {romaji_hiragana, romaji_katakana};\n\n");
+
+    printf("static const unsigned char romaji_kana_len[ROMAJI_STATE_COUNT] = {\n");
+    for (int s = 0; s < state_count; s++) {
+        const char *text = kana[original[s]];
+        printf("    %d,\n", text ? (int)strlen(text) : 0);
+    }
+    printf("};\n\n");
+
+    // Letters of the entry that stay pending after its kana
+    printf("static const unsigned char romaji_rest[ROMAJI_STATE_COUNT] = {\n");
+    for (int s = 0; s < state_count; s++) printf("    %d,\n", rest[original[s]]);
+    printf("};\n\n");
+
+    // Kana for a prefix the input ends on, per KanaMode
+    print_kana("romaji_final_hiragana", final_kana, prefix_count, "ROMAJI_PREFIX_COUNT", 0);
+    print_kana("romaji_final_katakana", final_kana, prefix_count, "ROMAJI_PREFIX_COUNT", 1);
+    printf("static const char *const *const romaji_final_kana[2] = "
+           "{romaji_final_hiragana, romaji_final_katakana};\n\n");
+
+    printf("#endif\n");
+    return 0;
+}